@@ -30,33 +30,39 @@
  *
  *  Device name is selectable.
  *
- *  Proposed operation:
+ *  Operation:
  *
  *  	Initialisation:
- *			period size is set to minimum.
+ *			period size is set as requested (or to minimum).
  *			buffer size is set to 2 periods.
- *			two application side buffers are created, sized for one period, and set to silence.
+ *			a ring of N application side buffers is created, each sized for one period.
  *			one application side "silence" buffer is created.
- *			next audible buffer index set to zero.
- *			app buffer 0 set to empty.
- *			app buffer 1 set to empty.
- *			silence buffer is written to PCM twice.
- *			async handler is set up.
- *			PCM is started.
+ *			read and write counts set to zero; free buffer semaphore set to N.
+ *			audio thread is started.
  *
- *		Loop:
- *			Find next empty buffer
- *				write sample data to it and set to full.
- *			When no empty buffers left
- *				Sleep on empty buffer signal.
+ *		Loop (render thread, single producer):
+ *			Wait on free buffer semaphore.
+ *			Write sample data to the buffer at the write count, then publish it by incrementing the write count.
  *
- *		Handler:
- *			If next audible buffer is empty, write silence.
+ *		Audio thread (single consumer):
+ *			If the ring is empty, write silence and count an underrun.
  *			Else
- *				Writes next audible app buffer to PCM.
- *				Set next audible buffer to empty.
- *				Increments next audible buffer index, modulo 2.
- *			Send empty buffer signal.
+ *				Writes the buffer at the read count to PCM.
+ *				Releases it by incrementing the read count, and posts the free buffer semaphore.
+ *
+ *	The read and write counts are only ever written by one side each, so they are handed over with
+ *	atomic acquire/release operations rather than a mutex; the audio thread never blocks on the render thread.
+ *
+ *	MMAP mode (zero copy):
+ *
+ *		Initialisation:
+ *			buffer size is set to N periods (at least 2) - the DMA ring is the buffer ring.
+ *			no application side buffers or audio thread are created.
+ *
+ *		Loop (render thread):
+ *			Wait until a period of the DMA ring is free, recovering from any xrun.
+ *			Map the free period with snd_pcm_mmap_begin and render straight into it.
+ *			Commit it with snd_pcm_mmap_commit; the device starts once the first period is committed.
  */
 
 #define _GNU_SOURCE
@@ -69,8 +75,9 @@
 
 #include "alsa.h"
 
-#define AUDIO_BUFFER_COUNT	2
-#define PERIOD_COUNT		AUDIO_BUFFER_COUNT
+#define AUDIO_BUFFER_COUNT_MIN	2
+#define AUDIO_BUFFER_COUNT_MAX	16
+#define PERIOD_COUNT			2
 
 snd_pcm_t* 				playback_handle;
 snd_pcm_uframes_t		period_size_frames;
@@ -79,15 +86,24 @@ int						period_dir;
 snd_pcm_uframes_t		buffer_size_frames;
 int						sample_bit_count;
 snd_async_handler_t*	async_handler;
+snd_pcm_access_t		sample_access;
 
-int				next_audible_buffer = 0;
+int				audio_buffer_count = 0;
 int				periods_output = 0;
 int				xruns_count = 0;
-void*			audio_buffer[AUDIO_BUFFER_COUNT] = { NULL, NULL };
-pthread_mutex_t	audio_lock[AUDIO_BUFFER_COUNT] = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER };
+int				underruns_count = 0;
+void*			audio_buffer[AUDIO_BUFFER_COUNT_MAX];
+void*			silence_buffer = NULL;
+unsigned int	write_count = 0;
+unsigned int	read_count = 0;
+int				audio_thread_exiting = 0;
 
 pthread_t	audio_thread_handle;
-sem_t		audio_output_semaphore;
+sem_t		audio_free_semaphore;
+
+const snd_pcm_channel_area_t*	mmap_areas = NULL;
+snd_pcm_uframes_t				mmap_offset = 0;
+snd_pcm_uframes_t				mmap_frames = 0;
 
 static void alsa_error(const char* message, int error_code)
 {
@@ -107,13 +123,42 @@ static void create_audio_buffers()
 	int frame_size = (sample_bit_count / 8) * CHANNEL_COUNT;
 	int audio_buffer_size = frame_size * period_size_frames;
 
-	for (int i = 0; i < AUDIO_BUFFER_COUNT; i++)
+	for (int i = 0; i < audio_buffer_count; i++)
 	{
 		audio_buffer[i] = malloc(audio_buffer_size);
 		snd_pcm_format_set_silence(SAMPLE_FORMAT, audio_buffer[i], period_size_frames * CHANNEL_COUNT);
 	}
 
-	next_audible_buffer = 0;
+	silence_buffer = malloc(audio_buffer_size);
+	snd_pcm_format_set_silence(SAMPLE_FORMAT, silence_buffer, period_size_frames * CHANNEL_COUNT);
+
+	read_count = 0;
+	write_count = 0;
+}
+
+static int write_period(void* buffer)
+{
+	int error;
+
+	while ((error = snd_pcm_writei(playback_handle, buffer, period_size_frames)) == -EPIPE)
+	{
+		xruns_count++;
+		snd_pcm_prepare(playback_handle);
+	}
+
+	return error;
+}
+
+// Recovers from an underrun (or suspend) in MMAP mode, counting it as an xrun.
+static int recover_mmap(int error)
+{
+	if (error == -EPIPE || error == -ESTRPIPE)
+	{
+		xruns_count++;
+		error = snd_pcm_recover(playback_handle, error, 1);
+	}
+
+	return error;
 }
 
 static void* audio_thread()
@@ -122,27 +167,34 @@ static void* audio_thread()
 
 	pthread_setname_np(audio_thread_handle, "pithesiser-aud");
 
-	while (error >= 0)
+	while (error >= 0 && !__atomic_load_n(&audio_thread_exiting, __ATOMIC_ACQUIRE))
 	{
-		//printf("audio write %d...", next_audible_buffer);
-		pthread_mutex_lock(&audio_lock[next_audible_buffer]);
-		while ((error = snd_pcm_writei(playback_handle, audio_buffer[next_audible_buffer], period_size_frames)) == -EPIPE)
+		unsigned int available_count = __atomic_load_n(&write_count, __ATOMIC_ACQUIRE);
+
+		if (available_count != read_count)
+		{
+			error = write_period(audio_buffer[read_count % audio_buffer_count]);
+			__atomic_store_n(&read_count, read_count + 1, __ATOMIC_RELEASE);
+			sem_post(&audio_free_semaphore);
+		}
+		else
 		{
-			xruns_count++;
-			snd_pcm_prepare(playback_handle);
-			//printf("xrun...");
+			// Nothing rendered in time - keep the device fed with silence. Before the first
+			// buffer is written this is just start up, so it isn't counted.
+			error = write_period(silence_buffer);
+			if (available_count > 0)
+			{
+				underruns_count++;
+			}
 		}
-		//printf("written.\n");
-		pthread_mutex_unlock(&audio_lock[next_audible_buffer]);
-		next_audible_buffer = (next_audible_buffer + 1) % AUDIO_BUFFER_COUNT;
+
 		periods_output++;
-		sem_post(&audio_output_semaphore);
 	}
 
 	return NULL;
 }
 
-int alsa_initialise(const char* device_name, int period_size)
+int alsa_initialise(const char* device_name, int period_size, int buffer_count, int access_mode)
 {
 	int error;
 	snd_pcm_hw_params_t* hw_params;
@@ -151,7 +203,27 @@ int alsa_initialise(const char* device_name, int period_size)
     snd_pcm_hw_params_alloca(&hw_params);
     snd_pcm_sw_params_alloca(&sw_params);
 
-    sem_init(&audio_output_semaphore, 0, 0);
+    // One buffer plays while the next is rendered: with only one, RW output would alternate the signal with silence,
+    // and the DMA ring in mmap mode needs at least two periods.
+    if (buffer_count < AUDIO_BUFFER_COUNT_MIN || buffer_count > AUDIO_BUFFER_COUNT_MAX)
+    {
+    	fprintf(stderr, "alsa_initialise: invalid buffer count %d - should be between %d and %d\n", buffer_count, AUDIO_BUFFER_COUNT_MIN, AUDIO_BUFFER_COUNT_MAX);
+    	return -1;
+    }
+
+    if (access_mode == ALSA_ACCESS_MMAP)
+    {
+    	sample_access = SND_PCM_ACCESS_MMAP_INTERLEAVED;
+    	period_count = buffer_count;
+    	audio_buffer_count = period_count;
+    }
+    else
+    {
+    	sample_access = SND_PCM_ACCESS_RW_INTERLEAVED;
+    	period_count = PERIOD_COUNT;
+    	audio_buffer_count = buffer_count;
+    	sem_init(&audio_free_semaphore, 0, audio_buffer_count);
+    }
 
     if ((error = snd_pcm_open (&playback_handle, device_name, SND_PCM_STREAM_PLAYBACK, 0)) < 0)
     {
@@ -164,7 +236,7 @@ int alsa_initialise(const char* device_name, int period_size)
 		return -1;
 	}
 
-	if ((error = snd_pcm_hw_params_set_access(playback_handle, hw_params, SAMPLE_ACCESS)) < 0) {
+	if ((error = snd_pcm_hw_params_set_access(playback_handle, hw_params, sample_access)) < 0) {
 		alsa_error("cannot set access type (%s)\n", error);
 		return -1;
 	}
@@ -189,26 +261,14 @@ int alsa_initialise(const char* device_name, int period_size)
 		return -1;
 	}
 
-	if (period_size == PERIOD_SIZE_MIN)
+	period_size_frames = period_size;
+	if ((error = snd_pcm_hw_params_set_period_size_near(playback_handle, hw_params, &period_size_frames, &dir)) < 0)
 	{
-		if ((error = snd_pcm_hw_params_set_period_size_first(playback_handle, hw_params, &period_size_frames, &dir)) < 0)
-		{
-			alsa_error("cannot set & get min period size (%s)\n", error);
-			return -1;
-		}
-	}
-	else
-	{
-		period_size_frames = period_size;
-		if ((error = snd_pcm_hw_params_set_period_size_near(playback_handle, hw_params, &period_size_frames, &dir)) < 0)
-		{
-			alsa_error("cannot set & get desired period size (%s)\n", error);
-			return -1;
-		}
+		alsa_error("cannot set & get desired period size (%s)\n", error);
+		return -1;
 	}
 
-	period_count = PERIOD_COUNT;
-	buffer_size_frames = period_size_frames * PERIOD_COUNT;
+	buffer_size_frames = period_size_frames * period_count;
 	if ((error = snd_pcm_hw_params_set_buffer_size(playback_handle, hw_params, buffer_size_frames)) < 0)
 	{
 		alsa_error("cannot set buffer size periods (%s)\n", error);
@@ -247,7 +307,10 @@ int alsa_initialise(const char* device_name, int period_size)
 		return -1;
 	}
 
-	create_audio_buffers();
+	if (sample_access == SND_PCM_ACCESS_RW_INTERLEAVED)
+	{
+		create_audio_buffers();
+	}
 
 	if ((error = snd_pcm_prepare(playback_handle)) < 0)
 	{
@@ -255,17 +318,30 @@ int alsa_initialise(const char* device_name, int period_size)
 		return -1;
 	}
 
-	pthread_create(&audio_thread_handle, NULL, audio_thread, NULL);
+	if (sample_access == SND_PCM_ACCESS_RW_INTERLEAVED)
+	{
+		pthread_create(&audio_thread_handle, NULL, audio_thread, NULL);
+	}
+
 	return 0;
 }
 
 void alsa_deinitialise()
 {
+	if (sample_access == SND_PCM_ACCESS_MMAP_INTERLEAVED)
+	{
+		snd_pcm_drain(playback_handle);
+		snd_pcm_close(playback_handle);
+		return;
+	}
+
+	__atomic_store_n(&audio_thread_exiting, 1, __ATOMIC_RELEASE);
+	pthread_join(audio_thread_handle, NULL);
 	snd_pcm_drain(playback_handle);
 	snd_pcm_close(playback_handle);
-	pthread_join(audio_thread_handle, NULL);
+	sem_destroy(&audio_free_semaphore);
 
-	for (int i = 0; i < AUDIO_BUFFER_COUNT; i++)
+	for (int i = 0; i < audio_buffer_count; i++)
 	{
 		if (audio_buffer[i] != NULL)
 		{
@@ -273,11 +349,56 @@ void alsa_deinitialise()
 			audio_buffer[i] = NULL;
 		}
 	}
+
+	free(silence_buffer);
+	silence_buffer = NULL;
+}
+
+static void sync_with_mmap_output()
+{
+	for (;;)
+	{
+		snd_pcm_sframes_t avail = snd_pcm_avail_update(playback_handle);
+
+		if (avail < 0)
+		{
+			if (recover_mmap(avail) < 0)
+			{
+				alsa_error("mmap avail update failed (%s)\n", avail);
+				return;
+			}
+		}
+		else if (avail >= (snd_pcm_sframes_t)period_size_frames)
+		{
+			return;
+		}
+		else if (snd_pcm_state(playback_handle) == SND_PCM_STATE_PREPARED)
+		{
+			// The ring is full but the start threshold wasn't reached - nothing will drain it until started.
+			snd_pcm_start(playback_handle);
+		}
+		else
+		{
+			int error = snd_pcm_wait(playback_handle, -1);
+			if (error < 0 && recover_mmap(error) < 0)
+			{
+				alsa_error("mmap wait failed (%s)\n", error);
+				return;
+			}
+		}
+	}
 }
 
 void alsa_sync_with_audio_output()
 {
-	sem_wait(&audio_output_semaphore);
+	if (sample_access == SND_PCM_ACCESS_MMAP_INTERLEAVED)
+	{
+		sync_with_mmap_output();
+	}
+	else
+	{
+		sem_wait(&audio_free_semaphore);
+	}
 }
 
 int alsa_get_samples_output()
@@ -290,20 +411,92 @@ int alsa_get_xruns_count()
 	return xruns_count;
 }
 
+int alsa_get_underruns_count()
+{
+	return underruns_count;
+}
+
+int alsa_get_buffer_fill_level()
+{
+	if (sample_access == SND_PCM_ACCESS_MMAP_INTERLEAVED)
+	{
+		snd_pcm_sframes_t avail = snd_pcm_avail_update(playback_handle);
+		return avail < 0 ? 0 : (buffer_size_frames - avail) / period_size_frames;
+	}
+
+	return __atomic_load_n(&write_count, __ATOMIC_ACQUIRE) - __atomic_load_n(&read_count, __ATOMIC_ACQUIRE);
+}
+
+int alsa_get_buffer_count()
+{
+	return audio_buffer_count;
+}
+
+// A free buffer must have been waited for with alsa_sync_with_audio_output first.
+// In MMAP mode this maps the next free period of the DMA ring, which must be committed with
+// alsa_unlock_buffer before the next sync.
 int alsa_lock_next_write_buffer()
 {
-	int buffer_index = (next_audible_buffer + 1) % AUDIO_BUFFER_COUNT;
-	pthread_mutex_lock(&audio_lock[buffer_index]);
-	return buffer_index;
+	if (sample_access == SND_PCM_ACCESS_MMAP_INTERLEAVED)
+	{
+		int error;
+
+		mmap_frames = period_size_frames;
+		while ((error = snd_pcm_mmap_begin(playback_handle, &mmap_areas, &mmap_offset, &mmap_frames)) < 0)
+		{
+			if (recover_mmap(error) < 0)
+			{
+				alsa_error("mmap begin failed (%s)\n", error);
+				mmap_areas = NULL;
+				mmap_frames = 0;
+				break;
+			}
+			mmap_frames = period_size_frames;
+		}
+	}
+
+	return write_count % audio_buffer_count;
 }
 
 void alsa_unlock_buffer(int buffer_index)
 {
-	pthread_mutex_unlock(&audio_lock[buffer_index]);
+	if (sample_access == SND_PCM_ACCESS_MMAP_INTERLEAVED)
+	{
+		if (mmap_frames > 0)
+		{
+			snd_pcm_sframes_t committed = snd_pcm_mmap_commit(playback_handle, mmap_offset, mmap_frames);
+			if (committed < 0 || (snd_pcm_uframes_t)committed != mmap_frames)
+			{
+				recover_mmap(committed < 0 ? committed : -EPIPE);
+			}
+			periods_output++;
+		}
+
+		write_count++;
+		mmap_frames = 0;
+		return;
+	}
+
+	__atomic_store_n(&write_count, write_count + 1, __ATOMIC_RELEASE);
 }
 
 void alsa_get_buffer_params(int buffer_index, void** data, int* sample_count)
 {
+	if (sample_access == SND_PCM_ACCESS_MMAP_INTERLEAVED)
+	{
+		// Interleaved, so every channel shares the first area.
+		if (mmap_areas != NULL)
+		{
+			*data = (char*)mmap_areas[0].addr + (mmap_areas[0].first + mmap_offset * mmap_areas[0].step) / 8;
+		}
+		else
+		{
+			*data = NULL;
+		}
+		*sample_count = mmap_frames;
+		return;
+	}
+
 	*data = audio_buffer[buffer_index];
 	*sample_count = period_size_frames;
 }
@@ -27,15 +27,22 @@
 #define SAMPLE_RATE		44100
 #define CHANNEL_COUNT	2
 #define SAMPLE_FORMAT	SND_PCM_FORMAT_S16_LE
-#define SAMPLE_ACCESS	SND_PCM_ACCESS_RW_INTERLEAVED
 
-#define PERIOD_SIZE_MIN	-1
+#define AUDIO_BUFFER_COUNT	2
 
-extern int alsa_initialise(const char* device_name, int period_size);
+// Output modes: RW copies rendered periods to the device from an audio thread,
+// MMAP renders straight into the device's DMA ring.
+#define ALSA_ACCESS_RW		0
+#define ALSA_ACCESS_MMAP	1
+
+extern int alsa_initialise(const char* device_name, int period_size, int buffer_count, int access_mode);
 extern void alsa_deinitialise();
 
 extern int alsa_get_samples_output();
 extern int alsa_get_xruns_count();
+extern int alsa_get_underruns_count();
+extern int alsa_get_buffer_fill_level();
+extern int alsa_get_buffer_count();
 extern void alsa_get_buffer_params(int buffer_index, void** data, int* sample_count);
 extern void alsa_sync_with_audio_output();
 extern int alsa_lock_next_write_buffer();
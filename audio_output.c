@@ -0,0 +1,196 @@
+// Pithesiser - a software synthesiser for Raspberry Pi
+// Copyright (C) 2015 Nicholas Tuckett
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * audio_output.c
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: ntuckett
+ */
+
+#include "audio_output.h"
+#include <stdlib.h>
+#include <string.h>
+#include "audio_output_internal.h"
+#include "system_constants.h"
+#include "logging.h"
+
+static const char* CFG_DEVICES_AUDIO = "devices.audio";
+static const char* CFG_DRIVER = "driver";
+static const char* CFG_PERIOD_SIZE = "period_size";
+static const char* CFG_BUFFER_COUNT = "buffer_count";
+
+#define DEFAULT_PERIOD_SIZE		128
+#define DEFAULT_BUFFER_COUNT	2
+#define NANOSECONDS_PER_SECOND	1000000000L
+
+static audio_output_driver_t* drivers[] =
+{
+	&audio_output_alsa_driver,
+	&audio_output_null_driver,
+	&audio_output_file_driver,
+	NULL
+};
+
+static audio_output_driver_t* driver = NULL;
+
+int audio_output_initialise(config_t* config)
+{
+	config_setting_t* setting_audio = config_lookup(config, CFG_DEVICES_AUDIO);
+	if (setting_audio == NULL)
+	{
+		LOG_ERROR("Missing audio device settings in config");
+		return RESULT_ERROR;
+	}
+
+	const char* driver_name = audio_output_alsa_driver.name;
+	config_setting_lookup_string(setting_audio, CFG_DRIVER, &driver_name);
+
+	for (int i = 0; drivers[i] != NULL; i++)
+	{
+		if (strcmp(drivers[i]->name, driver_name) == 0)
+		{
+			driver = drivers[i];
+			break;
+		}
+	}
+
+	if (driver == NULL)
+	{
+		LOG_ERROR("Unknown audio output driver %s", driver_name);
+		return RESULT_ERROR;
+	}
+
+	int period_size = DEFAULT_PERIOD_SIZE;
+	config_setting_lookup_int(setting_audio, CFG_PERIOD_SIZE, &period_size);
+
+	// The mixers work on sample pairs, so periods need an even number of samples.
+	if (period_size < 2 || (period_size & 1) != 0)
+	{
+		LOG_ERROR("Invalid audio period size %d - should be an even number of samples", period_size);
+		return RESULT_ERROR;
+	}
+
+	int buffer_count = DEFAULT_BUFFER_COUNT;
+	config_setting_lookup_int(setting_audio, CFG_BUFFER_COUNT, &buffer_count);
+
+	if (driver->initialise(setting_audio, period_size, buffer_count) != RESULT_OK)
+	{
+		driver = NULL;
+		return RESULT_ERROR;
+	}
+
+	LOG_INFO("Audio output: %s driver, %d sample periods", driver->name, period_size);
+	return RESULT_OK;
+}
+
+void audio_output_deinitialise()
+{
+	if (driver != NULL)
+	{
+		driver->deinitialise();
+		driver = NULL;
+	}
+}
+
+const char* audio_output_get_driver_name()
+{
+	return driver != NULL ? driver->name : NULL;
+}
+
+void audio_output_sync_with_output()
+{
+	driver->sync_with_output();
+}
+
+int audio_output_lock_next_write_buffer()
+{
+	return driver->lock_next_write_buffer();
+}
+
+void audio_output_get_buffer_params(int buffer_index, void** data, int* sample_count)
+{
+	driver->get_buffer_params(buffer_index, data, sample_count);
+}
+
+void audio_output_unlock_buffer(int buffer_index)
+{
+	driver->unlock_buffer(buffer_index);
+}
+
+int audio_output_get_samples_output()
+{
+	return driver != NULL ? driver->get_samples_output() : 0;
+}
+
+int audio_output_get_xruns_count()
+{
+	return driver != NULL ? driver->get_xruns_count() : 0;
+}
+
+int audio_output_get_underruns_count()
+{
+	return driver != NULL ? driver->get_underruns_count() : 0;
+}
+
+//-----------------------------------------------------------------------------------------------------------------------
+// Real time pacing for drivers without a device clock
+//
+
+void audio_output_clock_initialise(audio_output_clock_t* clock, int period_size)
+{
+	clock->period_ns = ((int64_t)period_size * NANOSECONDS_PER_SECOND) / SYSTEM_SAMPLE_RATE;
+	clock->started = 0;
+}
+
+// Sleeps until the next period is due. Returns 1 if the render loop fell more than a period behind,
+// in which case the clock restarts from now rather than trying to catch up.
+int audio_output_clock_wait(audio_output_clock_t* clock)
+{
+	struct timespec now;
+	int late = 0;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	if (!clock->started)
+	{
+		clock->next_tick = now;
+		clock->started = 1;
+	}
+	else
+	{
+		int64_t behind_ns = (int64_t)(now.tv_sec - clock->next_tick.tv_sec) * NANOSECONDS_PER_SECOND
+							+ (now.tv_nsec - clock->next_tick.tv_nsec);
+		if (behind_ns > clock->period_ns)
+		{
+			clock->next_tick = now;
+			late = 1;
+		}
+		else
+		{
+			clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &clock->next_tick, NULL);
+		}
+	}
+
+	clock->next_tick.tv_nsec += clock->period_ns;
+	while (clock->next_tick.tv_nsec >= NANOSECONDS_PER_SECOND)
+	{
+		clock->next_tick.tv_nsec -= NANOSECONDS_PER_SECOND;
+		clock->next_tick.tv_sec++;
+	}
+
+	return late;
+}
@@ -0,0 +1,58 @@
+// Pithesiser - a software synthesiser for Raspberry Pi
+// Copyright (C) 2015 Nicholas Tuckett
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * audio_output.h
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: ntuckett
+ *
+ *  Audio output driver interface. The render loop syncs with the driver, locks the next buffer,
+ *  renders into it and unlocks it; the selected driver decides where the samples go.
+ */
+
+#ifndef AUDIO_OUTPUT_H_
+#define AUDIO_OUTPUT_H_
+
+#include <libconfig.h>
+
+typedef struct audio_output_driver_t
+{
+	const char* name;
+	int (*initialise)(config_setting_t* setting, int period_size, int buffer_count);
+	void (*deinitialise)();
+	void (*sync_with_output)();
+	int (*lock_next_write_buffer)();
+	void (*get_buffer_params)(int buffer_index, void** data, int* sample_count);
+	void (*unlock_buffer)(int buffer_index);
+	int (*get_samples_output)();
+	int (*get_xruns_count)();
+	int (*get_underruns_count)();
+} audio_output_driver_t;
+
+extern int audio_output_initialise(config_t* config);
+extern void audio_output_deinitialise();
+
+extern const char* audio_output_get_driver_name();
+extern void audio_output_sync_with_output();
+extern int audio_output_lock_next_write_buffer();
+extern void audio_output_get_buffer_params(int buffer_index, void** data, int* sample_count);
+extern void audio_output_unlock_buffer(int buffer_index);
+extern int audio_output_get_samples_output();
+extern int audio_output_get_xruns_count();
+extern int audio_output_get_underruns_count();
+
+#endif /* AUDIO_OUTPUT_H_ */
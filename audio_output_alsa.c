@@ -0,0 +1,67 @@
+// Pithesiser - a software synthesiser for Raspberry Pi
+// Copyright (C) 2015 Nicholas Tuckett
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * audio_output_alsa.c
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: ntuckett
+ *
+ *  Audio output driver for ALSA devices, see alsa.c.
+ */
+
+#include "audio_output_internal.h"
+#include "alsa.h"
+#include "system_constants.h"
+#include "logging.h"
+
+static const char* CFG_OUTPUT = "output";
+static const char* CFG_MMAP = "mmap";
+
+static int alsa_driver_initialise(config_setting_t* setting, int period_size, int buffer_count)
+{
+	const char *output_device = NULL;
+
+	if (config_setting_lookup_string(setting, CFG_OUTPUT, &output_device) != CONFIG_TRUE)
+	{
+		LOG_ERROR("Missing audio output device in config");
+		return RESULT_ERROR;
+	}
+
+	int use_mmap = 0;
+	config_setting_lookup_bool(setting, CFG_MMAP, &use_mmap);
+
+	if (alsa_initialise(output_device, period_size, buffer_count, use_mmap ? ALSA_ACCESS_MMAP : ALSA_ACCESS_RW) < 0)
+	{
+		return RESULT_ERROR;
+	}
+
+	return RESULT_OK;
+}
+
+audio_output_driver_t audio_output_alsa_driver =
+{
+	.name = "alsa",
+	.initialise = alsa_driver_initialise,
+	.deinitialise = alsa_deinitialise,
+	.sync_with_output = alsa_sync_with_audio_output,
+	.lock_next_write_buffer = alsa_lock_next_write_buffer,
+	.get_buffer_params = alsa_get_buffer_params,
+	.unlock_buffer = alsa_unlock_buffer,
+	.get_samples_output = alsa_get_samples_output,
+	.get_xruns_count = alsa_get_xruns_count,
+	.get_underruns_count = alsa_get_underruns_count
+};
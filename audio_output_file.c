@@ -0,0 +1,171 @@
+// Pithesiser - a software synthesiser for Raspberry Pi
+// Copyright (C) 2015 Nicholas Tuckett
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * audio_output_file.c
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: ntuckett
+ *
+ *  Audio output driver that writes 16-bit stereo to a WAV or headerless raw file.
+ *  Paced by the monotonic clock by default so the synth runs as it would on a device;
+ *  with realtime = false it runs flat out, which is useful for load tests.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sndfile.h>
+#include "audio_output_internal.h"
+#include "system_constants.h"
+#include "logging.h"
+
+static const char* CFG_FILE = "file";
+static const char* CFG_PATH = "path";
+static const char* CFG_FORMAT = "format";
+static const char* CFG_REALTIME = "realtime";
+
+static SNDFILE* sndfile = NULL;
+static sample_t* period_buffer = NULL;
+static int period_samples = 0;
+static int periods_output = 0;
+static int underruns_count = 0;
+static int realtime = 1;
+static audio_output_clock_t output_clock;
+
+static int file_driver_initialise(config_setting_t* setting, int period_size, int buffer_count)
+{
+	config_setting_t* setting_file = config_setting_get_member(setting, CFG_FILE);
+	const char* path = NULL;
+	const char* format = "wav";
+
+	if (setting_file == NULL || config_setting_lookup_string(setting_file, CFG_PATH, &path) != CONFIG_TRUE)
+	{
+		LOG_ERROR("File audio output: no output path specified");
+		return RESULT_ERROR;
+	}
+
+	config_setting_lookup_string(setting_file, CFG_FORMAT, &format);
+	realtime = 1;
+	config_setting_lookup_bool(setting_file, CFG_REALTIME, &realtime);
+
+	SF_INFO sndinfo;
+	memset(&sndinfo, 0, sizeof(sndinfo));
+	sndinfo.samplerate = SYSTEM_SAMPLE_RATE;
+	sndinfo.channels = CHANNELS_PER_SAMPLE;
+
+	if (strcmp(format, "wav") == 0)
+	{
+		sndinfo.format = SF_FORMAT_WAV | SF_FORMAT_PCM_16;
+	}
+	else if (strcmp(format, "raw") == 0)
+	{
+		sndinfo.format = SF_FORMAT_RAW | SF_FORMAT_PCM_16 | SF_ENDIAN_LITTLE;
+	}
+	else
+	{
+		LOG_ERROR("File audio output: unknown format %s - should be wav or raw", format);
+		return RESULT_ERROR;
+	}
+
+	sndfile = sf_open(path, SFM_WRITE, &sndinfo);
+	if (sndfile == NULL)
+	{
+		LOG_ERROR("File audio output: cannot open %s: %s", path, sf_strerror(NULL));
+		return RESULT_ERROR;
+	}
+
+	period_samples = period_size;
+	period_buffer = calloc(period_samples, BYTES_PER_SAMPLE);
+	if (period_buffer == NULL)
+	{
+		LOG_ERROR("File audio output: cannot allocate period buffer");
+		sf_close(sndfile);
+		sndfile = NULL;
+		return RESULT_ERROR;
+	}
+
+	periods_output = 0;
+	underruns_count = 0;
+	audio_output_clock_initialise(&output_clock, period_size);
+	return RESULT_OK;
+}
+
+static void file_driver_deinitialise()
+{
+	if (sndfile != NULL)
+	{
+		sf_write_sync(sndfile);
+		sf_close(sndfile);
+		sndfile = NULL;
+	}
+
+	free(period_buffer);
+	period_buffer = NULL;
+}
+
+static void file_driver_sync_with_output()
+{
+	if (realtime)
+	{
+		underruns_count += audio_output_clock_wait(&output_clock);
+	}
+}
+
+static int file_driver_lock_next_write_buffer()
+{
+	return 0;
+}
+
+static void file_driver_get_buffer_params(int buffer_index, void** data, int* sample_count)
+{
+	*data = period_buffer;
+	*sample_count = period_samples;
+}
+
+static void file_driver_unlock_buffer(int buffer_index)
+{
+	sf_writef_short(sndfile, period_buffer, period_samples);
+	periods_output++;
+}
+
+static int file_driver_get_samples_output()
+{
+	return periods_output * period_samples;
+}
+
+static int file_driver_get_xruns_count()
+{
+	return 0;
+}
+
+static int file_driver_get_underruns_count()
+{
+	return underruns_count;
+}
+
+audio_output_driver_t audio_output_file_driver =
+{
+	.name = "file",
+	.initialise = file_driver_initialise,
+	.deinitialise = file_driver_deinitialise,
+	.sync_with_output = file_driver_sync_with_output,
+	.lock_next_write_buffer = file_driver_lock_next_write_buffer,
+	.get_buffer_params = file_driver_get_buffer_params,
+	.unlock_buffer = file_driver_unlock_buffer,
+	.get_samples_output = file_driver_get_samples_output,
+	.get_xruns_count = file_driver_get_xruns_count,
+	.get_underruns_count = file_driver_get_underruns_count
+};
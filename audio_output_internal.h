@@ -15,15 +15,31 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 /*
- * filter_timing_test.h
+ * audio_output_internal.h
  *
- *  Created on: 15 Feb 2013
+ *  Created on: 16 Oct 2026
  *      Author: ntuckett
  */
 
-#ifndef FILTER_TIMING_TEST_H_
-#define FILTER_TIMING_TEST_H_
+#ifndef AUDIO_OUTPUT_INTERNAL_H_
+#define AUDIO_OUTPUT_INTERNAL_H_
 
-extern void filter_timing_test(int count);
+#include <time.h>
+#include "audio_output.h"
 
-#endif /* FILTER_TIMING_TEST_H_ */
+extern audio_output_driver_t audio_output_alsa_driver;
+extern audio_output_driver_t audio_output_null_driver;
+extern audio_output_driver_t audio_output_file_driver;
+
+// Paces drivers without a device clock to real time, one period per tick.
+typedef struct audio_output_clock_t
+{
+	struct timespec next_tick;
+	long period_ns;
+	int started;
+} audio_output_clock_t;
+
+extern void audio_output_clock_initialise(audio_output_clock_t* clock, int period_size);
+extern int audio_output_clock_wait(audio_output_clock_t* clock);
+
+#endif /* AUDIO_OUTPUT_INTERNAL_H_ */
@@ -0,0 +1,108 @@
+// Pithesiser - a software synthesiser for Raspberry Pi
+// Copyright (C) 2015 Nicholas Tuckett
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * audio_output_null.c
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: ntuckett
+ *
+ *  Audio output driver that discards everything rendered, paced by the monotonic clock
+ *  as if a device was playing it. For running without a sound card.
+ */
+
+#include <stdlib.h>
+#include "audio_output_internal.h"
+#include "system_constants.h"
+#include "logging.h"
+
+static sample_t* period_buffer = NULL;
+static int period_samples = 0;
+static int periods_output = 0;
+static int underruns_count = 0;
+static audio_output_clock_t output_clock;
+
+static int null_driver_initialise(config_setting_t* setting, int period_size, int buffer_count)
+{
+	period_samples = period_size;
+	period_buffer = calloc(period_samples, BYTES_PER_SAMPLE);
+	if (period_buffer == NULL)
+	{
+		LOG_ERROR("Null audio output: cannot allocate period buffer");
+		return RESULT_ERROR;
+	}
+
+	periods_output = 0;
+	underruns_count = 0;
+	audio_output_clock_initialise(&output_clock, period_size);
+	return RESULT_OK;
+}
+
+static void null_driver_deinitialise()
+{
+	free(period_buffer);
+	period_buffer = NULL;
+}
+
+static void null_driver_sync_with_output()
+{
+	underruns_count += audio_output_clock_wait(&output_clock);
+}
+
+static int null_driver_lock_next_write_buffer()
+{
+	return 0;
+}
+
+static void null_driver_get_buffer_params(int buffer_index, void** data, int* sample_count)
+{
+	*data = period_buffer;
+	*sample_count = period_samples;
+}
+
+static void null_driver_unlock_buffer(int buffer_index)
+{
+	periods_output++;
+}
+
+static int null_driver_get_samples_output()
+{
+	return periods_output * period_samples;
+}
+
+static int null_driver_get_xruns_count()
+{
+	return 0;
+}
+
+static int null_driver_get_underruns_count()
+{
+	return underruns_count;
+}
+
+audio_output_driver_t audio_output_null_driver =
+{
+	.name = "null",
+	.initialise = null_driver_initialise,
+	.deinitialise = null_driver_deinitialise,
+	.sync_with_output = null_driver_sync_with_output,
+	.lock_next_write_buffer = null_driver_lock_next_write_buffer,
+	.get_buffer_params = null_driver_get_buffer_params,
+	.unlock_buffer = null_driver_unlock_buffer,
+	.get_samples_output = null_driver_get_samples_output,
+	.get_xruns_count = null_driver_get_xruns_count,
+	.get_underruns_count = null_driver_get_underruns_count
+};
@@ -0,0 +1,431 @@
+// Pithesiser - a software synthesiser for Raspberry Pi
+// Copyright (C) 2015 Nicholas Tuckett
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+/*
+ * dsp_kernel.c
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: ntuckett
+ */
+
+#include "dsp_kernel.h"
+#include <stdio.h>
+#include <string.h>
+#include "dsp_kernel_internal.h"
+#include "logging.h"
+
+//-----------------------------------------------------------------------------------------------------------------------
+// ARMv6 assembler kernels
+//
+#if defined(DSP_KERNELS_ARMV6)
+
+extern void filter_apply_hp_asm(sample_t *sample_data, int sample_count, filter_state_t *filter_state);
+
+static int dsp_kernels_armv6_supported()
+{
+	return 1;
+}
+
+const dsp_kernels_t dsp_kernels_armv6 =
+{
+	"armv6",
+	dsp_kernels_armv6_supported,
+	filter_apply_hp_asm,
+	dsp_filter_apply_interp_c,		// Ramping coefficients needs more registers than the assembler has spare.
+	dsp_filter_bank_apply_c,
+	dsp_filter_bank_apply_interp_c,
+	dsp_mixdown_mono_to_bus_c,
+	dsp_bus_to_stereo_c,
+	dsp_wavetable_hermite_c,
+	dsp_wavetable_polynomial_c,
+	dsp_wavetable_unison_c
+};
+
+#endif
+
+//-----------------------------------------------------------------------------------------------------------------------
+// Kernel selection
+//
+
+// In order of preference.
+static const dsp_kernels_t* kernel_sets[] =
+{
+#if defined(DSP_KERNELS_ARMV6)
+	&dsp_kernels_armv6,
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+	&dsp_kernels_avx2,
+#endif
+	&dsp_kernels_vector,
+	&dsp_kernels_c
+};
+
+#define KERNEL_SET_COUNT	(sizeof(kernel_sets) / sizeof(kernel_sets[0]))
+
+const dsp_kernels_t* dsp_kernels = &dsp_kernels_c;
+
+int dsp_kernels_initialise(const char* name)
+{
+	int automatic = name == NULL || strcmp(name, DSP_KERNELS_AUTO) == 0;
+
+	for (int i = 0; i < KERNEL_SET_COUNT; i++)
+	{
+		if ((automatic || strcmp(kernel_sets[i]->name, name) == 0) && kernel_sets[i]->supported())
+		{
+			dsp_kernels = kernel_sets[i];
+			LOG_INFO("DSP kernels: %s", dsp_kernels->name);
+			return RESULT_OK;
+		}
+	}
+
+	LOG_ERROR("DSP kernels %s are unknown or unsupported on this CPU", name);
+	return RESULT_ERROR;
+}
+
+int dsp_kernels_count()
+{
+	return KERNEL_SET_COUNT;
+}
+
+const dsp_kernels_t* dsp_kernels_get(int index)
+{
+	return index >= 0 && index < KERNEL_SET_COUNT ? kernel_sets[index] : NULL;
+}
+
+//-----------------------------------------------------------------------------------------------------------------------
+// Verification
+//
+// Each supported set is run against the portable C kernels on random data and filter states, and must produce
+// identical samples and filter states. Buffers have a guard area after them to catch overruns.
+// Sample counts are even, as the assembler kernels work on sample pairs.
+//
+
+#define VERIFY_TRIALS			200
+#define VERIFY_MAX_SAMPLES		256
+#define VERIFY_GUARD_SAMPLES	16
+#define VERIFY_GUARD_VALUE		0x5a5a
+#define VERIFY_MAX_TABLE_BITS	11
+
+static const int verify_sample_counts[] = { 2, 4, 8, 14, 16, 30, 64, 126, 128, 256 };
+
+#define VERIFY_SAMPLE_COUNTS	(sizeof(verify_sample_counts) / sizeof(verify_sample_counts[0]))
+
+typedef struct kernel_buffers_t
+{
+	sample_t expected[VERIFY_MAX_SAMPLES * 2 + VERIFY_GUARD_SAMPLES];
+	sample_t actual[VERIFY_MAX_SAMPLES * 2 + VERIFY_GUARD_SAMPLES];
+	sample_t source[VERIFY_MAX_SAMPLES];
+	sample_t bank_expected[VERIFY_MAX_SAMPLES * FILTER_BANK_LANES + VERIFY_GUARD_SAMPLES];
+	sample_t bank_actual[VERIFY_MAX_SAMPLES * FILTER_BANK_LANES + VERIFY_GUARD_SAMPLES];
+	bus_sample_t bus_expected[VERIFY_MAX_SAMPLES * 2 + VERIFY_GUARD_SAMPLES];
+	bus_sample_t bus_actual[VERIFY_MAX_SAMPLES * 2 + VERIFY_GUARD_SAMPLES];
+	sample_t table[(DSP_POLY_COEFFS << VERIFY_MAX_TABLE_BITS) + 1];
+} kernel_buffers_t;
+
+static uint32_t random_state = 0x12345678;
+
+static int32_t random_int(int32_t min, int32_t max)
+{
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 17;
+	random_state ^= random_state << 5;
+	return min + (int32_t)(random_state % (uint32_t)(max - min + 1));
+}
+
+static void random_samples(sample_t* samples, int sample_count)
+{
+	for (int i = 0; i < sample_count; i++)
+	{
+		samples[i] = random_int(SHRT_MIN, SHRT_MAX);
+	}
+}
+
+static void fill_guarded(kernel_buffers_t* buffers, int sample_count)
+{
+	for (int i = 0; i < VERIFY_MAX_SAMPLES * 2 + VERIFY_GUARD_SAMPLES; i++)
+	{
+		buffers->expected[i] = (i < sample_count) ? random_int(SHRT_MIN, SHRT_MAX) : VERIFY_GUARD_VALUE;
+	}
+	memcpy(buffers->actual, buffers->expected, sizeof(buffers->actual));
+}
+
+static void random_filter_history(filter_state_t* filter_state)
+{
+	filter_state->history[0] = random_int(SHRT_MIN, SHRT_MAX);
+	filter_state->history[1] = random_int(SHRT_MIN, SHRT_MAX);
+	filter_state->output[0] = random_int(SHRT_MIN * 2, SHRT_MAX * 2);
+	filter_state->output[1] = random_int(SHRT_MIN * 2, SHRT_MAX * 2);
+}
+
+// Sets up a filter as the synth would after a parameter change, so both the last and current states are valid.
+static void random_filter(filter_t* filter)
+{
+	filter_init(filter);
+	filter->definition.type = random_int(FILTER_LPF, FILTER_HPF);
+	filter->definition.frequency = random_int(FILTER_MIN_FREQUENCY, FILTER_MAX_FREQUENCY);
+	filter->definition.q = random_int(FILTER_MIN_Q, FILTER_MAX_Q);
+	filter_update(filter);
+	filter->definition.frequency = random_int(FILTER_MIN_FREQUENCY, FILTER_MAX_FREQUENCY);
+	filter->definition.q = random_int(FILTER_MIN_Q, FILTER_MAX_Q);
+	filter_update(filter);
+
+	random_filter_history(&filter->last_state);
+	random_filter_history(&filter->state);
+}
+
+static int verify_filter(const dsp_kernels_t* kernels, kernel_buffers_t* buffers, int sample_count)
+{
+	filter_t expected_filter, actual_filter;
+
+	random_filter(&expected_filter);
+	actual_filter = expected_filter;
+	fill_guarded(buffers, sample_count);
+
+	dsp_kernels_c.filter_apply(buffers->expected, sample_count, &expected_filter.state);
+	kernels->filter_apply(buffers->actual, sample_count, &actual_filter.state);
+
+	return memcmp(buffers->expected, buffers->actual, sizeof(buffers->actual)) == 0
+			&& memcmp(&expected_filter.state, &actual_filter.state, sizeof(filter_state_t)) == 0;
+}
+
+static int verify_filter_interp(const dsp_kernels_t* kernels, kernel_buffers_t* buffers, int sample_count)
+{
+	filter_t expected_filter, actual_filter;
+
+	random_filter(&expected_filter);
+	actual_filter = expected_filter;
+	fill_guarded(buffers, sample_count);
+
+	dsp_kernels_c.filter_apply_interp(buffers->expected, sample_count, &expected_filter.state, &expected_filter.last_state);
+	kernels->filter_apply_interp(buffers->actual, sample_count, &actual_filter.state, &actual_filter.last_state);
+
+	return memcmp(buffers->expected, buffers->actual, sizeof(buffers->actual)) == 0
+			&& memcmp(&expected_filter.state, &actual_filter.state, sizeof(filter_state_t)) == 0
+			&& memcmp(&expected_filter.last_state, &actual_filter.last_state, sizeof(filter_state_t)) == 0;
+}
+
+// Banks are checked lane by lane against single filters, with some lanes left empty. When ramping, some lanes
+// are not updated; they ramp from their state to itself, and must give the same results as not ramping.
+static int verify_filter_bank(const dsp_kernels_t* kernels, kernel_buffers_t* buffers, int sample_count, int interpolate)
+{
+	filter_t expected_filter[FILTER_BANK_LANES], actual_filter[FILTER_BANK_LANES];
+	filter_bank_t bank;
+	int result = TRUE;
+
+	for (int i = 0; i < VERIFY_MAX_SAMPLES * FILTER_BANK_LANES + VERIFY_GUARD_SAMPLES; i++)
+	{
+		buffers->bank_expected[i] = (i < sample_count * FILTER_BANK_LANES) ? random_int(SHRT_MIN, SHRT_MAX) : VERIFY_GUARD_VALUE;
+	}
+	memcpy(buffers->bank_actual, buffers->bank_expected, sizeof(buffers->bank_actual));
+
+	filter_bank_init(&bank, buffers->bank_actual, sample_count);
+
+	for (int lane = 0; lane < FILTER_BANK_LANES; lane++)
+	{
+		int lane_type = random_int(0, 3);
+		sample_t* sample_data = buffers->bank_expected + lane * sample_count;
+
+		if (lane_type == 0)
+		{
+			expected_filter[lane].definition.type = FILTER_PASS;
+			continue;
+		}
+
+		random_filter(&expected_filter[lane]);
+		expected_filter[lane].updated = interpolate && lane_type > 1;
+		actual_filter[lane] = expected_filter[lane];
+		filter_bank_set_lane(&bank, lane, &actual_filter[lane]);
+
+		if (expected_filter[lane].updated)
+		{
+			dsp_kernels_c.filter_apply_interp(sample_data, sample_count, &expected_filter[lane].state, &expected_filter[lane].last_state);
+		}
+		else
+		{
+			dsp_kernels_c.filter_apply(sample_data, sample_count, &expected_filter[lane].state);
+		}
+	}
+
+	if (interpolate)
+	{
+		kernels->filter_bank_apply_interp(&bank, sample_count);
+	}
+	else
+	{
+		kernels->filter_bank_apply(&bank, sample_count);
+	}
+
+	for (int lane = 0; lane < FILTER_BANK_LANES; lane++)
+	{
+		filter_t* filter = &expected_filter[lane];
+
+		if (filter->definition.type == FILTER_PASS)
+		{
+			continue;
+		}
+
+		for (int i = 0; i < 2; i++)
+		{
+			result &= bank.history[i][lane] == filter->state.history[i];
+			result &= bank.output[i][lane] == filter->state.output[i];
+		}
+	}
+
+	return result && memcmp(buffers->bank_expected, buffers->bank_actual, sizeof(buffers->bank_actual)) == 0;
+}
+
+// Bus samples cover several times the sample_t range, so conversion back to sample_t saturates.
+static void fill_guarded_bus(kernel_buffers_t* buffers, int sample_count)
+{
+	for (int i = 0; i < VERIFY_MAX_SAMPLES * 2 + VERIFY_GUARD_SAMPLES; i++)
+	{
+		buffers->bus_expected[i] = (i < sample_count) ? random_int(SHRT_MIN * MIXER_BUS_ONE * 4, SHRT_MAX * MIXER_BUS_ONE * 4) : VERIFY_GUARD_VALUE;
+	}
+	memcpy(buffers->bus_actual, buffers->bus_expected, sizeof(buffers->bus_actual));
+}
+
+static int verify_bus_mixer(const dsp_kernels_t* kernels, kernel_buffers_t* buffers, int sample_count)
+{
+	int32_t left = random_int(0, PAN_MAX);
+	int32_t right = random_int(0, PAN_MAX);
+
+	random_samples(buffers->source, sample_count);
+	fill_guarded_bus(buffers, sample_count * 2);
+
+	dsp_kernels_c.mixdown_mono_to_bus(buffers->source, left, right, sample_count, buffers->bus_expected);
+	kernels->mixdown_mono_to_bus(buffers->source, left, right, sample_count, buffers->bus_actual);
+
+	return memcmp(buffers->bus_expected, buffers->bus_actual, sizeof(buffers->bus_actual)) == 0;
+}
+
+static int verify_bus_output(const dsp_kernels_t* kernels, kernel_buffers_t* buffers, int sample_count)
+{
+	fill_guarded_bus(buffers, sample_count * 2);
+	fill_guarded(buffers, 0);
+
+	dsp_kernels_c.bus_to_stereo(buffers->bus_expected, sample_count, buffers->expected);
+	kernels->bus_to_stereo(buffers->bus_actual, sample_count, buffers->actual);
+
+	return memcmp(buffers->expected, buffers->actual, sizeof(buffers->actual)) == 0;
+}
+
+// Tables are random, both as samples and as polynomial coefficients, and range from a few samples upwards so
+// that index wrapping is exercised. Phase steps include ones that skip several samples at a time.
+static int verify_wavetable(wavetable_kernel_t expected_kernel, wavetable_kernel_t actual_kernel, int polynomial, kernel_buffers_t* buffers, int sample_count)
+{
+	int size_bits = random_int(2, VERIFY_MAX_TABLE_BITS);
+	int table_size = polynomial ? DSP_POLY_COEFFS << size_bits : 1 << size_bits;
+	uint32_t phase = (uint32_t)random_int(0, INT_MAX - 1) * 2 + random_int(0, 1);
+	uint32_t phase_step = (uint32_t)random_int(0, INT_MAX - 1) >> random_int(0, 24);
+
+	random_samples(buffers->table, table_size + 1);
+	fill_guarded(buffers, 0);
+
+	expected_kernel(buffers->table, size_bits, phase, phase_step, sample_count, buffers->expected);
+	actual_kernel(buffers->table, size_bits, phase, phase_step, sample_count, buffers->actual);
+
+	return memcmp(buffers->expected, buffers->actual, sizeof(buffers->actual)) == 0;
+}
+
+// Random oscillators mix into random samples, so saturation is exercised; the phases they end on must match too.
+static int verify_wavetable_unison(const dsp_kernels_t* kernels, kernel_buffers_t* buffers, int sample_count)
+{
+	int size_bits = random_int(2, VERIFY_MAX_TABLE_BITS);
+	int oscillator_count = random_int(1, DSP_UNISON_MAX_OSCILLATORS);
+	uint32_t expected_phase[DSP_UNISON_MAX_OSCILLATORS], actual_phase[DSP_UNISON_MAX_OSCILLATORS], phase_step[DSP_UNISON_MAX_OSCILLATORS];
+	int32_t level[DSP_UNISON_MAX_OSCILLATORS];
+
+	for (int osc = 0; osc < oscillator_count; osc++)
+	{
+		expected_phase[osc] = actual_phase[osc] = (uint32_t)random_int(0, INT_MAX - 1) * 2 + random_int(0, 1);
+		phase_step[osc] = (uint32_t)random_int(0, INT_MAX - 1) >> random_int(0, 24);
+		level[osc] = random_int(0, LEVEL_MAX);
+	}
+
+	random_samples(buffers->table, (1 << size_bits) + 1);
+	fill_guarded(buffers, sample_count);
+
+	dsp_kernels_c.wavetable_unison(buffers->table, size_bits, oscillator_count, expected_phase, phase_step, level, sample_count, buffers->expected);
+	kernels->wavetable_unison(buffers->table, size_bits, oscillator_count, actual_phase, phase_step, level, sample_count, buffers->actual);
+
+	return memcmp(buffers->expected, buffers->actual, sizeof(buffers->actual)) == 0
+			&& memcmp(expected_phase, actual_phase, oscillator_count * sizeof(uint32_t)) == 0;
+}
+
+static int verify_kernels(const dsp_kernels_t* kernels, kernel_buffers_t* buffers)
+{
+	static const char* kernel_names[] = { "filter_apply", "filter_apply_interp", "filter_bank_apply", "filter_bank_apply_interp", "mixdown_mono_to_bus",
+											 "bus_to_stereo", "wavetable_hermite", "wavetable_polynomial", "wavetable_unison" };
+	int failures[9] = { 0 };
+
+	for (int i = 0; i < VERIFY_SAMPLE_COUNTS; i++)
+	{
+		int sample_count = verify_sample_counts[i];
+
+		for (int trial = 0; trial < VERIFY_TRIALS; trial++)
+		{
+			failures[0] += !verify_filter(kernels, buffers, sample_count);
+			failures[1] += !verify_filter_interp(kernels, buffers, sample_count);
+			failures[2] += !verify_filter_bank(kernels, buffers, sample_count, FALSE);
+			failures[3] += !verify_filter_bank(kernels, buffers, sample_count, TRUE);
+			failures[4] += !verify_bus_mixer(kernels, buffers, sample_count);
+			failures[5] += !verify_bus_output(kernels, buffers, sample_count);
+			failures[6] += !verify_wavetable(dsp_kernels_c.wavetable_hermite, kernels->wavetable_hermite, FALSE, buffers, sample_count);
+			failures[7] += !verify_wavetable(dsp_kernels_c.wavetable_polynomial, kernels->wavetable_polynomial, TRUE, buffers, sample_count);
+			failures[8] += !verify_wavetable_unison(kernels, buffers, sample_count);
+		}
+	}
+
+	int result = RESULT_OK;
+
+	for (int i = 0; i < sizeof(failures) / sizeof(failures[0]); i++)
+	{
+		if (failures[i] > 0)
+		{
+			printf("%s: %s mismatched in %d of %d trials\n", kernels->name, kernel_names[i], failures[i], (int)(VERIFY_SAMPLE_COUNTS * VERIFY_TRIALS));
+			result = RESULT_ERROR;
+		}
+	}
+
+	return result;
+}
+
+int dsp_kernels_verify()
+{
+	kernel_buffers_t buffers;
+	int result = RESULT_OK;
+
+	for (int i = 0; i < KERNEL_SET_COUNT; i++)
+	{
+		const dsp_kernels_t* kernels = kernel_sets[i];
+
+		if (!kernels->supported())
+		{
+			printf("%s: not supported on this CPU\n", kernels->name);
+		}
+		else if (verify_kernels(kernels, &buffers) == RESULT_OK)
+		{
+			printf("%s: ok\n", kernels->name);
+		}
+		else
+		{
+			result = RESULT_ERROR;
+		}
+	}
+
+	return result;
+}
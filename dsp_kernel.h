@@ -0,0 +1,84 @@
+// Pithesiser - a software synthesiser for Raspberry Pi
+// Copyright (C) 2015 Nicholas Tuckett
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+/*
+ * dsp_kernel.h
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: ntuckett
+ *
+ *  Dispatch table for the inner loop DSP kernels (biquad filters, filter banks, mono to stereo mixers, the mix bus,
+ *  wavetable interpolation & unison oscillators).
+ *  Every set of kernels is bit exact with the portable C set, so they can be swapped freely;
+ *  the best one supported by the CPU is selected at startup.
+ */
+
+#ifndef DSP_KERNEL_H_
+#define DSP_KERNEL_H_
+
+#include <stdint.h>
+#include "system_constants.h"
+#include "filter.h"
+#include "filter_bank.h"
+#include "mixer.h"
+
+#define DSP_KERNELS_AUTO	"auto"
+
+typedef void (*filter_kernel_t)(sample_t *sample_data, int sample_count, filter_state_t *filter_state);
+typedef void (*filter_interp_kernel_t)(sample_t *sample_data, int sample_count, filter_state_t *filter_state_current, filter_state_t *filter_state_last);
+typedef void (*filter_bank_kernel_t)(filter_bank_t* bank, int sample_count);
+typedef void (*bus_mixer_kernel_t)(sample_t *source, int32_t left, int32_t right, int sample_count, bus_sample_t *bus);
+typedef void (*bus_output_kernel_t)(bus_sample_t *bus, int sample_count, sample_t *dest);
+
+// Interpolates sample_count samples from a table of 2^size_bits entries, with the phase running over 32 bits per cycle.
+// Hermite kernels take the samples, and must be able to read one sample past the end of the table.
+// Polynomial kernels take DSP_POLY_COEFFS 16-bit coefficients per sample in place of the samples.
+#define DSP_POLY_COEFFS		4
+
+typedef void (*wavetable_kernel_t)(const sample_t *table, int size_bits, uint32_t phase, uint32_t phase_step, int sample_count, sample_t *dest);
+
+// Mixes up to DSP_UNISON_MAX_OSCILLATORS oscillators reading the same table into dest in one pass, each linearly
+// interpolated and scaled by its level (with LEVEL_MAX as full level). Every oscillator has its own phase & phase step,
+// and its phase is advanced past the samples mixed. Kernels must be able to read one sample past the end of the table.
+#define DSP_UNISON_MAX_OSCILLATORS	8
+
+typedef void (*wavetable_unison_kernel_t)(const sample_t *table, int size_bits, int oscillator_count, uint32_t *phase, const uint32_t *phase_step, const int32_t *level, int sample_count, sample_t *dest);
+
+typedef struct dsp_kernels_t
+{
+	const char*				name;
+	int						(*supported)();
+	filter_kernel_t			filter_apply;
+	filter_interp_kernel_t	filter_apply_interp;
+	filter_bank_kernel_t	filter_bank_apply;
+	filter_bank_kernel_t	filter_bank_apply_interp;
+	bus_mixer_kernel_t		mixdown_mono_to_bus;
+	bus_output_kernel_t		bus_to_stereo;
+	wavetable_kernel_t		wavetable_hermite;
+	wavetable_kernel_t		wavetable_polynomial;
+	wavetable_unison_kernel_t	wavetable_unison;
+} dsp_kernels_t;
+
+// Kernels in use; the portable C set until dsp_kernels_initialise is called.
+extern const dsp_kernels_t* dsp_kernels;
+
+extern int dsp_kernels_initialise(const char* name);
+extern int dsp_kernels_count();
+extern const dsp_kernels_t* dsp_kernels_get(int index);
+extern int dsp_kernels_verify();
+
+#endif /* DSP_KERNEL_H_ */
@@ -0,0 +1,259 @@
+// Pithesiser - a software synthesiser for Raspberry Pi
+// Copyright (C) 2015 Nicholas Tuckett
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+/*
+ * dsp_kernel_c.c
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: ntuckett
+ *
+ *  Portable C kernels. These define the results every other set of kernels must match bit for bit;
+ *  they follow the ARMv6 assembler versions exactly, including its wrap around on 16-bit stores.
+ */
+
+#include "dsp_kernel_internal.h"
+
+#define FILTER_BANK_COEFFS(bank, lane)	(bank)->input_coeff[0][lane], (bank)->input_coeff[1][lane], (bank)->input_coeff[2][lane], (bank)->output_coeff[0][lane], (bank)->output_coeff[1][lane]
+
+void dsp_filter_apply_c(sample_t *sample_data, int sample_count, filter_state_t *filter_state)
+{
+	fixed_t history0 = filter_state->history[0];
+	fixed_t history1 = filter_state->history[1];
+	fixed_t output0 = filter_state->output[0];
+	fixed_t output1 = filter_state->output[1];
+
+	for (int i = 0; i < sample_count; i++)
+	{
+		fixed_t sample = sample_data[i];
+		fixed_t output = dsp_filter_sample(FILTER_STATE_COEFFS(filter_state), sample, history0, history1, output0, output1);
+
+		sample_data[i] = (sample_t)output;
+
+		history1 = history0;
+		history0 = sample;
+		output1 = output0;
+		output0 = output;
+	}
+
+	filter_state->history[0] = history0;
+	filter_state->history[1] = history1;
+	filter_state->output[0] = output0;
+	filter_state->output[1] = output1;
+}
+
+// Runs from the history of the last filter, as the current one has just been set up.
+void dsp_filter_apply_interp_c(sample_t *sample_data, int sample_count, filter_state_t *filter_state_current, filter_state_t *filter_state_last)
+{
+	filter_state_t coeffs, step;
+	dsp_filter_ramp(filter_state_current, filter_state_last, sample_count, &coeffs, &step);
+
+	fixed_t history0 = filter_state_last->history[0];
+	fixed_t history1 = filter_state_last->history[1];
+	fixed_t output0 = filter_state_last->output[0];
+	fixed_t output1 = filter_state_last->output[1];
+
+	fixed_t input_coeff0 = coeffs.input_coeff[0];
+	fixed_t input_coeff1 = coeffs.input_coeff[1];
+	fixed_t input_coeff2 = coeffs.input_coeff[2];
+	fixed_t output_coeff0 = coeffs.output_coeff[0];
+	fixed_t output_coeff1 = coeffs.output_coeff[1];
+
+	for (int i = 0; i < sample_count; i++)
+	{
+		fixed_t sample = sample_data[i];
+
+		input_coeff0 += step.input_coeff[0];
+		input_coeff1 += step.input_coeff[1];
+		input_coeff2 += step.input_coeff[2];
+		output_coeff0 += step.output_coeff[0];
+		output_coeff1 += step.output_coeff[1];
+
+		fixed_t output = dsp_filter_sample(input_coeff0, input_coeff1, input_coeff2, output_coeff0, output_coeff1, sample, history0, history1, output0, output1);
+
+		sample_data[i] = (sample_t)output;
+
+		history1 = history0;
+		history0 = sample;
+		output1 = output0;
+		output0 = output;
+	}
+
+	filter_state_current->history[0] = history0;
+	filter_state_current->history[1] = history1;
+	filter_state_current->output[0] = output0;
+	filter_state_current->output[1] = output1;
+}
+
+// Filter banks run each lane in turn, exactly as a single filter would be.
+void dsp_filter_bank_apply_c(filter_bank_t* bank, int sample_count)
+{
+	for (int lane = 0; lane < FILTER_BANK_LANES; lane++)
+	{
+		sample_t* sample_data = bank->sample_data[lane];
+		fixed_t history0 = bank->history[0][lane];
+		fixed_t history1 = bank->history[1][lane];
+		fixed_t output0 = bank->output[0][lane];
+		fixed_t output1 = bank->output[1][lane];
+
+		for (int i = 0; i < sample_count; i++)
+		{
+			fixed_t sample = sample_data[i];
+			fixed_t output = dsp_filter_sample(FILTER_BANK_COEFFS(bank, lane), sample, history0, history1, output0, output1);
+
+			sample_data[i] = (sample_t)output;
+
+			history1 = history0;
+			history0 = sample;
+			output1 = output0;
+			output0 = output;
+		}
+
+		bank->history[0][lane] = history0;
+		bank->history[1][lane] = history1;
+		bank->output[0][lane] = output0;
+		bank->output[1][lane] = output1;
+	}
+}
+
+void dsp_filter_bank_apply_interp_c(filter_bank_t* bank, int sample_count)
+{
+	fixed_t input_coeff[3][FILTER_BANK_LANES], output_coeff[2][FILTER_BANK_LANES];
+	fixed_t input_step[3][FILTER_BANK_LANES], output_step[2][FILTER_BANK_LANES];
+
+	dsp_filter_bank_ramp(bank, sample_count, input_coeff, output_coeff, input_step, output_step);
+
+	for (int lane = 0; lane < FILTER_BANK_LANES; lane++)
+	{
+		sample_t* sample_data = bank->sample_data[lane];
+		fixed_t history0 = bank->history[0][lane];
+		fixed_t history1 = bank->history[1][lane];
+		fixed_t output0 = bank->output[0][lane];
+		fixed_t output1 = bank->output[1][lane];
+		fixed_t input_coeff0 = input_coeff[0][lane];
+		fixed_t input_coeff1 = input_coeff[1][lane];
+		fixed_t input_coeff2 = input_coeff[2][lane];
+		fixed_t output_coeff0 = output_coeff[0][lane];
+		fixed_t output_coeff1 = output_coeff[1][lane];
+
+		for (int i = 0; i < sample_count; i++)
+		{
+			fixed_t sample = sample_data[i];
+
+			input_coeff0 += input_step[0][lane];
+			input_coeff1 += input_step[1][lane];
+			input_coeff2 += input_step[2][lane];
+			output_coeff0 += output_step[0][lane];
+			output_coeff1 += output_step[1][lane];
+
+			fixed_t output = dsp_filter_sample(input_coeff0, input_coeff1, input_coeff2, output_coeff0, output_coeff1, sample, history0, history1, output0, output1);
+
+			sample_data[i] = (sample_t)output;
+
+			history1 = history0;
+			history0 = sample;
+			output1 = output0;
+			output0 = output;
+		}
+
+		bank->history[0][lane] = history0;
+		bank->history[1][lane] = history1;
+		bank->output[0][lane] = output0;
+		bank->output[1][lane] = output1;
+	}
+}
+
+void dsp_mixdown_mono_to_bus_c(sample_t *source, int32_t left, int32_t right, int sample_count, bus_sample_t *bus)
+{
+	for (int i = 0; i < sample_count; i++)
+	{
+		int32_t sample = source[i];
+
+		*bus++ += (sample * left) >> DSP_BUS_PAN_SHIFT;
+		*bus++ += (sample * right) >> DSP_BUS_PAN_SHIFT;
+	}
+}
+
+void dsp_bus_to_stereo_c(bus_sample_t *bus, int sample_count, sample_t *dest)
+{
+	for (int i = 0; i < sample_count * 2; i++)
+	{
+		*dest++ = dsp_saturate_sample((*bus++ + DSP_BUS_ROUNDING) >> MIXER_BUS_PRECISION);
+	}
+}
+
+void dsp_wavetable_hermite_c(const sample_t *table, int size_bits, uint32_t phase, uint32_t phase_step, int sample_count, sample_t *dest)
+{
+	int index_shift = 32 - size_bits;
+	uint32_t index_mask = (1 << size_bits) - 1;
+
+	for (int i = 0; i < sample_count; i++)
+	{
+		dest[i] = dsp_wavetable_hermite_sample(table, index_mask, index_shift, phase);
+		phase += phase_step;
+	}
+}
+
+void dsp_wavetable_polynomial_c(const sample_t *table, int size_bits, uint32_t phase, uint32_t phase_step, int sample_count, sample_t *dest)
+{
+	int index_shift = 32 - size_bits;
+
+	for (int i = 0; i < sample_count; i++)
+	{
+		dest[i] = dsp_wavetable_poly_sample(table, index_shift, phase);
+		phase += phase_step;
+	}
+}
+
+// Oscillators are summed for each sample before it's mixed into dest, so dest is only read & written once.
+void dsp_wavetable_unison_c(const sample_t *table, int size_bits, int oscillator_count, uint32_t *phase, const uint32_t *phase_step, const int32_t *level, int sample_count, sample_t *dest)
+{
+	int index_shift = 32 - size_bits;
+	uint32_t index_mask = (1 << size_bits) - 1;
+
+	for (int i = 0; i < sample_count; i++)
+	{
+		int32_t sum = dest[i];
+
+		for (int osc = 0; osc < oscillator_count; osc++)
+		{
+			sum += dsp_wavetable_unison_sample(table, index_mask, index_shift, phase[osc], level[osc]);
+			phase[osc] += phase_step[osc];
+		}
+
+		dest[i] = dsp_saturate_sample(sum);
+	}
+}
+
+static int dsp_kernels_c_supported()
+{
+	return 1;
+}
+
+const dsp_kernels_t dsp_kernels_c =
+{
+	"c",
+	dsp_kernels_c_supported,
+	dsp_filter_apply_c,
+	dsp_filter_apply_interp_c,
+	dsp_filter_bank_apply_c,
+	dsp_filter_bank_apply_interp_c,
+	dsp_mixdown_mono_to_bus_c,
+	dsp_bus_to_stereo_c,
+	dsp_wavetable_hermite_c,
+	dsp_wavetable_polynomial_c,
+	dsp_wavetable_unison_c
+};
@@ -0,0 +1,182 @@
+// Pithesiser - a software synthesiser for Raspberry Pi
+// Copyright (C) 2015 Nicholas Tuckett
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+/*
+ * dsp_kernel_internal.h
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: ntuckett
+ */
+
+#ifndef DSP_KERNEL_INTERNAL_H_
+#define DSP_KERNEL_INTERNAL_H_
+
+#include <stdint.h>
+#include "dsp_kernel.h"
+
+// Filter accumulation is done at 64 bits, with coefficients at FIXED_PRECISION.
+#define DSP_FILTER_PRECISION		FIXED_PRECISION
+#define DSP_FILTER_ROUNDING			(1 << (DSP_FILTER_PRECISION - 1))
+
+// Mixer pan factors are 0 to PAN_MAX, i.e. 1.15 fixed point.
+#define DSP_PAN_PRECISION			15
+
+// Panned samples go onto the bus keeping MIXER_BUS_PRECISION bits of the pan product's fraction.
+#define DSP_BUS_PAN_SHIFT			(DSP_PAN_PRECISION - MIXER_BUS_PRECISION)
+#define DSP_BUS_ROUNDING			(1 << (MIXER_BUS_PRECISION - 1))
+
+extern const dsp_kernels_t dsp_kernels_c;
+extern const dsp_kernels_t dsp_kernels_vector;
+#if defined(__x86_64__) || defined(__i386__)
+extern const dsp_kernels_t dsp_kernels_avx2;
+#endif
+#if defined(DSP_KERNELS_ARMV6)
+extern const dsp_kernels_t dsp_kernels_armv6;
+#endif
+
+extern void dsp_filter_apply_c(sample_t *sample_data, int sample_count, filter_state_t *filter_state);
+extern void dsp_filter_apply_interp_c(sample_t *sample_data, int sample_count, filter_state_t *filter_state_current, filter_state_t *filter_state_last);
+extern void dsp_filter_bank_apply_c(filter_bank_t* bank, int sample_count);
+extern void dsp_filter_bank_apply_interp_c(filter_bank_t* bank, int sample_count);
+extern void dsp_mixdown_mono_to_bus_c(sample_t *source, int32_t left, int32_t right, int sample_count, bus_sample_t *bus);
+extern void dsp_bus_to_stereo_c(bus_sample_t *bus, int sample_count, sample_t *dest);
+extern void dsp_wavetable_hermite_c(const sample_t *table, int size_bits, uint32_t phase, uint32_t phase_step, int sample_count, sample_t *dest);
+extern void dsp_wavetable_polynomial_c(const sample_t *table, int size_bits, uint32_t phase, uint32_t phase_step, int sample_count, sample_t *dest);
+extern void dsp_wavetable_unison_c(const sample_t *table, int size_bits, int oscillator_count, uint32_t *phase, const uint32_t *phase_step, const int32_t *level, int sample_count, sample_t *dest);
+
+static inline sample_t dsp_saturate_sample(int32_t sample)
+{
+	if (sample < SHRT_MIN)
+	{
+		return SHRT_MIN;
+	}
+	else if (sample > SHRT_MAX)
+	{
+		return SHRT_MAX;
+	}
+
+	return (sample_t)sample;
+}
+
+#define FILTER_STATE_COEFFS(state)	(state)->input_coeff[0], (state)->input_coeff[1], (state)->input_coeff[2], (state)->output_coeff[0], (state)->output_coeff[1]
+
+static __attribute__((always_inline)) inline fixed_t dsp_filter_sample(fixed_t input_coeff0, fixed_t input_coeff1, fixed_t input_coeff2, fixed_t output_coeff0, fixed_t output_coeff1,
+																		fixed_t sample, fixed_t history0, fixed_t history1, fixed_t output0, fixed_t output1)
+{
+	int64_t new_sample;
+
+	new_sample =  (int64_t)history1 * input_coeff2;
+	new_sample += (int64_t)sample * input_coeff0;
+	new_sample += (int64_t)history0 * input_coeff1;
+	new_sample += (int64_t)output0 * output_coeff0;
+	new_sample += (int64_t)output1 * output_coeff1;
+
+	return (fixed_t)((new_sample + DSP_FILTER_ROUNDING) >> DSP_FILTER_PRECISION);
+}
+
+// Filters that have just been updated ramp their coefficients from the last state's to the current state's over the
+// buffer, a step before each sample, so the last sample is filtered with exactly the current coefficients.
+// Direct form 1 holds only past inputs & outputs, so it tolerates coefficients changing every sample; and as stable
+// biquads form a convex region, every coefficient set along the ramp between two stable filters is stable too.
+static inline void dsp_ramp_coeff(fixed_t last, fixed_t current, int sample_count, fixed_t* start, fixed_t* step)
+{
+	*step = (current - last) / sample_count;
+	*start = current - *step * sample_count;
+}
+
+// Coefficients only are set in start & step.
+static inline void dsp_filter_ramp(const filter_state_t* current, const filter_state_t* last, int sample_count, filter_state_t* start, filter_state_t* step)
+{
+	for (int i = 0; i < 3; i++)
+	{
+		dsp_ramp_coeff(last->input_coeff[i], current->input_coeff[i], sample_count, &start->input_coeff[i], &step->input_coeff[i]);
+	}
+	for (int i = 0; i < 2; i++)
+	{
+		dsp_ramp_coeff(last->output_coeff[i], current->output_coeff[i], sample_count, &start->output_coeff[i], &step->output_coeff[i]);
+	}
+}
+
+// The same for every lane of a bank, laid out as the bank's coefficients are.
+static inline void dsp_filter_bank_ramp(const filter_bank_t* bank, int sample_count, fixed_t start_input[3][FILTER_BANK_LANES], fixed_t start_output[2][FILTER_BANK_LANES],
+										fixed_t step_input[3][FILTER_BANK_LANES], fixed_t step_output[2][FILTER_BANK_LANES])
+{
+	for (int lane = 0; lane < FILTER_BANK_LANES; lane++)
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			dsp_ramp_coeff(bank->last_input_coeff[i][lane], bank->input_coeff[i][lane], sample_count, &start_input[i][lane], &step_input[i][lane]);
+		}
+		for (int i = 0; i < 2; i++)
+		{
+			dsp_ramp_coeff(bank->last_output_coeff[i][lane], bank->output_coeff[i][lane], sample_count, &start_output[i][lane], &step_output[i][lane]);
+		}
+	}
+}
+
+// Hermite coefficients come from the four nearest samples and can need 19 bits, so the cubic is evaluated with a
+// DSP_HERMITE_PRECISION bit fraction to stay within 32 bits. Precomputed polynomial coefficients are 16 bit, so are
+// evaluated with a DSP_POLY_PRECISION bit fraction, running from -1/2 to 1/2 over the interval.
+#define DSP_HERMITE_PRECISION		12
+#define DSP_POLY_PRECISION			15
+
+static __attribute__((always_inline)) inline sample_t dsp_wavetable_hermite_sample(const sample_t *table, uint32_t index_mask, int index_shift, uint32_t phase)
+{
+	uint32_t index = phase >> index_shift;
+	int32_t x = (phase >> (index_shift - DSP_HERMITE_PRECISION)) & ((1 << DSP_HERMITE_PRECISION) - 1);
+	int32_t ym1 = table[(index - 1) & index_mask];
+	int32_t y0 = table[index];
+	int32_t y1 = table[(index + 1) & index_mask];
+	int32_t y2 = table[(index + 2) & index_mask];
+
+	int32_t c1 = (y1 - ym1) >> 1;
+	int32_t c2 = ym1 - ((5 * y0) >> 1) + y1 * 2 - (y2 >> 1);
+	int32_t c3 = ((y2 - ym1) >> 1) + ((3 * (y0 - y1)) >> 1);
+
+	int32_t sample = ((c3 * x) >> DSP_HERMITE_PRECISION) + c2;
+	sample = ((sample * x) >> DSP_HERMITE_PRECISION) + c1;
+	sample = ((sample * x) >> DSP_HERMITE_PRECISION) + y0;
+	return dsp_saturate_sample(sample);
+}
+
+static __attribute__((always_inline)) inline sample_t dsp_wavetable_poly_sample(const sample_t *coeffs, int index_shift, uint32_t phase)
+{
+	const sample_t *c = coeffs + (phase >> index_shift) * DSP_POLY_COEFFS;
+	int32_t z = ((phase >> (index_shift - DSP_POLY_PRECISION)) & ((1 << DSP_POLY_PRECISION) - 1)) - (1 << (DSP_POLY_PRECISION - 1));
+
+	int32_t sample = ((c[3] * z) >> DSP_POLY_PRECISION) + c[2];
+	sample = ((sample * z) >> DSP_POLY_PRECISION) + c[1];
+	sample = ((sample * z) >> DSP_POLY_PRECISION) + c[0];
+	return dsp_saturate_sample(sample);
+}
+
+// Unison oscillators interpolate linearly with a DSP_UNISON_PRECISION bit fraction, and are scaled by levels of the
+// same precision. The difference between neighbouring samples is taken at 32 bits, so wrapping the table is exact.
+#define DSP_UNISON_PRECISION		15
+
+static __attribute__((always_inline)) inline int32_t dsp_wavetable_unison_sample(const sample_t *table, uint32_t index_mask, int index_shift, uint32_t phase, int32_t level)
+{
+	uint32_t index = phase >> index_shift;
+	int32_t x = (phase >> (index_shift - DSP_UNISON_PRECISION)) & ((1 << DSP_UNISON_PRECISION) - 1);
+	int32_t y0 = table[index];
+	int32_t y1 = table[(index + 1) & index_mask];
+
+	int32_t sample = y0 + (((y1 - y0) * x) >> DSP_UNISON_PRECISION);
+	return (sample * level) >> DSP_UNISON_PRECISION;
+}
+
+#endif /* DSP_KERNEL_INTERNAL_H_ */
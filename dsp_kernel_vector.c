@@ -0,0 +1,585 @@
+// Pithesiser - a software synthesiser for Raspberry Pi
+// Copyright (C) 2015 Nicholas Tuckett
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+/*
+ * dsp_kernel_vector.c
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: ntuckett
+ *
+ *  SIMD kernels written with GCC vector extensions, so the same source becomes SSE2 on x86-64, NEON on AArch64
+ *  and, on x86 CPUs that have it, AVX2 (the bodies are inlined into wrappers built for that target).
+ *
+ *  The biquad is a serial recurrence, so there is nothing to vectorise within one filter; the single filter entries
+ *  use the portable C kernels. Filter banks advance all their lanes together instead, but need a 32x32->64 bit
+ *  signed multiply that GCC won't generate from vector extensions, so those use intrinsics (AVX2 & NEON).
+ *  Wavetable interpolation needs a gather for each tap, so is only vectorised for AVX2.
+ */
+
+#include "dsp_kernel_internal.h"
+#include <string.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#define VECTOR_SAMPLES	8
+
+typedef int32_t	v8si_t __attribute__((vector_size(VECTOR_SAMPLES * sizeof(int32_t))));
+typedef int16_t	v8hi_t __attribute__((vector_size(VECTOR_SAMPLES * sizeof(int16_t))));
+
+static const v8si_t interleave_bus_low = { 0, 8, 1, 9, 2, 10, 3, 11 };
+static const v8si_t interleave_bus_high = { 4, 12, 5, 13, 6, 14, 7, 15 };
+
+// In place, as 32 byte vectors aren't passed by value without AVX.
+static __attribute__((always_inline)) inline void saturate_samples(v8si_t *samples)
+{
+	v8si_t low = *samples < SHRT_MIN;
+	v8si_t high = *samples > SHRT_MAX;
+
+	*samples = (*samples & ~low) | (SHRT_MIN & low);
+	*samples = (*samples & ~high) | (SHRT_MAX & high);
+}
+
+static __attribute__((always_inline)) inline void mixdown_mono_to_bus_body(sample_t *source, int32_t left, int32_t right, int sample_count, bus_sample_t *bus)
+{
+	int i;
+
+	for (i = 0; i + VECTOR_SAMPLES <= sample_count; i += VECTOR_SAMPLES)
+	{
+		v8hi_t mono;
+		v8si_t bus_low, bus_high;
+
+		memcpy(&mono, source + i, sizeof(mono));
+		memcpy(&bus_low, bus + i * 2, sizeof(bus_low));
+		memcpy(&bus_high, bus + i * 2 + VECTOR_SAMPLES, sizeof(bus_high));
+
+		v8si_t samples = __builtin_convertvector(mono, v8si_t);
+		v8si_t left_samples = (samples * left) >> DSP_BUS_PAN_SHIFT;
+		v8si_t right_samples = (samples * right) >> DSP_BUS_PAN_SHIFT;
+
+		bus_low += __builtin_shuffle(left_samples, right_samples, interleave_bus_low);
+		bus_high += __builtin_shuffle(left_samples, right_samples, interleave_bus_high);
+		memcpy(bus + i * 2, &bus_low, sizeof(bus_low));
+		memcpy(bus + i * 2 + VECTOR_SAMPLES, &bus_high, sizeof(bus_high));
+	}
+
+	dsp_mixdown_mono_to_bus_c(source + i, left, right, sample_count - i, bus + i * 2);
+}
+
+static __attribute__((always_inline)) inline void bus_to_stereo_body(bus_sample_t *bus, int sample_count, sample_t *dest)
+{
+	int i;
+
+	// Counted in stereo samples.
+	sample_count *= 2;
+	for (i = 0; i + VECTOR_SAMPLES <= sample_count; i += VECTOR_SAMPLES)
+	{
+		v8si_t samples;
+
+		memcpy(&samples, bus + i, sizeof(samples));
+		samples = (samples + DSP_BUS_ROUNDING) >> MIXER_BUS_PRECISION;
+		saturate_samples(&samples);
+
+		v8hi_t stereo = __builtin_convertvector(samples, v8hi_t);
+		memcpy(dest + i, &stereo, sizeof(stereo));
+	}
+
+	dsp_bus_to_stereo_c(bus + i, (sample_count - i) / 2, dest + i);
+}
+
+//-----------------------------------------------------------------------------------------------------------------------
+// Baseline vector ISA of the target
+//
+#if defined(__aarch64__)
+
+// Lanes are split in two halves of 2, as NEON widening multiplies work on 2 lanes at a time.
+typedef struct neon_coeffs_t
+{
+	int32x2_t	input[3][2];
+	int32x2_t	output[2][2];
+} neon_coeffs_t;
+
+static void load_neon_coeffs(fixed_t input_coeff[3][FILTER_BANK_LANES], fixed_t output_coeff[2][FILTER_BANK_LANES], neon_coeffs_t* coeffs)
+{
+	for (int half = 0; half < 2; half++)
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			coeffs->input[i][half] = vld1_s32(input_coeff[i] + half * 2);
+		}
+		for (int i = 0; i < 2; i++)
+		{
+			coeffs->output[i][half] = vld1_s32(output_coeff[i] + half * 2);
+		}
+	}
+}
+
+static __attribute__((always_inline)) inline int32x2_t neon_filter_sample(const neon_coeffs_t* coeffs, int half, int32x2_t sample, int32x2_t history0, int32x2_t history1, int32x2_t output0, int32x2_t output1)
+{
+	int64x2_t new_sample = vmull_s32(history1, coeffs->input[2][half]);
+	new_sample = vmlal_s32(new_sample, sample, coeffs->input[0][half]);
+	new_sample = vmlal_s32(new_sample, history0, coeffs->input[1][half]);
+	new_sample = vmlal_s32(new_sample, output0, coeffs->output[0][half]);
+	new_sample = vmlal_s32(new_sample, output1, coeffs->output[1][half]);
+
+	return vmovn_s64(vrshrq_n_s64(new_sample, DSP_FILTER_PRECISION));
+}
+
+static void filter_bank_apply_neon(filter_bank_t* bank, int sample_count)
+{
+	neon_coeffs_t coeffs;
+	load_neon_coeffs(bank->input_coeff, bank->output_coeff, &coeffs);
+
+	for (int half = 0; half < 2; half++)
+	{
+		sample_t* sample_data0 = bank->sample_data[half * 2];
+		sample_t* sample_data1 = bank->sample_data[half * 2 + 1];
+		int32x2_t history0 = vld1_s32(bank->history[0] + half * 2);
+		int32x2_t history1 = vld1_s32(bank->history[1] + half * 2);
+		int32x2_t output0 = vld1_s32(bank->output[0] + half * 2);
+		int32x2_t output1 = vld1_s32(bank->output[1] + half * 2);
+
+		for (int i = 0; i < sample_count; i++)
+		{
+			int32x2_t sample = { sample_data0[i], sample_data1[i] };
+			int32x2_t output = neon_filter_sample(&coeffs, half, sample, history0, history1, output0, output1);
+
+			sample_data0[i] = (sample_t)vget_lane_s32(output, 0);
+			sample_data1[i] = (sample_t)vget_lane_s32(output, 1);
+
+			history1 = history0;
+			history0 = sample;
+			output1 = output0;
+			output0 = output;
+		}
+
+		vst1_s32(bank->history[0] + half * 2, history0);
+		vst1_s32(bank->history[1] + half * 2, history1);
+		vst1_s32(bank->output[0] + half * 2, output0);
+		vst1_s32(bank->output[1] + half * 2, output1);
+	}
+}
+
+static __attribute__((always_inline)) inline void neon_ramp_coeffs(neon_coeffs_t* coeffs, const neon_coeffs_t* step, int half)
+{
+	for (int i = 0; i < 3; i++)
+	{
+		coeffs->input[i][half] = vadd_s32(coeffs->input[i][half], step->input[i][half]);
+	}
+	for (int i = 0; i < 2; i++)
+	{
+		coeffs->output[i][half] = vadd_s32(coeffs->output[i][half], step->output[i][half]);
+	}
+}
+
+static void filter_bank_apply_interp_neon(filter_bank_t* bank, int sample_count)
+{
+	fixed_t input_coeff[3][FILTER_BANK_LANES], output_coeff[2][FILTER_BANK_LANES];
+	fixed_t input_step[3][FILTER_BANK_LANES], output_step[2][FILTER_BANK_LANES];
+	neon_coeffs_t coeffs, step;
+
+	dsp_filter_bank_ramp(bank, sample_count, input_coeff, output_coeff, input_step, output_step);
+	load_neon_coeffs(input_coeff, output_coeff, &coeffs);
+	load_neon_coeffs(input_step, output_step, &step);
+
+	for (int half = 0; half < 2; half++)
+	{
+		sample_t* sample_data0 = bank->sample_data[half * 2];
+		sample_t* sample_data1 = bank->sample_data[half * 2 + 1];
+		int32x2_t history0 = vld1_s32(bank->history[0] + half * 2);
+		int32x2_t history1 = vld1_s32(bank->history[1] + half * 2);
+		int32x2_t output0 = vld1_s32(bank->output[0] + half * 2);
+		int32x2_t output1 = vld1_s32(bank->output[1] + half * 2);
+
+		for (int i = 0; i < sample_count; i++)
+		{
+			int32x2_t sample = { sample_data0[i], sample_data1[i] };
+
+			neon_ramp_coeffs(&coeffs, &step, half);
+			int32x2_t output = neon_filter_sample(&coeffs, half, sample, history0, history1, output0, output1);
+
+			sample_data0[i] = (sample_t)vget_lane_s32(output, 0);
+			sample_data1[i] = (sample_t)vget_lane_s32(output, 1);
+
+			history1 = history0;
+			history0 = sample;
+			output1 = output0;
+			output0 = output;
+		}
+
+		vst1_s32(bank->history[0] + half * 2, history0);
+		vst1_s32(bank->history[1] + half * 2, history1);
+		vst1_s32(bank->output[0] + half * 2, output0);
+		vst1_s32(bank->output[1] + half * 2, output1);
+	}
+}
+
+#define filter_bank_apply_vector			filter_bank_apply_neon
+#define filter_bank_apply_interp_vector		filter_bank_apply_interp_neon
+
+#else
+
+#define filter_bank_apply_vector			dsp_filter_bank_apply_c
+#define filter_bank_apply_interp_vector		dsp_filter_bank_apply_interp_c
+
+#endif
+
+static void mixdown_mono_to_bus_vector(sample_t *source, int32_t left, int32_t right, int sample_count, bus_sample_t *bus)
+{
+	mixdown_mono_to_bus_body(source, left, right, sample_count, bus);
+}
+
+static int dsp_kernels_vector_supported()
+{
+	return 1;
+}
+
+const dsp_kernels_t dsp_kernels_vector =
+{
+	"vector",
+	dsp_kernels_vector_supported,
+	dsp_filter_apply_c,
+	dsp_filter_apply_interp_c,
+	filter_bank_apply_vector,
+	filter_bank_apply_interp_vector,
+	mixdown_mono_to_bus_vector,
+	dsp_bus_to_stereo_c,		// Narrowing with saturation is emulated on SSE2, making vectors slower than C.
+	dsp_wavetable_hermite_c,	// Without gathers, taps are loaded lane by lane, making vectors slower than C.
+	dsp_wavetable_polynomial_c,
+	dsp_wavetable_unison_c
+};
+
+//-----------------------------------------------------------------------------------------------------------------------
+// AVX2, selected at runtime
+//
+#if defined(__x86_64__) || defined(__i386__)
+
+// Each lane is held in a 64-bit element. Only the low 32 bits of an element are meaningful, which is all
+// _mm256_mul_epi32 reads; so results can be shifted down logically, there being no 64-bit arithmetic shift.
+typedef struct avx2_coeffs_t
+{
+	__m256i	input[3];
+	__m256i	output[2];
+} avx2_coeffs_t;
+
+static __attribute__((target("avx2"))) inline __m256i avx2_load_lanes(const fixed_t* lanes)
+{
+	return _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i*)lanes));
+}
+
+static __attribute__((target("avx2"))) inline void avx2_store_lanes(fixed_t* lanes, __m256i values)
+{
+	int64_t elements[FILTER_BANK_LANES];
+
+	_mm256_storeu_si256((__m256i*)elements, values);
+	for (int lane = 0; lane < FILTER_BANK_LANES; lane++)
+	{
+		lanes[lane] = (fixed_t)elements[lane];
+	}
+}
+
+static __attribute__((target("avx2"))) inline __m256i avx2_load_samples(sample_t** sample_data, int i)
+{
+	return _mm256_set_epi64x(sample_data[3][i], sample_data[2][i], sample_data[1][i], sample_data[0][i]);
+}
+
+static __attribute__((target("avx2"))) inline void avx2_store_samples(sample_t** sample_data, int i, __m256i samples)
+{
+	int64_t elements[FILTER_BANK_LANES];
+
+	_mm256_storeu_si256((__m256i*)elements, samples);
+	for (int lane = 0; lane < FILTER_BANK_LANES; lane++)
+	{
+		sample_data[lane][i] = (sample_t)elements[lane];
+	}
+}
+
+static __attribute__((target("avx2"))) void avx2_load_coeffs(fixed_t input_coeff[3][FILTER_BANK_LANES], fixed_t output_coeff[2][FILTER_BANK_LANES], avx2_coeffs_t* coeffs)
+{
+	for (int i = 0; i < 3; i++)
+	{
+		coeffs->input[i] = avx2_load_lanes(input_coeff[i]);
+	}
+	for (int i = 0; i < 2; i++)
+	{
+		coeffs->output[i] = avx2_load_lanes(output_coeff[i]);
+	}
+}
+
+static __attribute__((target("avx2"), always_inline)) inline __m256i avx2_filter_sample(const avx2_coeffs_t* coeffs, __m256i sample, __m256i history0, __m256i history1, __m256i output0, __m256i output1)
+{
+	__m256i new_sample = _mm256_mul_epi32(history1, coeffs->input[2]);
+	new_sample = _mm256_add_epi64(new_sample, _mm256_mul_epi32(sample, coeffs->input[0]));
+	new_sample = _mm256_add_epi64(new_sample, _mm256_mul_epi32(history0, coeffs->input[1]));
+	new_sample = _mm256_add_epi64(new_sample, _mm256_mul_epi32(output0, coeffs->output[0]));
+	new_sample = _mm256_add_epi64(new_sample, _mm256_mul_epi32(output1, coeffs->output[1]));
+	new_sample = _mm256_add_epi64(new_sample, _mm256_set1_epi64x(DSP_FILTER_ROUNDING));
+
+	return _mm256_srli_epi64(new_sample, DSP_FILTER_PRECISION);
+}
+
+static __attribute__((target("avx2"))) void filter_bank_apply_avx2(filter_bank_t* bank, int sample_count)
+{
+	avx2_coeffs_t coeffs;
+	avx2_load_coeffs(bank->input_coeff, bank->output_coeff, &coeffs);
+
+	__m256i history0 = avx2_load_lanes(bank->history[0]);
+	__m256i history1 = avx2_load_lanes(bank->history[1]);
+	__m256i output0 = avx2_load_lanes(bank->output[0]);
+	__m256i output1 = avx2_load_lanes(bank->output[1]);
+
+	for (int i = 0; i < sample_count; i++)
+	{
+		__m256i sample = avx2_load_samples(bank->sample_data, i);
+		__m256i output = avx2_filter_sample(&coeffs, sample, history0, history1, output0, output1);
+
+		avx2_store_samples(bank->sample_data, i, output);
+
+		history1 = history0;
+		history0 = sample;
+		output1 = output0;
+		output0 = output;
+	}
+
+	avx2_store_lanes(bank->history[0], history0);
+	avx2_store_lanes(bank->history[1], history1);
+	avx2_store_lanes(bank->output[0], output0);
+	avx2_store_lanes(bank->output[1], output1);
+}
+
+static __attribute__((target("avx2"), always_inline)) inline void avx2_ramp_coeffs(avx2_coeffs_t* coeffs, const avx2_coeffs_t* step)
+{
+	for (int i = 0; i < 3; i++)
+	{
+		coeffs->input[i] = _mm256_add_epi64(coeffs->input[i], step->input[i]);
+	}
+	for (int i = 0; i < 2; i++)
+	{
+		coeffs->output[i] = _mm256_add_epi64(coeffs->output[i], step->output[i]);
+	}
+}
+
+static __attribute__((target("avx2"))) void filter_bank_apply_interp_avx2(filter_bank_t* bank, int sample_count)
+{
+	fixed_t input_coeff[3][FILTER_BANK_LANES], output_coeff[2][FILTER_BANK_LANES];
+	fixed_t input_step[3][FILTER_BANK_LANES], output_step[2][FILTER_BANK_LANES];
+	avx2_coeffs_t coeffs, step;
+
+	dsp_filter_bank_ramp(bank, sample_count, input_coeff, output_coeff, input_step, output_step);
+	avx2_load_coeffs(input_coeff, output_coeff, &coeffs);
+	avx2_load_coeffs(input_step, output_step, &step);
+
+	__m256i history0 = avx2_load_lanes(bank->history[0]);
+	__m256i history1 = avx2_load_lanes(bank->history[1]);
+	__m256i output0 = avx2_load_lanes(bank->output[0]);
+	__m256i output1 = avx2_load_lanes(bank->output[1]);
+
+	for (int i = 0; i < sample_count; i++)
+	{
+		__m256i sample = avx2_load_samples(bank->sample_data, i);
+
+		avx2_ramp_coeffs(&coeffs, &step);
+		__m256i output = avx2_filter_sample(&coeffs, sample, history0, history1, output0, output1);
+
+		avx2_store_samples(bank->sample_data, i, output);
+
+		history1 = history0;
+		history0 = sample;
+		output1 = output0;
+		output0 = output;
+	}
+
+	avx2_store_lanes(bank->history[0], history0);
+	avx2_store_lanes(bank->history[1], history1);
+	avx2_store_lanes(bank->output[0], output0);
+	avx2_store_lanes(bank->output[1], output1);
+}
+
+static __attribute__((target("avx2"))) void mixdown_mono_to_bus_avx2(sample_t *source, int32_t left, int32_t right, int sample_count, bus_sample_t *bus)
+{
+	mixdown_mono_to_bus_body(source, left, right, sample_count, bus);
+}
+
+static __attribute__((target("avx2"))) void bus_to_stereo_avx2(bus_sample_t *bus, int sample_count, sample_t *dest)
+{
+	bus_to_stereo_body(bus, sample_count, dest);
+}
+
+// Gathers read 32 bits, so the low half of each element is the tap and the high half is the next sample.
+static __attribute__((target("avx2"), always_inline)) inline __m256i avx2_gather_taps(const sample_t *table, __m256i index)
+{
+	__m256i taps = _mm256_i32gather_epi32((const int*)table, index, sizeof(sample_t));
+	return _mm256_srai_epi32(_mm256_slli_epi32(taps, 16), 16);
+}
+
+static __attribute__((target("avx2"), always_inline)) inline void avx2_store_wavetable_samples(sample_t *dest, __m256i samples)
+{
+	__m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(samples, samples), 0x08);
+	_mm_storeu_si128((__m128i*)dest, _mm256_castsi256_si128(packed));
+}
+
+static __attribute__((target("avx2"), always_inline)) inline __m256i avx2_horner_step(__m256i value, __m256i x, int precision, __m256i coeff)
+{
+	return _mm256_add_epi32(_mm256_srai_epi32(_mm256_mullo_epi32(value, x), precision), coeff);
+}
+
+static __attribute__((target("avx2"))) void wavetable_hermite_avx2(const sample_t *table, int size_bits, uint32_t phase, uint32_t phase_step, int sample_count, sample_t *dest)
+{
+	int index_shift = 32 - size_bits;
+	__m128i shift = _mm_cvtsi32_si128(index_shift);
+	__m128i fraction_shift = _mm_cvtsi32_si128(index_shift - DSP_HERMITE_PRECISION);
+	__m256i index_mask = _mm256_set1_epi32((1 << size_bits) - 1);
+	__m256i fraction_mask = _mm256_set1_epi32((1 << DSP_HERMITE_PRECISION) - 1);
+	__m256i one = _mm256_set1_epi32(1);
+	__m256i phases = _mm256_add_epi32(_mm256_set1_epi32(phase), _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(phase_step)));
+	__m256i phase_advance = _mm256_set1_epi32(phase_step * VECTOR_SAMPLES);
+	int i;
+
+	for (i = 0; i + VECTOR_SAMPLES <= sample_count; i += VECTOR_SAMPLES)
+	{
+		__m256i index = _mm256_srl_epi32(phases, shift);
+		__m256i x = _mm256_and_si256(_mm256_srl_epi32(phases, fraction_shift), fraction_mask);
+
+		__m256i ym1 = avx2_gather_taps(table, _mm256_and_si256(_mm256_sub_epi32(index, one), index_mask));
+		__m256i y0 = avx2_gather_taps(table, index);
+		__m256i y1 = avx2_gather_taps(table, _mm256_and_si256(_mm256_add_epi32(index, one), index_mask));
+		__m256i y2 = avx2_gather_taps(table, _mm256_and_si256(_mm256_add_epi32(index, _mm256_set1_epi32(2)), index_mask));
+
+		__m256i c1 = _mm256_srai_epi32(_mm256_sub_epi32(y1, ym1), 1);
+		__m256i c2 = _mm256_sub_epi32(ym1, _mm256_srai_epi32(_mm256_mullo_epi32(y0, _mm256_set1_epi32(5)), 1));
+		c2 = _mm256_sub_epi32(_mm256_add_epi32(c2, _mm256_slli_epi32(y1, 1)), _mm256_srai_epi32(y2, 1));
+		__m256i c3 = _mm256_add_epi32(_mm256_srai_epi32(_mm256_sub_epi32(y2, ym1), 1),
+									  _mm256_srai_epi32(_mm256_mullo_epi32(_mm256_sub_epi32(y0, y1), _mm256_set1_epi32(3)), 1));
+
+		__m256i samples = avx2_horner_step(c3, x, DSP_HERMITE_PRECISION, c2);
+		samples = avx2_horner_step(samples, x, DSP_HERMITE_PRECISION, c1);
+		samples = avx2_horner_step(samples, x, DSP_HERMITE_PRECISION, y0);
+
+		avx2_store_wavetable_samples(dest + i, samples);
+		phases = _mm256_add_epi32(phases, phase_advance);
+	}
+
+	dsp_wavetable_hermite_c(table, size_bits, phase + phase_step * i, phase_step, sample_count - i, dest + i);
+}
+
+// Each sample's coefficients are 8 bytes, so two gathers fetch c0 & c1 and c2 & c3.
+static __attribute__((target("avx2"))) void wavetable_polynomial_avx2(const sample_t *coeffs, int size_bits, uint32_t phase, uint32_t phase_step, int sample_count, sample_t *dest)
+{
+	int index_shift = 32 - size_bits;
+	__m128i shift = _mm_cvtsi32_si128(index_shift - 1);
+	__m128i fraction_shift = _mm_cvtsi32_si128(index_shift - DSP_POLY_PRECISION);
+	__m256i index_mask = _mm256_set1_epi32(~1);
+	__m256i fraction_mask = _mm256_set1_epi32((1 << DSP_POLY_PRECISION) - 1);
+	__m256i fraction_offset = _mm256_set1_epi32(1 << (DSP_POLY_PRECISION - 1));
+	__m256i phases = _mm256_add_epi32(_mm256_set1_epi32(phase), _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(phase_step)));
+	__m256i phase_advance = _mm256_set1_epi32(phase_step * VECTOR_SAMPLES);
+	int i;
+
+	for (i = 0; i + VECTOR_SAMPLES <= sample_count; i += VECTOR_SAMPLES)
+	{
+		// Index of the c0 & c1 pair in 32-bit units.
+		__m256i index = _mm256_and_si256(_mm256_srl_epi32(phases, shift), index_mask);
+		__m256i z = _mm256_sub_epi32(_mm256_and_si256(_mm256_srl_epi32(phases, fraction_shift), fraction_mask), fraction_offset);
+
+		__m256i c01 = _mm256_i32gather_epi32((const int*)coeffs, index, 4);
+		__m256i c23 = _mm256_i32gather_epi32((const int*)coeffs + 1, index, 4);
+		__m256i c0 = _mm256_srai_epi32(_mm256_slli_epi32(c01, 16), 16);
+		__m256i c1 = _mm256_srai_epi32(c01, 16);
+		__m256i c2 = _mm256_srai_epi32(_mm256_slli_epi32(c23, 16), 16);
+		__m256i c3 = _mm256_srai_epi32(c23, 16);
+
+		__m256i samples = avx2_horner_step(c3, z, DSP_POLY_PRECISION, c2);
+		samples = avx2_horner_step(samples, z, DSP_POLY_PRECISION, c1);
+		samples = avx2_horner_step(samples, z, DSP_POLY_PRECISION, c0);
+
+		avx2_store_wavetable_samples(dest + i, samples);
+		phases = _mm256_add_epi32(phases, phase_advance);
+	}
+
+	dsp_wavetable_polynomial_c(coeffs, size_bits, phase + phase_step * i, phase_step, sample_count - i, dest + i);
+}
+
+// Eight samples of each oscillator at a time, summed before they are mixed into dest.
+static __attribute__((target("avx2"))) void wavetable_unison_avx2(const sample_t *table, int size_bits, int oscillator_count, uint32_t *phase, const uint32_t *phase_step, const int32_t *level, int sample_count, sample_t *dest)
+{
+	int index_shift = 32 - size_bits;
+	__m128i shift = _mm_cvtsi32_si128(index_shift);
+	__m128i fraction_shift = _mm_cvtsi32_si128(index_shift - DSP_UNISON_PRECISION);
+	__m256i index_mask = _mm256_set1_epi32((1 << size_bits) - 1);
+	__m256i fraction_mask = _mm256_set1_epi32((1 << DSP_UNISON_PRECISION) - 1);
+	__m256i one = _mm256_set1_epi32(1);
+	__m256i phases[DSP_UNISON_MAX_OSCILLATORS];
+	int i;
+
+	for (int osc = 0; osc < oscillator_count; osc++)
+	{
+		phases[osc] = _mm256_add_epi32(_mm256_set1_epi32(phase[osc]), _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(phase_step[osc])));
+	}
+
+	for (i = 0; i + VECTOR_SAMPLES <= sample_count; i += VECTOR_SAMPLES)
+	{
+		__m256i sum = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(dest + i)));
+
+		for (int osc = 0; osc < oscillator_count; osc++)
+		{
+			__m256i index = _mm256_srl_epi32(phases[osc], shift);
+			__m256i x = _mm256_and_si256(_mm256_srl_epi32(phases[osc], fraction_shift), fraction_mask);
+
+			__m256i y0 = avx2_gather_taps(table, index);
+			__m256i y1 = avx2_gather_taps(table, _mm256_and_si256(_mm256_add_epi32(index, one), index_mask));
+
+			__m256i samples = _mm256_add_epi32(y0, _mm256_srai_epi32(_mm256_mullo_epi32(_mm256_sub_epi32(y1, y0), x), DSP_UNISON_PRECISION));
+			sum = _mm256_add_epi32(sum, _mm256_srai_epi32(_mm256_mullo_epi32(samples, _mm256_set1_epi32(level[osc])), DSP_UNISON_PRECISION));
+			phases[osc] = _mm256_add_epi32(phases[osc], _mm256_set1_epi32(phase_step[osc] * VECTOR_SAMPLES));
+		}
+
+		avx2_store_wavetable_samples(dest + i, sum);
+	}
+
+	for (int osc = 0; osc < oscillator_count; osc++)
+	{
+		phase[osc] += phase_step[osc] * i;
+	}
+
+	dsp_wavetable_unison_c(table, size_bits, oscillator_count, phase, phase_step, level, sample_count - i, dest + i);
+}
+
+static int dsp_kernels_avx2_supported()
+{
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+}
+
+const dsp_kernels_t dsp_kernels_avx2 =
+{
+	"avx2",
+	dsp_kernels_avx2_supported,
+	dsp_filter_apply_c,
+	dsp_filter_apply_interp_c,
+	filter_bank_apply_avx2,
+	filter_bank_apply_interp_avx2,
+	mixdown_mono_to_bus_avx2,
+	bus_to_stereo_avx2,
+	wavetable_hermite_avx2,
+	wavetable_polynomial_avx2,
+	wavetable_unison_avx2
+};
+
+#endif
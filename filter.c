@@ -23,10 +23,12 @@
 
 #include "filter.h"
 #include <memory.h>
+#include <math.h>
+#include <stdlib.h>
 #include "fixed_point_math.h"
-
-extern void filter_apply_hp_asm(sample_t *sample_data, int sample_count, filter_state_t *filter_state);
-extern void filter_apply_interp_hp_asm(sample_t *sample_data, int sample_count, filter_state_t *filter_state_current, filter_state_t *filter_state_last);
+#include "dsp_kernel.h"
+#include "dsp_kernel_internal.h"
+#include "filter_modulated.h"
 
 #define FILTER_PRECISION_DELTA  (FIXED_PRECISION - FILTER_FIXED_PRECISION)
 
@@ -43,64 +45,202 @@ static void clear_state(filter_state_t *state)
 	clear_history(state);
 }
 
+// Normalised biquad coefficients, sampled on a grid of log2(frequency) by log2(q) and built once in double precision.
+// LPF input coefficients are { lpf, 2 * lpf, lpf }, HPF are { hpf, -2 * hpf, hpf } and both share the outputs.
+// Bilinear interpolation keeps every coefficient within 0.0015 of its exact value - tighter than CORDIC managed.
+#define FILTER_TABLE_FREQUENCY_STEPS_PER_OCTAVE	32
+#define FILTER_TABLE_FREQUENCY_OCTAVES			10
+#define FILTER_TABLE_Q_STEPS_PER_OCTAVE			4
+#define FILTER_TABLE_Q_OCTAVES					7
+#define FILTER_TABLE_FREQUENCY_SIZE				(FILTER_TABLE_FREQUENCY_STEPS_PER_OCTAVE * FILTER_TABLE_FREQUENCY_OCTAVES + 1)
+#define FILTER_TABLE_Q_SIZE						(FILTER_TABLE_Q_STEPS_PER_OCTAVE * FILTER_TABLE_Q_OCTAVES + 1)
+#define FILTER_TABLE_WEIGHT_PRECISION			16
+
+typedef struct filter_coeffs_t
+{
+	fixed_t lpf_input;
+	fixed_t hpf_input;
+	fixed_t output[2];
+} filter_coeffs_t;
+
+static filter_coeffs_t filter_table[FILTER_TABLE_FREQUENCY_SIZE][FILTER_TABLE_Q_SIZE];
+
+// Cutoff coefficients for the modulated filters, on the same frequency grid.
+static fixed_t svf_cutoff_table[FILTER_TABLE_FREQUENCY_SIZE];
+static fixed_t ladder_cutoff_table[FILTER_TABLE_FREQUENCY_SIZE];
+static fixed_t filter_table_min_frequency_log2;
+static fixed_t filter_table_min_q_log2;
+static int filter_table_initialised = 0;
+
+static fixed_t to_fixed(double value)
+{
+	return (fixed_t)lround(value * FIXED_ONE);
+}
+
+static void initialise_filter_table()
+{
+	if (filter_table_initialised)
+	{
+		return;
+	}
+
+	filter_table_min_frequency_log2 = fixed_log2_at(FILTER_MIN_FREQUENCY, FILTER_FIXED_PRECISION);
+	filter_table_min_q_log2 = fixed_log2(FILTER_MIN_Q);
+
+	for (int f = 0; f < FILTER_TABLE_FREQUENCY_SIZE; f++)
+	{
+		double frequency_log2 = (double)filter_table_min_frequency_log2 / FIXED_ONE + (double)f / FILTER_TABLE_FREQUENCY_STEPS_PER_OCTAVE;
+		double w0 = 2.0 * M_PI * pow(2.0, frequency_log2) / SYSTEM_SAMPLE_RATE;
+		double cos_w0 = cos(w0);
+		double sin_w0 = sin(w0);
+
+		svf_cutoff_table[f] = to_fixed(fmin(2.0 * sin(w0 / (2.0 * FILTER_SVF_OVERSAMPLING)), FILTER_SVF_MAX_CUTOFF));
+		ladder_cutoff_table[f] = to_fixed(1.0 - exp(-w0));
+
+		for (int q = 0; q < FILTER_TABLE_Q_SIZE; q++)
+		{
+			double q_log2 = (double)filter_table_min_q_log2 / FIXED_ONE + (double)q / FILTER_TABLE_Q_STEPS_PER_OCTAVE;
+			double alpha = sin_w0 / (2.0 * pow(2.0, q_log2));
+			double a0 = 1.0 + alpha;
+			filter_coeffs_t *coeffs = &filter_table[f][q];
+
+			coeffs->lpf_input = to_fixed((1.0 - cos_w0) * 0.5 / a0);
+			coeffs->hpf_input = to_fixed((1.0 + cos_w0) * 0.5 / a0);
+			coeffs->output[0] = to_fixed(2.0 * cos_w0 / a0);
+			coeffs->output[1] = to_fixed(-(1.0 - alpha) / a0);
+		}
+	}
+
+	filter_table_initialised = 1;
+}
+
+static int table_position(fixed_t value_log2, fixed_t min_log2, int steps_per_octave, int size, int *weight)
+{
+	fixed_t position = (value_log2 - min_log2) * steps_per_octave;
+	int index = position >> FIXED_PRECISION;
+
+	if (index < 0)
+	{
+		*weight = 0;
+		return 0;
+	}
+	else if (index >= size - 1)
+	{
+		*weight = 1 << FILTER_TABLE_WEIGHT_PRECISION;
+		return size - 2;
+	}
+
+	*weight = (position & (FIXED_ONE - 1)) >> (FIXED_PRECISION - FILTER_TABLE_WEIGHT_PRECISION);
+	return index;
+}
+
+static inline fixed_t lerp(fixed_t a, fixed_t b, int weight)
+{
+	return a + (fixed_t)(((int64_t)(b - a) * weight) >> FILTER_TABLE_WEIGHT_PRECISION);
+}
+
+static inline fixed_t bilerp(const fixed_t *c00, const fixed_t *c01, const fixed_t *c10, const fixed_t *c11, int frequency_weight, int q_weight)
+{
+	return lerp(lerp(*c00, *c01, q_weight), lerp(*c10, *c11, q_weight), frequency_weight);
+}
+
+// Cutoff & resonance coefficients for the modulated filter types, to be given a sample at a time to filter_apply_modulated.
+// Usable once any filter has been initialised.
+fixed_t filter_cutoff_coeff(int type, fixed_t frequency)
+{
+	const fixed_t *table = (type == FILTER_LADDER) ? ladder_cutoff_table : svf_cutoff_table;
+	int weight;
+	int f = table_position(fixed_log2_at(frequency, FILTER_FIXED_PRECISION), filter_table_min_frequency_log2,
+							FILTER_TABLE_FREQUENCY_STEPS_PER_OCTAVE, FILTER_TABLE_FREQUENCY_SIZE, &weight);
+
+	return lerp(table[f], table[f + 1], weight);
+}
+
+fixed_t filter_resonance_coeff(int type, fixed_t q)
+{
+	static const fixed_t svf_max_damping = DOUBLE_TO_FIXED(FILTER_SVF_MAX_DAMPING);
+	static const fixed_t svf_damping_range = DOUBLE_TO_FIXED((FILTER_SVF_MAX_DAMPING - FILTER_SVF_MIN_DAMPING));
+	static const fixed_t ladder_max_feedback = DOUBLE_TO_FIXED(FILTER_LADDER_MAX_FEEDBACK);
+
+	fixed_t resonance;
+
+	if (q <= FILTER_MIN_Q)
+	{
+		resonance = 0;
+	}
+	else if (q >= FILTER_MAX_Q)
+	{
+		resonance = FIXED_ONE;
+	}
+	else
+	{
+		resonance = (fixed_t)(((int64_t)(q - FILTER_MIN_Q) << FIXED_PRECISION) / (FILTER_MAX_Q - FILTER_MIN_Q));
+	}
+
+	if (type == FILTER_LADDER)
+	{
+		return fixed_mul(ladder_max_feedback, resonance);
+	}
+	else
+	{
+		return svf_max_damping - fixed_mul(svf_damping_range, resonance);
+	}
+}
+
+static void clear_modulated_state(filter_modulated_state_t *state)
+{
+	memset(state->stage, 0, sizeof(state->stage));
+}
+
 void filter_init(filter_t *filter)
 {
+	initialise_filter_table();
 	filter->definition.type = FILTER_PASS;
 	clear_state(&filter->state);
 	clear_state(&filter->last_state);
+	memset(&filter->modulated, 0, sizeof(filter->modulated));
+	filter->cutoff = 0;
+	filter->resonance = 0;
+	filter->last_type = FILTER_PASS;
 	filter->updated = 0;
 }
 
-void filter_update(filter_t *filter)
+// A modulated filter that stays the same type ramps from the coefficients it last ran at to the new ones.
+// On changing type, it starts from rest at the new coefficients.
+static void filter_update_modulated(filter_t *filter)
 {
-	fixed_wide_t w0 = fixed_mul_wide(FIXED_PI, ((fixed_wide_t)filter->definition.frequency) << FILTER_PRECISION_DELTA);
-	w0 = (w0 + w0) / SYSTEM_SAMPLE_RATE;
-	fixed_t cos_w0, sin_w0;
+	filter->cutoff = filter_cutoff_coeff(filter->definition.type, filter->definition.frequency);
+	filter->resonance = filter_resonance_coeff(filter->definition.type, filter->definition.q);
 
-	fixed_sin_cos((fixed_t)w0, &sin_w0, &cos_w0);
-
-	fixed_wide_t q = filter->definition.q;
-	fixed_wide_t alpha	= fixed_divide_wide(sin_w0, q * 2);
+	if (filter->definition.type != filter->last_type)
+	{
+		filter->last_type = filter->definition.type;
+		clear_modulated_state(&filter->modulated);
+		filter->modulated.cutoff = filter->cutoff;
+		filter->modulated.resonance = filter->resonance;
+	}
 
-	fixed_wide_t a[3];
-	fixed_wide_t b[3];
+	filter->updated = 0;
+}
 
-	switch(filter->definition.type)
+void filter_update(filter_t *filter)
+{
+	if (FILTER_IS_MODULATED(filter->definition.type))
 	{
-		case FILTER_LPF:
-		{
-			fixed_wide_t tmp = FIXED_ONE - cos_w0;
-			b[0] = tmp >> 1;
-			b[1] = tmp;
-			b[2] = tmp >> 1;
-
-			a[0] = FIXED_ONE + alpha;
-			a[1] = -2 * cos_w0;
-			a[2] = FIXED_ONE - alpha;
-			break;
-		}
+		filter_update_modulated(filter);
+		return;
+	}
 
-		case FILTER_HPF:
-		{
-			fixed_wide_t tmp = FIXED_ONE + cos_w0;
-			b[0] = tmp >> 1;
-			b[1] = -tmp;
-			b[2] = tmp >> 1;
-
-			a[0] = FIXED_ONE + alpha;
-			a[1] = -2 * cos_w0;
-			a[2] = FIXED_ONE - alpha;
-			break;
-		}
+	int frequency_weight, q_weight;
+	int f = table_position(fixed_log2_at(filter->definition.frequency, FILTER_FIXED_PRECISION), filter_table_min_frequency_log2,
+							FILTER_TABLE_FREQUENCY_STEPS_PER_OCTAVE, FILTER_TABLE_FREQUENCY_SIZE, &frequency_weight);
+	int q = table_position(fixed_log2(filter->definition.q), filter_table_min_q_log2,
+							FILTER_TABLE_Q_STEPS_PER_OCTAVE, FILTER_TABLE_Q_SIZE, &q_weight);
 
-		default:
-		{
-			b[0] = a[0] = FIXED_ONE;
-			a[1] = a[2] = 0;
-			b[1] = b[2] = 0;
-			break;
-		}
-	}
+	const filter_coeffs_t *c00 = &filter_table[f][q];
+	const filter_coeffs_t *c01 = &filter_table[f][q + 1];
+	const filter_coeffs_t *c10 = &filter_table[f + 1][q];
+	const filter_coeffs_t *c11 = &filter_table[f + 1][q + 1];
 
 	if (filter->definition.type == filter->last_type)
 	{
@@ -114,41 +254,98 @@ void filter_update(filter_t *filter)
 	}
 	clear_state(&filter->state);
 
-	filter->state.input_coeff[0] = fixed_divide_wide(b[0], a[0]);
-	filter->state.input_coeff[1] = fixed_divide_wide(b[1], a[0]);
-	filter->state.input_coeff[2] = fixed_divide_wide(b[2], a[0]);
+	switch(filter->definition.type)
+	{
+		case FILTER_LPF:
+		case FILTER_HPF:
+		{
+			fixed_t input;
+			if (filter->definition.type == FILTER_LPF)
+			{
+				input = bilerp(&c00->lpf_input, &c01->lpf_input, &c10->lpf_input, &c11->lpf_input, frequency_weight, q_weight);
+				filter->state.input_coeff[1] = input * 2;
+			}
+			else
+			{
+				input = bilerp(&c00->hpf_input, &c01->hpf_input, &c10->hpf_input, &c11->hpf_input, frequency_weight, q_weight);
+				filter->state.input_coeff[1] = input * -2;
+			}
+			filter->state.input_coeff[0] = input;
+			filter->state.input_coeff[2] = input;
 
-	filter->state.output_coeff[0] = -fixed_divide_wide(a[1], a[0]);
-	filter->state.output_coeff[1] = -fixed_divide_wide(a[2], a[0]);
+			filter->state.output_coeff[0] = bilerp(&c00->output[0], &c01->output[0], &c10->output[0], &c11->output[0], frequency_weight, q_weight);
+			filter->state.output_coeff[1] = bilerp(&c00->output[1], &c01->output[1], &c10->output[1], &c11->output[1], frequency_weight, q_weight);
+			break;
+		}
 
-//	printf("%9.03f -> I: %08x %08x %08x  O: %08x %08x\n", (float)filter->definition.frequency / (float)FILTER_FIXED_ONE,
-//			filter->state.input_coeff[0], filter->state.input_coeff[1], filter->state.input_coeff[2],
-//			filter->state.output_coeff[0], filter->state.output_coeff[1]);
+		default:
+		{
+			filter->state.input_coeff[0] = FIXED_ONE;
+			break;
+		}
+	}
 }
 
 void filter_silence(filter_t *filter)
 {
 	clear_history(&filter->state);
-	filter->last_type = FILTER_PASS;	// Avoid interpolation on next non-silence when params updated.
+	clear_modulated_state(&filter->modulated);
+	filter->last_type = FILTER_PASS;	// Avoid ramping coefficients on next non-silence when params updated.
+}
+
+// Cutoff & resonance hold a coefficient per sample, from filter_cutoff_coeff & filter_resonance_coeff for the filter's type.
+void filter_apply_modulated(filter_t *filter, sample_t *sample_data, int sample_count, const fixed_t *cutoff, const fixed_t *resonance)
+{
+	static const filter_modulated_kernel_t kernels[] =
+	{
+		filter_svf_lpf_apply,
+		filter_svf_bpf_apply,
+		filter_svf_hpf_apply,
+		filter_ladder_apply
+	};
+
+	kernels[filter->definition.type - FILTER_SVF_LPF](sample_data, sample_count, &filter->modulated, cutoff, resonance);
+}
+
+// Ramps as the biquad kernels ramp their coefficients, one step before each sample.
+static void ramp_coeff(fixed_t last, fixed_t current, int sample_count, fixed_t *ramp)
+{
+	fixed_t coeff, step;
+	dsp_ramp_coeff(last, current, sample_count, &coeff, &step);
+
+	for (int i = 0; i < sample_count; i++)
+	{
+		coeff += step;
+		ramp[i] = coeff;
+	}
 }
 
 void filter_apply(filter_t *filter, sample_t *sample_data, int sample_count)
 {
-	if (filter->definition.type != FILTER_PASS)
+	if (FILTER_IS_MODULATED(filter->definition.type))
+	{
+		fixed_t *cutoff = (fixed_t*)alloca(sample_count * sizeof(fixed_t));
+		fixed_t *resonance = (fixed_t*)alloca(sample_count * sizeof(fixed_t));
+
+		ramp_coeff(filter->modulated.cutoff, filter->cutoff, sample_count, cutoff);
+		ramp_coeff(filter->modulated.resonance, filter->resonance, sample_count, resonance);
+		filter_apply_modulated(filter, sample_data, sample_count, cutoff, resonance);
+	}
+	else if (filter->definition.type != FILTER_PASS)
 	{
 		if (filter->updated)
 		{
-			filter_apply_interp_hp_asm(sample_data, sample_count, &filter->state, &filter->last_state);
+			dsp_kernels->filter_apply_interp(sample_data, sample_count, &filter->state, &filter->last_state);
 			filter->updated = 0;
 		}
 		else
 		{
-			filter_apply_hp_asm(sample_data, sample_count, &filter->state);
+			dsp_kernels->filter_apply(sample_data, sample_count, &filter->state);
 		}
 	}
 	else
 	{
-		int last_sample_index = (sample_count - 1) * 2;
+		int last_sample_index = sample_count - 1;
 		fixed_t sample = (fixed_t)sample_data[last_sample_index];
 
 		filter->state.history[1] = filter->state.history[0];
@@ -29,6 +29,14 @@
 #define FILTER_PASS	0
 #define FILTER_LPF	1
 #define FILTER_HPF	2
+#define FILTER_SVF_LPF	3
+#define FILTER_SVF_BPF	4
+#define FILTER_SVF_HPF	5
+#define FILTER_LADDER	6
+
+// State variable & ladder filters take their cutoff and resonance a sample at a time, so are safe to modulate at audio rate.
+// For these, q is a resonance amount: FILTER_MIN_Q is none and FILTER_MAX_Q is at (ladder) or near (SVF) self oscillation.
+#define FILTER_IS_MODULATED(type)	((type) >= FILTER_SVF_LPF)
 
 #define FILTER_FIXED_PRECISION	14
 #define FILTER_FIXED_ONE		(1 << FILTER_FIXED_PRECISION)
@@ -37,7 +45,7 @@
 #define FILTER_MAX_Q			(FIXED_ONE)
 
 #define FILTER_STATE_OFF		FILTER_PASS
-#define FILTER_STATE_LAST		FILTER_HPF
+#define FILTER_STATE_LAST		FILTER_LADDER
 #define FILTER_MIN_FREQUENCY	(FILTER_FIXED_ONE * 20)
 #define FILTER_MAX_FREQUENCY	(18000 * FILTER_FIXED_ONE)
 
@@ -57,19 +65,36 @@ typedef struct filter_state_t
 	fixed_t output[2];
 } filter_state_t;
 
+// Per-sample cutoff & resonance coefficients are at FIXED_PRECISION, stages at FILTER_MODULATED_PRECISION.
+// The coefficients are those of the last sample filtered.
+#define FILTER_MODULATED_PRECISION	8
+
+typedef struct filter_modulated_state_t
+{
+	fixed_t cutoff;
+	fixed_t resonance;
+	fixed_t stage[4];
+} filter_modulated_state_t;
+
 typedef struct filter_t
 {
-	filter_definition_t	definition;
-	int					updated;
-	filter_state_t		state;
-	int					last_type;
-	filter_state_t		last_state;
+	filter_definition_t			definition;
+	int							updated;
+	filter_state_t				state;
+	int							last_type;
+	filter_state_t				last_state;
+	filter_modulated_state_t	modulated;
+	fixed_t						cutoff;			// Coefficients for the definition, which filter_apply ramps to from
+	fixed_t						resonance;		// those the modulated state last ran at.
 } filter_t;
 
 extern void filter_init(filter_t *filter);
 extern void filter_update(filter_t *filter);
 extern void filter_silence(filter_t *filter);
 extern void filter_apply(filter_t *filter, sample_t *sample_data, int sample_count);
+extern fixed_t filter_cutoff_coeff(int type, fixed_t frequency);
+extern fixed_t filter_resonance_coeff(int type, fixed_t q);
+extern void filter_apply_modulated(filter_t *filter, sample_t *sample_data, int sample_count, const fixed_t *cutoff, const fixed_t *resonance);
 extern int filter_definitions_same(filter_definition_t *definition1, filter_definition_t *definition2);
 
 #endif /* FILTER_H_ */
@@ -0,0 +1,108 @@
+// Pithesiser - a software synthesiser for Raspberry Pi
+// Copyright (C) 2015 Nicholas Tuckett
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+/*
+ * filter_bank.c
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: ntuckett
+ */
+
+#include "filter_bank.h"
+#include <memory.h>
+#include "dsp_kernel.h"
+
+// Lane buffers are sample_count samples each, one after the other.
+void filter_bank_init(filter_bank_t* bank, sample_t* lane_buffers, int sample_count)
+{
+	memset(bank, 0, sizeof(filter_bank_t));
+
+	for (int lane = 0; lane < FILTER_BANK_LANES; lane++)
+	{
+		bank->input_coeff[0][lane] = FIXED_ONE;
+		bank->last_input_coeff[0][lane] = FIXED_ONE;
+		bank->sample_data[lane] = lane_buffers + lane * sample_count;
+	}
+}
+
+// The filter must not be a pass filter, which is handled by filter_apply on its own.
+void filter_bank_set_lane(filter_bank_t* bank, int lane, filter_t* filter)
+{
+	filter_state_t* state = &filter->state;
+
+	for (int i = 0; i < 3; i++)
+	{
+		bank->input_coeff[i][lane] = state->input_coeff[i];
+	}
+
+	for (int i = 0; i < 2; i++)
+	{
+		bank->output_coeff[i][lane] = state->output_coeff[i];
+	}
+
+	// An updated filter ramps from its last state, whose history is carried over.
+	// Others ramp from their current state to itself, which gives the same samples as not ramping.
+	filter_state_t* last_state = filter->updated ? &filter->last_state : state;
+
+	for (int i = 0; i < 3; i++)
+	{
+		bank->last_input_coeff[i][lane] = last_state->input_coeff[i];
+	}
+
+	for (int i = 0; i < 2; i++)
+	{
+		bank->last_output_coeff[i][lane] = last_state->output_coeff[i];
+		bank->history[i][lane] = last_state->history[i];
+		bank->output[i][lane] = last_state->output[i];
+	}
+
+	bank->updated |= filter->updated;
+	bank->filter[lane] = filter;
+	bank->filter_count++;
+}
+
+void filter_bank_apply(filter_bank_t* bank, int sample_count)
+{
+	if (bank->filter_count == 0)
+	{
+		return;
+	}
+
+	if (bank->updated)
+	{
+		dsp_kernels->filter_bank_apply_interp(bank, sample_count);
+	}
+	else
+	{
+		dsp_kernels->filter_bank_apply(bank, sample_count);
+	}
+
+	for (int lane = 0; lane < FILTER_BANK_LANES; lane++)
+	{
+		filter_t* filter = bank->filter[lane];
+
+		if (filter != NULL)
+		{
+			for (int i = 0; i < 2; i++)
+			{
+				filter->state.history[i] = bank->history[i][lane];
+				filter->state.output[i] = bank->output[i][lane];
+			}
+			filter->updated = 0;
+		}
+	}
+}
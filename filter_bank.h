@@ -0,0 +1,60 @@
+// Pithesiser - a software synthesiser for Raspberry Pi
+// Copyright (C) 2015 Nicholas Tuckett
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+/*
+ * filter_bank.h
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: ntuckett
+ *
+ *  Groups of filters laid out structure-of-arrays, one filter per lane, so a SIMD kernel can advance
+ *  every lane's biquad with each instruction.
+ *
+ *  Filters keep their state in filter_t between buffers; a bank is loaded from them, applied, and
+ *  the results stored back, which costs a handful of loads & stores per filter per buffer.
+ *  Lanes without a filter are set to pass samples through unchanged.
+ */
+
+#ifndef FILTER_BANK_H_
+#define FILTER_BANK_H_
+
+#include "filter.h"
+
+#define FILTER_BANK_LANES	4
+
+typedef struct filter_bank_t
+{
+	fixed_t		input_coeff[3][FILTER_BANK_LANES];
+	fixed_t		output_coeff[2][FILTER_BANK_LANES];
+	fixed_t		history[2][FILTER_BANK_LANES];
+	fixed_t		output[2][FILTER_BANK_LANES];
+
+	// Only used when ramping from updated coefficients.
+	fixed_t		last_input_coeff[3][FILTER_BANK_LANES];
+	fixed_t		last_output_coeff[2][FILTER_BANK_LANES];
+
+	sample_t*	sample_data[FILTER_BANK_LANES];
+	filter_t*	filter[FILTER_BANK_LANES];
+	int			filter_count;
+	int			updated;
+} filter_bank_t;
+
+extern void filter_bank_init(filter_bank_t* bank, sample_t* lane_buffers, int sample_count);
+extern void filter_bank_set_lane(filter_bank_t* bank, int lane, filter_t* filter);
+extern void filter_bank_apply(filter_bank_t* bank, int sample_count);
+
+#endif /* FILTER_BANK_H_ */
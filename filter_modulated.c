@@ -0,0 +1,138 @@
+// Pithesiser - a software synthesiser for Raspberry Pi
+// Copyright (C) 2015 Nicholas Tuckett
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+/*
+ * filter_modulated.c
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: ntuckett
+ */
+
+#include "filter_modulated.h"
+#include "dsp_kernel_internal.h"
+
+#define SVF_OUTPUT_LOW		0
+#define SVF_OUTPUT_BAND		1
+#define SVF_OUTPUT_HIGH		2
+
+#define STAGE_ROUNDING		(1 << (FILTER_MODULATED_PRECISION - 1))
+#define LADDER_CLIP			(SAMPLE_MAX << FILTER_MODULATED_PRECISION)
+
+static inline fixed_t coeff_mul(fixed_t coeff, fixed_t value)
+{
+	return (fixed_t)(((int64_t)coeff * value) >> FIXED_PRECISION);
+}
+
+static inline sample_t stage_to_sample(fixed_t stage)
+{
+	return dsp_saturate_sample((stage + STAGE_ROUNDING) >> FILTER_MODULATED_PRECISION);
+}
+
+// Instantiated once per output, so the output selection folds away.
+static __attribute__((always_inline)) inline void svf_apply(sample_t *sample_data, int sample_count, filter_modulated_state_t *state,
+															const fixed_t *cutoff, const fixed_t *resonance, int output)
+{
+	fixed_t low = state->stage[0];
+	fixed_t band = state->stage[1];
+	fixed_t high = state->stage[2];
+
+	for (int i = 0; i < sample_count; i++)
+	{
+		fixed_t input = (fixed_t)sample_data[i] << FILTER_MODULATED_PRECISION;
+		fixed_t f = cutoff[i];
+		fixed_t d = resonance[i];
+
+		for (int pass = 0; pass < FILTER_SVF_OVERSAMPLING; pass++)
+		{
+			low += coeff_mul(f, band);
+			high = input - low - coeff_mul(d, band);
+			band += coeff_mul(f, high);
+		}
+
+		if (output == SVF_OUTPUT_LOW)
+		{
+			sample_data[i] = stage_to_sample(low);
+		}
+		else if (output == SVF_OUTPUT_BAND)
+		{
+			sample_data[i] = stage_to_sample(band);
+		}
+		else
+		{
+			sample_data[i] = stage_to_sample(high);
+		}
+	}
+
+	state->stage[0] = low;
+	state->stage[1] = band;
+	state->stage[2] = high;
+	state->cutoff = cutoff[sample_count - 1];
+	state->resonance = resonance[sample_count - 1];
+}
+
+void filter_svf_lpf_apply(sample_t *sample_data, int sample_count, filter_modulated_state_t *state, const fixed_t *cutoff, const fixed_t *resonance)
+{
+	svf_apply(sample_data, sample_count, state, cutoff, resonance, SVF_OUTPUT_LOW);
+}
+
+void filter_svf_bpf_apply(sample_t *sample_data, int sample_count, filter_modulated_state_t *state, const fixed_t *cutoff, const fixed_t *resonance)
+{
+	svf_apply(sample_data, sample_count, state, cutoff, resonance, SVF_OUTPUT_BAND);
+}
+
+void filter_svf_hpf_apply(sample_t *sample_data, int sample_count, filter_modulated_state_t *state, const fixed_t *cutoff, const fixed_t *resonance)
+{
+	svf_apply(sample_data, sample_count, state, cutoff, resonance, SVF_OUTPUT_HIGH);
+}
+
+void filter_ladder_apply(sample_t *sample_data, int sample_count, filter_modulated_state_t *state, const fixed_t *cutoff, const fixed_t *resonance)
+{
+	fixed_t stage0 = state->stage[0];
+	fixed_t stage1 = state->stage[1];
+	fixed_t stage2 = state->stage[2];
+	fixed_t stage3 = state->stage[3];
+
+	for (int i = 0; i < sample_count; i++)
+	{
+		fixed_t g = cutoff[i];
+		fixed_t input = ((fixed_t)sample_data[i] << FILTER_MODULATED_PRECISION) - coeff_mul(resonance[i], stage3);
+
+		if (input > LADDER_CLIP)
+		{
+			input = LADDER_CLIP;
+		}
+		else if (input < -LADDER_CLIP)
+		{
+			input = -LADDER_CLIP;
+		}
+
+		stage0 += coeff_mul(g, input - stage0);
+		stage1 += coeff_mul(g, stage0 - stage1);
+		stage2 += coeff_mul(g, stage1 - stage2);
+		stage3 += coeff_mul(g, stage2 - stage3);
+
+		sample_data[i] = stage_to_sample(stage3);
+	}
+
+	state->stage[0] = stage0;
+	state->stage[1] = stage1;
+	state->stage[2] = stage2;
+	state->stage[3] = stage3;
+	state->cutoff = cutoff[sample_count - 1];
+	state->resonance = resonance[sample_count - 1];
+}
@@ -0,0 +1,52 @@
+// Pithesiser - a software synthesiser for Raspberry Pi
+// Copyright (C) 2015 Nicholas Tuckett
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+/*
+ * filter_modulated.h
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: ntuckett
+ *
+ *  State variable & 4 pole ladder filter kernels, taking a cutoff & resonance coefficient for every sample.
+ *  Neither keeps anything derived from its coefficients between samples, so they can be modulated at audio rate
+ *  with no ramping or recalculation.
+ *
+ *  The SVF is a Chamberlin filter run twice per sample. It is stable for cutoff f & damping d when f^2 + 2fd < 4,
+ *  which the coefficient limits below keep to, so cutoff tops out at around 11.5kHz.
+ *  The ladder is four one pole lowpass stages with the output fed back to the input, which is clipped; as each
+ *  stage is a weighted average of its input & last output, it is bounded at any cutoff & resonance.
+ */
+
+#ifndef FILTER_MODULATED_H_
+#define FILTER_MODULATED_H_
+
+#include "filter.h"
+
+#define FILTER_SVF_OVERSAMPLING		2
+#define FILTER_SVF_MAX_CUTOFF		0.8
+#define FILTER_SVF_MIN_DAMPING		0.05
+#define FILTER_SVF_MAX_DAMPING		2.0
+#define FILTER_LADDER_MAX_FEEDBACK	4.0
+
+typedef void (*filter_modulated_kernel_t)(sample_t *sample_data, int sample_count, filter_modulated_state_t *state, const fixed_t *cutoff, const fixed_t *resonance);
+
+extern void filter_svf_lpf_apply(sample_t *sample_data, int sample_count, filter_modulated_state_t *state, const fixed_t *cutoff, const fixed_t *resonance);
+extern void filter_svf_bpf_apply(sample_t *sample_data, int sample_count, filter_modulated_state_t *state, const fixed_t *cutoff, const fixed_t *resonance);
+extern void filter_svf_hpf_apply(sample_t *sample_data, int sample_count, filter_modulated_state_t *state, const fixed_t *cutoff, const fixed_t *resonance);
+extern void filter_ladder_apply(sample_t *sample_data, int sample_count, filter_modulated_state_t *state, const fixed_t *cutoff, const fixed_t *resonance);
+
+#endif /* FILTER_MODULATED_H_ */
@@ -25,6 +25,7 @@
 
 #include "fixed_point_math.h"
 #include <math.h>
+#include <stdint.h>
 
 fixed_t const FIXED_PI		= DOUBLE_TO_FIXED(M_PI);
 fixed_t const FIXED_2_PI	= DOUBLE_TO_FIXED(M_PI * 2.0);
@@ -67,6 +68,54 @@ const fixed_wide_t arctantab[32] = {
 	DOUBLE_TO_FIXED(0.000000001)
 };
 
+// 2^(i / 64) for i = 0..64, at 30 bits precision.
+#define EXP2_TABLE_BITS			6
+#define EXP2_TABLE_PRECISION	30
+
+static const uint32_t exp2_table[(1 << EXP2_TABLE_BITS) + 1] = {
+	0x40000000, 0x40b268fa, 0x4166c34c, 0x421d1462,
+	0x42d561b4, 0x438fb0cb, 0x444c0740, 0x450a6abb,
+	0x45cae0f2, 0x468d6fae, 0x47521cc6, 0x4818ee22,
+	0x48e1e9ba, 0x49ad1598, 0x4a7a77d4, 0x4b4a169c,
+	0x4c1bf829, 0x4cf022ca, 0x4dc69cdd, 0x4e9f6cd4,
+	0x4f7a9930, 0x50582888, 0x51382182, 0x521a8ad7,
+	0x52ff6b55, 0x53e6c9da, 0x54d0ad5a, 0x55bd1cdb,
+	0x56ac1f75, 0x579dbc57, 0x5891fac1, 0x5988e209,
+	0x5a82799a, 0x5b7ec8f2, 0x5c7dd7a4, 0x5d7fad59,
+	0x5e8451d0, 0x5f8bccdb, 0x60962665, 0x61a3666d,
+	0x62b39509, 0x63c6ba64, 0x64dcdec3, 0x65f60a7f,
+	0x6712460b, 0x683199ed, 0x69540ec9, 0x6a79ad56,
+	0x6ba27e65, 0x6cce8ae1, 0x6dfddbcc, 0x6f307a41,
+	0x70666f76, 0x719fc4b9, 0x72dc8374, 0x741cb528,
+	0x75606374, 0x76a7980f, 0x77f25cce, 0x7940bb9e,
+	0x7a92be8b, 0x7be86fba, 0x7d41d96e, 0x7e9f0606,
+	0x80000000
+};
+
+// log2(1 + i / 64) for i = 0..64, at 30 bits precision.
+#define LOG2_TABLE_BITS			6
+#define LOG2_TABLE_PRECISION	30
+
+static const uint32_t log2_table[(1 << LOG2_TABLE_BITS) + 1] = {
+	0x00000000, 0x016e7968, 0x02d75a6f, 0x043ace28,
+	0x0598fdbf, 0x06f21090, 0x08462c46, 0x099574f1,
+	0x0ae00d1d, 0x0c2615e8, 0x0d67af17, 0x0ea4f726,
+	0x0fde0b5d, 0x111307db, 0x124407ab, 0x137124cf,
+	0x149a784c, 0x15c01a3a, 0x16e221ce, 0x1800a563,
+	0x191bba89, 0x1a33760a, 0x1b47ebf7, 0x1c592fad,
+	0x1d6753e0, 0x1e726aa2, 0x1f7a8569, 0x207fb517,
+	0x21820a02, 0x228193f5, 0x237e623d, 0x247883a8,
+	0x2570068e, 0x2664f8d5, 0x275767f5, 0x284760fd,
+	0x2934f098, 0x2a20230e, 0x2b09044d, 0x2bef9fe8,
+	0x2cd4011d, 0x2db632d5, 0x2e963fad, 0x2f7431f2,
+	0x305013ab, 0x3129ee96, 0x3201cc2c, 0x32d7b5a5,
+	0x33abb3fb, 0x347dcfe7, 0x354e11eb, 0x361c824d,
+	0x36e9291f, 0x37b40e3a, 0x387d3946, 0x3944b1b9,
+	0x3a0a7eda, 0x3acea7c0, 0x3b913356, 0x3c52285c,
+	0x3d118d67, 0x3dcf68e3, 0x3e8bc118, 0x3f469c23,
+	0x40000000
+};
+
 static fixed_wide_t scale_cordic_result(long a)
 {
     return (long)((((fixed_wide_t)a)*CORDIC_SCALE)>>FIXED_PRECISION);
@@ -136,3 +185,50 @@ void fixed_sin_cos(fixed_t const theta, fixed_t *s, fixed_t *c)
         *c = negate_cos ? -x_cos : x_cos;
     }
 }
+
+// The fraction of an octave indexes the table, and the remaining 16 bits interpolate linearly between entries.
+// Against pow, results are within 0.03 cents for x in [-1, 1]; truncation to FIXED_PRECISION makes smaller
+// results coarser, reaching 0.1 cents at x = -4. Results beyond the fixed_t range saturate.
+fixed_t fixed_exp2_at(fixed_t x, int precision)
+{
+	int whole = x >> precision;
+	uint32_t fraction = (uint32_t)(x & ((1 << precision) - 1)) << (32 - precision);
+	uint32_t index = fraction >> (32 - EXP2_TABLE_BITS);
+	uint32_t weight = (fraction << EXP2_TABLE_BITS) >> 16;
+
+	uint32_t base = exp2_table[index];
+	uint32_t value = base + (uint32_t)(((uint64_t)(exp2_table[index + 1] - base) * weight) >> 16);
+
+	int shift = EXP2_TABLE_PRECISION - FIXED_PRECISION - whole;
+	if (shift <= 0)
+	{
+		return (shift < 0 || value > INT32_MAX) ? INT32_MAX : (fixed_t)value;
+	}
+	else if (shift >= 32)
+	{
+		return 0;
+	}
+
+	return (fixed_t)(value >> shift);
+}
+
+// The position of the top bit gives the whole part; the next bits index the table, with the 16 bits after those
+// interpolating. Against log2, results are within 0.00005 (0.06 cents) - below the FIXED_PRECISION resolution.
+fixed_t fixed_log2_at(fixed_t x, int precision)
+{
+	if (x <= 0)
+	{
+		return INT32_MIN;
+	}
+
+	int top_bit = 31 - __builtin_clz((uint32_t)x);
+	uint32_t fraction = ((uint32_t)x << (31 - top_bit)) << 1;
+	uint32_t index = fraction >> (32 - LOG2_TABLE_BITS);
+	uint32_t weight = (fraction << LOG2_TABLE_BITS) >> 16;
+
+	uint32_t base = log2_table[index];
+	uint32_t value = base + (uint32_t)(((uint64_t)(log2_table[index + 1] - base) * weight) >> 16);
+
+	// The whole part is negative below 1.0, so is multiplied up rather than shifted.
+	return (fixed_t)((top_bit - precision) * (1 << FIXED_PRECISION)) + (fixed_t)(value >> (LOG2_TABLE_PRECISION - FIXED_PRECISION));
+}
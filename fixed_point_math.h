@@ -34,6 +34,14 @@ extern fixed_t const FIXED_HALF_PI;
 
 extern void fixed_sin_cos(fixed_t const theta, fixed_t *s, fixed_t *c);
 
+// 2^x, with x at the given precision and the result at FIXED_PRECISION; within 0.03 cents for x in [-1, 1].
+extern fixed_t fixed_exp2_at(fixed_t x, int precision);
+#define fixed_exp2(x) fixed_exp2_at(x, FIXED_PRECISION)
+
+// log2(x), with x at the given precision and the result at FIXED_PRECISION; x must be positive.
+extern fixed_t fixed_log2_at(fixed_t x, int precision);
+#define fixed_log2(x) fixed_log2_at(x, FIXED_PRECISION)
+
 #define fixed_from_int(a) fixed_from_int_at(a, FIXED_PRECISION)
 #define fixed_wide_from_int(a) fixed_wide_from_int_at(a, FIXED_PRECISION)
 #define fixed_mul(a, b) fixed_mul_at(a, b, FIXED_PRECISION)
@@ -24,8 +24,10 @@
 #include "float_filter.h"
 #include <memory.h>
 #include <math.h>
+#include <stdlib.h>
 #include "system_constants.h"
 #include "filter.h"
+#include "filter_modulated.h"
 
 static void clear_history(float_filter_t *filter)
 {
@@ -36,12 +38,53 @@ static void clear_history(float_filter_t *filter)
 void float_filter_init(float_filter_t *filter)
 {
 	clear_history(filter);
+	memset(filter->state.stage, 0, sizeof(filter->state.stage));
 	memset(filter->state.input_coeff, 0, sizeof(filter->state.input_coeff));
 	memset(filter->state.output_coeff, 0, sizeof(filter->state.output_coeff));
 }
 
+// Matches the coefficients of filter_cutoff_coeff & filter_resonance_coeff, with q as a resonance amount.
+float float_filter_cutoff_coeff(int type, float frequency)
+{
+	float w0 = 2.0f * M_PI * frequency / (float)SYSTEM_SAMPLE_RATE;
+
+	if (type == FILTER_LADDER)
+	{
+		return 1.0f - expf(-w0);
+	}
+	else
+	{
+		return fminf(2.0f * sinf(w0 / (2.0f * FILTER_SVF_OVERSAMPLING)), FILTER_SVF_MAX_CUTOFF);
+	}
+}
+
+float float_filter_resonance_coeff(int type, float q)
+{
+	static const float min_q = (float)FILTER_MIN_Q / FIXED_ONE;
+	static const float max_q = (float)FILTER_MAX_Q / FIXED_ONE;
+
+	float resonance = fminf(fmaxf((q - min_q) / (max_q - min_q), 0.0f), 1.0f);
+
+	if (type == FILTER_LADDER)
+	{
+		return FILTER_LADDER_MAX_FEEDBACK * resonance;
+	}
+	else
+	{
+		return FILTER_SVF_MAX_DAMPING - (FILTER_SVF_MAX_DAMPING - FILTER_SVF_MIN_DAMPING) * resonance;
+	}
+}
+
+// Modulated filters keep running through updates; only their coefficients change.
 void float_filter_update(float_filter_t *filter)
 {
+	if (FILTER_IS_MODULATED(filter->definition.type))
+	{
+		filter->state.cutoff = float_filter_cutoff_coeff(filter->definition.type, filter->definition.frequency);
+		filter->state.resonance = float_filter_resonance_coeff(filter->definition.type, filter->definition.q);
+		return;
+	}
+
 	float frequency = filter->definition.frequency;
 	float q = filter->definition.q;
 
@@ -100,9 +143,87 @@ void float_filter_update(float_filter_t *filter)
 	clear_history(filter);
 }
 
+static void float_svf_apply(float_filter_state_t *state, float *sample_data, int sample_count, const float *cutoff, const float *resonance, int type)
+{
+	float low = state->stage[0];
+	float band = state->stage[1];
+	float high = state->stage[2];
+
+	for (int i = 0; i < sample_count; i++)
+	{
+		float f = cutoff[i];
+		float d = resonance[i];
+
+		for (int pass = 0; pass < FILTER_SVF_OVERSAMPLING; pass++)
+		{
+			low += f * band;
+			high = sample_data[i] - low - d * band;
+			band += f * high;
+		}
+
+		sample_data[i] = (type == FILTER_SVF_LPF) ? low : (type == FILTER_SVF_BPF) ? band : high;
+	}
+
+	state->stage[0] = low;
+	state->stage[1] = band;
+	state->stage[2] = high;
+}
+
+static void float_ladder_apply(float_filter_state_t *state, float *sample_data, int sample_count, const float *cutoff, const float *resonance)
+{
+	float stage0 = state->stage[0];
+	float stage1 = state->stage[1];
+	float stage2 = state->stage[2];
+	float stage3 = state->stage[3];
+
+	for (int i = 0; i < sample_count; i++)
+	{
+		float g = cutoff[i];
+		float input = fminf(fmaxf(sample_data[i] - resonance[i] * stage3, -1.0f), 1.0f);
+
+		stage0 += g * (input - stage0);
+		stage1 += g * (stage0 - stage1);
+		stage2 += g * (stage1 - stage2);
+		stage3 += g * (stage2 - stage3);
+
+		sample_data[i] = stage3;
+	}
+
+	state->stage[0] = stage0;
+	state->stage[1] = stage1;
+	state->stage[2] = stage2;
+	state->stage[3] = stage3;
+}
+
+// Cutoff & resonance hold a coefficient per sample, from float_filter_cutoff_coeff & float_filter_resonance_coeff.
+void float_filter_apply_modulated(float_filter_t *filter, float *sample_data, int sample_count, const float *cutoff, const float *resonance)
+{
+	if (filter->definition.type == FILTER_LADDER)
+	{
+		float_ladder_apply(&filter->state, sample_data, sample_count, cutoff, resonance);
+	}
+	else
+	{
+		float_svf_apply(&filter->state, sample_data, sample_count, cutoff, resonance, filter->definition.type);
+	}
+}
+
 void float_filter_apply(float_filter_t *filter, float *sample_data, int sample_count)
 {
-	if (filter->definition.type != FILTER_PASS)
+	if (FILTER_IS_MODULATED(filter->definition.type))
+	{
+		float *cutoff = (float*)alloca(sample_count * sizeof(float));
+		float *resonance = (float*)alloca(sample_count * sizeof(float));
+
+		for (int i = 0; i < sample_count; i++)
+		{
+			cutoff[i] = filter->state.cutoff;
+			resonance[i] = filter->state.resonance;
+		}
+
+		float_filter_apply_modulated(filter, sample_data, sample_count, cutoff, resonance);
+	}
+	else if (filter->definition.type != FILTER_PASS)
 	{
 		for (int i = 0; i < sample_count; i++)
 		{
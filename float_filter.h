@@ -38,6 +38,11 @@ typedef struct float_filter_state_t
 	float output_coeff[2];
 	float history[2];
 	float output[2];
+
+	// Modulated filter types only.
+	float cutoff;
+	float resonance;
+	float stage[4];
 } float_filter_state_t;
 
 typedef struct float_filter_t
@@ -49,5 +54,8 @@ typedef struct float_filter_t
 extern void float_filter_init(float_filter_t *filter);
 extern void float_filter_update(float_filter_t *filter);
 extern void float_filter_apply(float_filter_t *filter, float *sample_data, int sample_count);
+extern void float_filter_apply_modulated(float_filter_t *filter, float *sample_data, int sample_count, const float *cutoff, const float *resonance);
+extern float float_filter_cutoff_coeff(int type, float frequency);
+extern float float_filter_resonance_coeff(int type, float q);
 
 #endif /* FILTER_FLOAT_H_ */
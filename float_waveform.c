@@ -25,21 +25,21 @@
 #include <math.h>
 #include <stdlib.h>
 
-void float_generate_sine(float_waveform_t *waveform, float sample_rate, float frequency)
+#define TABLE_PHASE_STEP_SCALE	(4294967296.0 / SYSTEM_SAMPLE_RATE)
+
+void float_generate_sine(float_waveform_t *waveform, int size_bits)
 {
-	static float max_phase = 1.0f;
+	int sample_count = 1 << size_bits;
+	float phase_step = 1.0f / sample_count;
 
-	float phase_step_float = max_phase * frequency / sample_rate;
-	waveform->frequency = frequency;
-	waveform->phase_step = DOUBLE_TO_FIXED(phase_step_float);
-	waveform->sample_count = roundf(max_phase / phase_step_float);
-	waveform->samples = malloc(waveform->sample_count * sizeof(waveform->samples[0]));
+	waveform->size_bits = size_bits;
+	waveform->samples = malloc(sample_count * sizeof(waveform->samples[0]));
 
 	float phase;
 
-	for (int i = 0; i < waveform->sample_count; i++)
+	for (int i = 0; i < sample_count; i++)
 	{
-		phase = i * phase_step_float;
+		phase = i * phase_step;
 		waveform->samples[i] = sinf(phase * M_PI * 2.0f);
 	}
 }
@@ -126,24 +126,19 @@ void waveform_float_procedural_sine_mix(float_oscillator_t *osc, float *sample_b
 
 void waveform_float_wavetable_sine(float_waveform_t *waveform, float_oscillator_t *osc, float *sample_buffer, int sample_count)
 {
-	fixed_t frequency_ratio = DOUBLE_TO_FIXED(osc->frequency / waveform->frequency);
-	fixed_t phase_step = fixed_mul(frequency_ratio, waveform->phase_step);
+	u_int32_t phase_step = (u_int32_t)(osc->frequency * TABLE_PHASE_STEP_SCALE);
+	int index_shift = 32 - waveform->size_bits;
 
 	float amplitude_step = (osc->level - osc->last_level) / sample_count;
 	float amplitude_scale = osc->last_level;
 
 	while (sample_count > 0)
 	{
-		int sample_index = fixed_mul(osc->phase_fixed, waveform->sample_count);
-		float sample = waveform->samples[sample_index];
+		float sample = waveform->samples[osc->table_phase >> index_shift];
 		sample *= amplitude_scale;
 		*sample_buffer++ = sample;
 		*sample_buffer++ = sample;
-		osc->phase_fixed += phase_step;
-		if (osc->phase_fixed >= FIXED_ONE)
-		{
-			osc->phase_fixed -= FIXED_ONE;
-		}
+		osc->table_phase += phase_step;
 		amplitude_scale += amplitude_step;
 		sample_count--;
 	}
@@ -151,30 +146,165 @@ void waveform_float_wavetable_sine(float_waveform_t *waveform, float_oscillator_
 
 void waveform_float_wavetable_sine_mix(float_waveform_t *waveform, float_oscillator_t *osc, float *sample_buffer, int sample_count)
 {
-	fixed_t frequency_ratio = DOUBLE_TO_FIXED(osc->frequency / waveform->frequency);
-	fixed_t phase_step = fixed_mul(frequency_ratio, waveform->phase_step);
+	u_int32_t phase_step = (u_int32_t)(osc->frequency * TABLE_PHASE_STEP_SCALE);
+	int index_shift = 32 - waveform->size_bits;
 
 	float amplitude_step = (osc->level - osc->last_level) / sample_count;
 	float amplitude_scale = osc->last_level;
 
 	while (sample_count > 0)
 	{
-		int sample_index = fixed_mul(osc->phase_fixed, waveform->sample_count);
-		float sample = waveform->samples[sample_index];
+		float sample = waveform->samples[osc->table_phase >> index_shift];
 		sample *= amplitude_scale;
 		sample += *sample_buffer;
 		*sample_buffer++ = sample;
 		*sample_buffer++ = sample;
-		osc->phase_fixed += phase_step;
-		if (osc->phase_fixed >= FIXED_ONE)
+		osc->table_phase += phase_step;
+		amplitude_scale += amplitude_step;
+		sample_count--;
+	}
+
+}
+
+//-----------------------------------------------------------------------------------------------------------------------
+// PolyBLEP oscillators, matching waveform_polyblep.c
+//
+typedef enum
+{
+	FLOAT_POLYBLEP_SAW,
+	FLOAT_POLYBLEP_SQUARE,
+	FLOAT_POLYBLEP_PULSE,
+	FLOAT_POLYBLEP_TRIANGLE
+} float_polyblep_shape_t;
+
+// The correction for a unit step up at phase 0, with t the phase and dt the phase step.
+static inline float float_poly_blep(float t, float dt)
+{
+	if (t < dt)
+	{
+		float r = 1.0f - t / dt;
+		return -r * r;
+	}
+	else if (t > 1.0f - dt)
+	{
+		float r = 1.0f - (1.0f - t) / dt;
+		return r * r;
+	}
+
+	return 0.0f;
+}
+
+// The integral of float_poly_blep, for a unit change of slope at phase 0.
+static inline float float_poly_blamp(float t, float dt)
+{
+	float x;
+
+	if (t < dt)
+	{
+		x = t / dt;
+	}
+	else if (t > 1.0f - dt)
+	{
+		x = (1.0f - t) / dt;
+	}
+	else
+	{
+		return 0.0f;
+	}
+
+	float r = 1.0f - x;
+	return r * r * r * (1.0f / 3.0f);
+}
+
+static inline float float_wrap_phase(float t)
+{
+	return t < 0.0f ? t + 1.0f : t;
+}
+
+static __attribute__((always_inline)) inline void float_polyblep_output(float_oscillator_t *osc, float *sample_buffer, int sample_count, float_polyblep_shape_t shape, int mix)
+{
+	float phase_step = osc->frequency / SYSTEM_SAMPLE_RATE;
+	float amplitude_step = (osc->level - osc->last_level) / sample_count;
+	float amplitude_scale = osc->last_level;
+	float pulse_width = shape == FLOAT_POLYBLEP_SQUARE ? 0.5f : osc->pulse_width;
+	float ramp_scale = 4.0f * phase_step;
+
+	while (sample_count > 0)
+	{
+		float t = osc->phase;
+		float sample;
+
+		if (shape == FLOAT_POLYBLEP_SAW)
+		{
+			sample = 1.0f - 2.0f * t + float_poly_blep(t, phase_step);
+		}
+		else if (shape == FLOAT_POLYBLEP_TRIANGLE)
+		{
+			float offset = t < 0.75f ? t - 0.25f : t - 1.25f;
+			sample = 1.0f - 4.0f * fabsf(offset);
+			sample -= ramp_scale * float_poly_blamp(float_wrap_phase(t - 0.25f), phase_step);
+			sample += ramp_scale * float_poly_blamp(float_wrap_phase(t - 0.75f), phase_step);
+		}
+		else
 		{
-			osc->phase_fixed -= FIXED_ONE;
+			sample = t < pulse_width ? 1.0f : -1.0f;
+			sample += float_poly_blep(t, phase_step) - float_poly_blep(float_wrap_phase(t - pulse_width), phase_step);
+		}
+
+		sample *= amplitude_scale;
+		if (mix)
+		{
+			sample += *sample_buffer;
+		}
+		*sample_buffer++ = sample;
+		*sample_buffer++ = sample;
+
+		osc->phase += phase_step;
+		if (osc->phase >= 1.0f)
+		{
+			osc->phase -= 1.0f;
 		}
 		amplitude_scale += amplitude_step;
 		sample_count--;
 	}
+}
 
+void waveform_float_polyblep_saw(float_oscillator_t *osc, float *sample_buffer, int sample_count)
+{
+	float_polyblep_output(osc, sample_buffer, sample_count, FLOAT_POLYBLEP_SAW, 0);
 }
 
+void waveform_float_polyblep_saw_mix(float_oscillator_t *osc, float *sample_buffer, int sample_count)
+{
+	float_polyblep_output(osc, sample_buffer, sample_count, FLOAT_POLYBLEP_SAW, 1);
+}
+
+void waveform_float_polyblep_square(float_oscillator_t *osc, float *sample_buffer, int sample_count)
+{
+	float_polyblep_output(osc, sample_buffer, sample_count, FLOAT_POLYBLEP_SQUARE, 0);
+}
 
+void waveform_float_polyblep_square_mix(float_oscillator_t *osc, float *sample_buffer, int sample_count)
+{
+	float_polyblep_output(osc, sample_buffer, sample_count, FLOAT_POLYBLEP_SQUARE, 1);
+}
 
+void waveform_float_polyblep_pulse(float_oscillator_t *osc, float *sample_buffer, int sample_count)
+{
+	float_polyblep_output(osc, sample_buffer, sample_count, FLOAT_POLYBLEP_PULSE, 0);
+}
+
+void waveform_float_polyblep_pulse_mix(float_oscillator_t *osc, float *sample_buffer, int sample_count)
+{
+	float_polyblep_output(osc, sample_buffer, sample_count, FLOAT_POLYBLEP_PULSE, 1);
+}
+
+void waveform_float_polyblep_triangle(float_oscillator_t *osc, float *sample_buffer, int sample_count)
+{
+	float_polyblep_output(osc, sample_buffer, sample_count, FLOAT_POLYBLEP_TRIANGLE, 0);
+}
+
+void waveform_float_polyblep_triangle_mix(float_oscillator_t *osc, float *sample_buffer, int sample_count)
+{
+	float_polyblep_output(osc, sample_buffer, sample_count, FLOAT_POLYBLEP_TRIANGLE, 1);
+}
@@ -31,23 +31,31 @@ typedef struct float_oscillator_t
 	float	frequency;
 	float	level;
 
-	float	phase;				// runs from 0 to 1
-	fixed_t	phase_fixed;
-	float	last_level;
+	float		phase;				// runs from 0 to 1
+	float		pulse_width;		// fraction of the cycle a pulse is high
+	u_int32_t	table_phase;		// a cycle over 32 bits, wrapping
+	float		last_level;
 } float_oscillator_t;
 
+// Tables are a power of two long, indexed by the top bits of the phase.
 typedef struct
 {
-	int			sample_count;
-	float		frequency;
-	fixed_t		phase_step;
+	int			size_bits;
 	float		*samples;
 } float_waveform_t;
 
-extern void float_generate_sine(float_waveform_t *waveform, float sample_rate, float frequency);
+extern void float_generate_sine(float_waveform_t *waveform, int size_bits);
 extern void waveform_float_procedural_sine(float_oscillator_t *osc, float *sample_buffer, int sample_count);
 extern void waveform_float_procedural_sine_mix(float_oscillator_t *osc, float *sample_buffer, int sample_count);
 extern void waveform_float_wavetable_sine(float_waveform_t *waveform, float_oscillator_t *osc, float *sample_buffer, int sample_count);
 extern void waveform_float_wavetable_sine_mix(float_waveform_t *waveform, float_oscillator_t *osc, float *sample_buffer, int sample_count);
+extern void waveform_float_polyblep_saw(float_oscillator_t *osc, float *sample_buffer, int sample_count);
+extern void waveform_float_polyblep_saw_mix(float_oscillator_t *osc, float *sample_buffer, int sample_count);
+extern void waveform_float_polyblep_square(float_oscillator_t *osc, float *sample_buffer, int sample_count);
+extern void waveform_float_polyblep_square_mix(float_oscillator_t *osc, float *sample_buffer, int sample_count);
+extern void waveform_float_polyblep_pulse(float_oscillator_t *osc, float *sample_buffer, int sample_count);
+extern void waveform_float_polyblep_pulse_mix(float_oscillator_t *osc, float *sample_buffer, int sample_count);
+extern void waveform_float_polyblep_triangle(float_oscillator_t *osc, float *sample_buffer, int sample_count);
+extern void waveform_float_polyblep_triangle_mix(float_oscillator_t *osc, float *sample_buffer, int sample_count);
 
 #endif /* FLOAT_WAVEFORM_H_ */
@@ -28,13 +28,14 @@
 #include <stdio.h>
 #include <memory.h>
 #include <libgen.h>
+#include <getopt.h>
 #include <libconfig.h>
 #include <gperftools/profiler.h>
 
 #include "system_constants.h"
 #include "master_time.h"
 #include "logging.h"
-#include "alsa.h"
+#include "audio_output.h"
 #include "midi.h"
 
 #include "gfx.h"
@@ -50,33 +51,41 @@
 
 #include "setting.h"
 #include "recording.h"
-#include "code_timing_tests.h"
 #include "piglow.h"
+#include "midi_file.h"
+#include "offline_render.h"
+#include "dsp_kernel.h"
 
 //-----------------------------------------------------------------------------------------------------------------------
 // Commons
 //
-#define VOICE_COUNT				8
+#define DEFAULT_VOICE_COUNT		8
 #define EXIT_CONTROLLER			0x2e
 #define PROFILE_CONTROLLER		0x2c
 
 static const char* RESOURCES_PITHESISER_ALPHA_PNG = "resources/pithesiser_alpha.png";
 static const char* RESOURCES_SYNTH_CFG = "resources/synth.cfg";
 
-static const char* CFG_DEVICES_AUDIO_OUTPUT = "devices.audio.output";
+static const char* CFG_DEVICES_AUDIO_VOICES = "devices.audio.voices";
 static const char* CFG_DEVICES_AUDIO_AUTO_DUCK = "devices.audio.auto_duck";
+static const char* CFG_DEVICES_AUDIO_AUTO_DUCK_CURVE = "devices.audio.auto_duck_curve";
+static const char* CFG_DEVICES_AUDIO_RENDER_THREADS = "devices.audio.render_threads";
+static const char* CFG_DEVICES_AUDIO_KERNELS = "devices.audio.kernels";
+static const char* CFG_DEVICES_AUDIO_FUSED_VOICES = "devices.audio.fused_voices";
+static const char* CFG_DEVICES_AUDIO_DITHER = "devices.audio.dither";
+static const char* CFG_DEVICES_AUDIO_WAVETABLE_CACHE = "devices.audio.wavetable_cache";
+static const char* CFG_OSCILLATOR_STACK = "oscillator_stack";
 static const char* CFG_DEVICES_MIDI_NOTE_CHANNEL = "devices.midi.note_channel";
 static const char* CFG_DEVICES_MIDI_CONTROLLER_CHANNEL = "devices.midi.controller_channel";
 static const char* CFG_DEVICES_PIGLOW = "devices.piglow";
 static const char* CFG_CONTROLLERS = "controllers";
 static const char* CFG_MOD_MATRIX_CONTROLLER = "modulation_matrix";
 static const char* CFG_DEVICES_MIDI_INPUT = "devices.midi.input";
-static const char* CFG_TESTS = "tests";
-static const char* CFG_CODE_TIMING_TESTS = "code_timing";
 static const char* CFG_SYSEX_INIT = "sysex.init_message";
 
-static const char* SETTINGS_FILE = ".pithesiser.cfg";
-static const char* PATCH_FILE = ".pithesiser.patch";
+static const char* settings_file = ".pithesiser.cfg";
+static const char* patch_file = ".pithesiser.patch";
+static const char* wavetable_cache_file = ".pithesiser.wavetables";
 
 config_t app_config;
 config_t patch_config;
@@ -97,8 +106,16 @@ const char* master_waveform_names[] =
 	"WAVETABLE_SINE_LINEAR",
 	"WAVETABLE_SAW_LINEAR",
 	"WAVETABLE_SAW_LINEAR_BL",
+	"WAVETABLE_SINE_HERMITE",
+	"WAVETABLE_SAW_HERMITE_BL",
+	"WAVETABLE_SINE_OPTIMAL",
+	"WAVETABLE_SAW_OPTIMAL_BL",
 	"PROCEDURAL_SINE",
 	"PROCEDURAL_SAW",
+	"PROCEDURAL_SAW_BLEP",
+	"PROCEDURAL_SQUARE_BLEP",
+	"PROCEDURAL_PULSE_BLEP",
+	"PROCEDURAL_TRIANGLE_BLEP",
 };
 
 enum_type_info_t master_waveform_type =
@@ -129,66 +146,195 @@ void destroy_settings()
 //-----------------------------------------------------------------------------------------------------------------------
 // Audio processing
 //
-static int32_t duck_level_by_voice_count[] = { LEVEL_MAX, LEVEL_MAX, LEVEL_MAX * 0.65f, LEVEL_MAX * 0.49f, LEVEL_MAX * 0.40f,
-											   LEVEL_MAX * 0.34f, LEVEL_MAX * 0.29f, LEVEL_MAX * 0.25f, LEVEL_MAX * 0.22f};
-
-void configure_audio()
+static void configure_ducking()
 {
-	const char *setting_devices_audio_output = NULL;
+	config_setting_t *setting_auto_duck = config_lookup(&app_config, CFG_DEVICES_AUDIO_AUTO_DUCK);
 
-	if (config_lookup_string(&app_config, CFG_DEVICES_AUDIO_OUTPUT, &setting_devices_audio_output) != CONFIG_TRUE)
+	if (setting_auto_duck == NULL)
 	{
-		LOG_ERROR("Missing audio output device in config");
-		exit(EXIT_FAILURE);
+		double duck_curve = SYNTH_DUCKING_EXPONENT_DEFAULT;
+		config_lookup_float(&app_config, CFG_DEVICES_AUDIO_AUTO_DUCK_CURVE, &duck_curve);
+
+		if (duck_curve < 0.0 || duck_curve > 1.0)
+		{
+			LOG_ERROR("Invalid auto duck curve of %f - should be between 0 and 1", duck_curve);
+			exit(EXIT_FAILURE);
+		}
+
+		synth_model_set_ducking_curve(&synth_model, duck_curve);
+		return;
 	}
 
-	if (alsa_initialise(setting_devices_audio_output, 128) < 0)
+	int duck_setting_count = config_setting_length(setting_auto_duck);
+
+	if (duck_setting_count != synth_model.voice_count)
 	{
+		LOG_ERROR("Invalid number of auto duck levels %d - should be %d", duck_setting_count, synth_model.voice_count);
 		exit(EXIT_FAILURE);
 	}
 
-	config_setting_t *setting_auto_duck = config_lookup(&app_config, CFG_DEVICES_AUDIO_AUTO_DUCK);
+	int32_t* duck_level_by_voice_count = (int32_t*)malloc((duck_setting_count + 1) * sizeof(int32_t));
+	duck_level_by_voice_count[0] = LEVEL_MAX;
 
-	if (setting_auto_duck != NULL)
+	for (int i = 0; i < duck_setting_count; i++)
 	{
-		int duck_setting_count = config_setting_length(setting_auto_duck);
+		float duck_level_factor = config_setting_get_float_elem(setting_auto_duck, i);
+		if (duck_level_factor < 0.0f || duck_level_factor > 1.0f)
+		{
+			LOG_ERROR("Invalid auto duck level %d of %f - should be between 0 and 1", i + 1, duck_level_factor);
+			exit(EXIT_FAILURE);
+		}
+
+		int32_t duck_level = LEVEL_MAX * duck_level_factor;
 
-		if (duck_setting_count != synth_model.voice_count)
+		if (duck_level > duck_level_by_voice_count[i])
 		{
-			LOG_ERROR("Invalid number of auto duck levels %d - should be %d", duck_setting_count, synth_model.voice_count);
+			LOG_ERROR("Invalid auto duck level %d of %f - values should be decreasing", i + 1, duck_level_factor);
 			exit(EXIT_FAILURE);
 		}
 
-		for (int i = 0; i < duck_setting_count; i++)
+		duck_level_by_voice_count[i + 1] = duck_level;
+	}
+
+	synth_model_set_ducking_levels(&synth_model, duck_level_by_voice_count);
+	free(duck_level_by_voice_count);
+}
+
+static int find_audible_waveform(const char* name)
+{
+	for (int i = WAVE_FIRST_AUDIBLE; i <= WAVE_LAST_AUDIBLE; i++)
+	{
+		if (strcmp(master_waveform_names[i], name) == 0)
 		{
-			float duck_level_factor = config_setting_get_float_elem(setting_auto_duck, i);
-			if (duck_level_factor < 0.0f || duck_level_factor > 1.0f)
-			{
-				LOG_ERROR("Invalid auto duck level %d of %f - should be between 0 and 1", i + 1, duck_level_factor);
-				exit(EXIT_FAILURE);
-			}
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+// Unison stacks play the master waveform; other stacks list a waveform, detune & level for each oscillator.
+void configure_oscillator_stack()
+{
+	config_setting_t *setting_stack = config_lookup(&app_config, CFG_OSCILLATOR_STACK);
+
+	if (setting_stack == NULL)
+	{
+		return;
+	}
+
+	osc_stack_def_t stack_def;
+	double spread = 0.0;
+
+	memset(&stack_def, 0, sizeof(stack_def));
+	stack_def.count = 1;
+	config_setting_lookup_int(setting_stack, "count", &stack_def.count);
+	config_setting_lookup_bool(setting_stack, "unison", &stack_def.unison);
+	config_setting_lookup_float(setting_stack, "spread", &spread);
+	stack_def.spread = spread;
+
+	if (stack_def.count < 1 || stack_def.count > OSC_STACK_MAX_OSCILLATORS)
+	{
+		LOG_ERROR("Invalid oscillator stack count %d - should be between 1 and %d", stack_def.count, OSC_STACK_MAX_OSCILLATORS);
+		exit(EXIT_FAILURE);
+	}
+
+	if (!stack_def.unison && stack_def.count > 1)
+	{
+		config_setting_t *setting_oscillators = config_setting_get_member(setting_stack, "oscillators");
+
+		if (setting_oscillators == NULL || config_setting_length(setting_oscillators) < stack_def.count)
+		{
+			LOG_ERROR("Oscillator stack needs %d oscillators listed", stack_def.count);
+			exit(EXIT_FAILURE);
+		}
 
-			int32_t duck_level = LEVEL_MAX * duck_level_factor;
+		for (int i = 0; i < stack_def.count; i++)
+		{
+			config_setting_t *setting_oscillator = config_setting_get_elem(setting_oscillators, i);
+			const char* waveform_name = master_waveform_names[WAVETABLE_SAW_BL];
+			double detune = 0.0;
+			double level = 1.0;
 
-			if (duck_level > duck_level_by_voice_count[i])
+			config_setting_lookup_string(setting_oscillator, "waveform", &waveform_name);
+			config_setting_lookup_float(setting_oscillator, "detune", &detune);
+			config_setting_lookup_float(setting_oscillator, "level", &level);
+
+			int waveform = find_audible_waveform(waveform_name);
+			if (waveform < 0)
 			{
-				LOG_ERROR("Invalid auto duck level %d of %f - values should be decreasing", i + 1, duck_level_factor);
+				LOG_ERROR("Unknown oscillator stack waveform %s", waveform_name);
 				exit(EXIT_FAILURE);
 			}
 
-			duck_level_by_voice_count[i + 1] = duck_level;
+			stack_def.oscillator[i].waveform = (waveform_type_t)waveform;
+			stack_def.oscillator[i].detune = detune;
+			stack_def.oscillator[i].level = level;
 		}
 	}
 
-	synth_model_set_ducking_levels(&synth_model, duck_level_by_voice_count);
+	synth_model_set_oscillator_stack(&synth_model, &stack_def);
+}
+
+void configure_voice_rendering()
+{
+	configure_ducking();
+
+	int render_threads = 1;
+	config_lookup_int(&app_config, CFG_DEVICES_AUDIO_RENDER_THREADS, &render_threads);
+
+	if (synth_model_set_render_threads(&synth_model, render_threads) != RESULT_OK)
+	{
+		exit(EXIT_FAILURE);
+	}
+
+	int fused_voices = FALSE;
+	config_lookup_bool(&app_config, CFG_DEVICES_AUDIO_FUSED_VOICES, &fused_voices);
+	synth_model_set_fused_voices(&synth_model, fused_voices);
+
+	int dither = FALSE;
+	config_lookup_bool(&app_config, CFG_DEVICES_AUDIO_DITHER, &dither);
+	synth_model_set_dither(&synth_model, dither);
+
+	configure_oscillator_stack();
+
+	const char* kernels = DSP_KERNELS_AUTO;
+	config_lookup_string(&app_config, CFG_DEVICES_AUDIO_KERNELS, &kernels);
+
+	if (dsp_kernels_initialise(kernels) != RESULT_OK)
+	{
+		exit(EXIT_FAILURE);
+	}
+}
+
+void configure_waveforms()
+{
+	config_lookup_string(&app_config, CFG_DEVICES_AUDIO_WAVETABLE_CACHE, &wavetable_cache_file);
+	waveform_initialise(*wavetable_cache_file != '\0' ? wavetable_cache_file : NULL);
+}
+
+void configure_audio()
+{
+	if (audio_output_initialise(&app_config) != RESULT_OK)
+	{
+		exit(EXIT_FAILURE);
+	}
+
+	configure_voice_rendering();
 }
 
 void process_audio(int32_t timestep_ms)
 {
-	int write_buffer_index = alsa_lock_next_write_buffer();
+	int write_buffer_index = audio_output_lock_next_write_buffer();
 	void* buffer_data;
 	int buffer_samples;
-	alsa_get_buffer_params(write_buffer_index, &buffer_data, &buffer_samples);
+	audio_output_get_buffer_params(write_buffer_index, &buffer_data, &buffer_samples);
+	if (buffer_data == NULL || buffer_samples == 0)
+	{
+		audio_output_unlock_buffer(write_buffer_index);
+		return;
+	}
+
 	size_t buffer_bytes = buffer_samples * sizeof(sample_t) * 2;
 
 	synth_update_state_t update_state;
@@ -209,23 +355,37 @@ void process_audio(int32_t timestep_ms)
 		gfx_send_event(&gfx_event);
 	}
 
-	alsa_unlock_buffer(write_buffer_index);
+	audio_output_unlock_buffer(write_buffer_index);
 }
 
 //-----------------------------------------------------------------------------------------------------------------------
 // Midi processing
 //
 int controller_channel = 0;
+int note_channel = 0;
 
-void configure_midi()
+void configure_controllers()
 {
-	int note_channel = 0;
-
 	config_lookup_int(&app_config, CFG_DEVICES_MIDI_CONTROLLER_CHANNEL, &controller_channel);
 	config_lookup_int(&app_config, CFG_DEVICES_MIDI_NOTE_CHANNEL, &note_channel);
 
 	synth_model_set_midi_channel(&synth_model, note_channel);
 
+	if (!synth_controllers_initialise(controller_channel, config_lookup(&app_config, CFG_CONTROLLERS)))
+	{
+		exit(EXIT_FAILURE);
+	}
+
+	if (mod_matrix_controller_initialise(config_lookup(&app_config, CFG_MOD_MATRIX_CONTROLLER), config_lookup(&patch_config, CFG_MOD_MATRIX_CONTROLLER)) != RESULT_OK)
+	{
+		exit(EXIT_FAILURE);
+	}
+
+	synth_controllers_load(settings_file, &synth_model);
+}
+
+void configure_midi()
+{
 	config_setting_t *setting_devices_midi_input = config_lookup(&app_config, CFG_DEVICES_MIDI_INPUT);
 
 	if (setting_devices_midi_input == NULL)
@@ -253,17 +413,7 @@ void configure_midi()
 		exit(EXIT_FAILURE);
 	}
 
-	if (!synth_controllers_initialise(controller_channel, config_lookup(&app_config, CFG_CONTROLLERS)))
-	{
-		exit(EXIT_FAILURE);
-	}
-
-	if (mod_matrix_controller_initialise(config_lookup(&app_config, CFG_MOD_MATRIX_CONTROLLER), config_lookup(&patch_config, CFG_MOD_MATRIX_CONTROLLER)) != RESULT_OK)
-	{
-		exit(EXIT_FAILURE);
-	}
-
-	synth_controllers_load(SETTINGS_FILE, &synth_model);
+	configure_controllers();
 
 	config_setting_t *setting_sysex_init_message = config_lookup(&app_config, CFG_SYSEX_INIT);
 	if (setting_sysex_init_message != NULL)
@@ -498,9 +648,9 @@ void patch_initialise()
 {
 	config_init(&patch_config);
 
-	if (access(PATCH_FILE, F_OK) != -1)
+	if (access(patch_file, F_OK) != -1)
 	{
-		if (config_read_file(&patch_config, PATCH_FILE) != CONFIG_TRUE)
+		if (config_read_file(&patch_config, patch_file) != CONFIG_TRUE)
 		{
 			LOG_ERROR("Patch load error in %s at line %d: %s", config_error_file(&patch_config), config_error_line(&patch_config), config_error_text(&patch_config));
 			exit(EXIT_FAILURE);
@@ -516,9 +666,9 @@ void patch_save()
 	config_setting_t* mod_matrix_patch = config_setting_add(root_setting, CFG_MOD_MATRIX_CONTROLLER, CONFIG_TYPE_GROUP);
 	mod_matrix_controller_save(mod_matrix_patch);
 
-	if (config_write_file(&patch_config, PATCH_FILE) != CONFIG_TRUE)
+	if (config_write_file(&patch_config, patch_file) != CONFIG_TRUE)
 	{
-		LOG_ERROR("Patch write error to %s", PATCH_FILE);
+		LOG_ERROR("Patch write error to %s", patch_file);
 	}
 }
 
@@ -533,8 +683,17 @@ void patch_deinitialise()
 
 void synth_initialise()
 {
+	int voice_count = DEFAULT_VOICE_COUNT;
+	config_lookup_int(&app_config, CFG_DEVICES_AUDIO_VOICES, &voice_count);
+
+	if (voice_count < 1 || voice_count > SYNTH_MAX_VOICES)
+	{
+		LOG_ERROR("Invalid voice count %d - should be between 1 and %d", voice_count, SYNTH_MAX_VOICES);
+		exit(EXIT_FAILURE);
+	}
+
 	mod_matrix_initialise();
-	synth_model_initialise(&synth_model, VOICE_COUNT);
+	synth_model_initialise(&synth_model, voice_count);
 }
 
 void synth_deinitialise()
@@ -575,7 +734,7 @@ void synth_main()
 		piglow_initialise(piglow_config);
 	}
 
-	waveform_initialise();
+	configure_waveforms();
 	gfx_register_event_global_handler(GFX_EVENT_BUFFERSWAP, process_buffer_swap);
 
 	// Done after synth setup as this can load controller values into the synth
@@ -613,7 +772,7 @@ void synth_main()
 			}
 		}
 
-		alsa_sync_with_audio_output();
+		audio_output_sync_with_output();
 
 		int32_t timestamp = get_elapsed_time_ms();
 		process_audio(timestamp - last_timestamp);
@@ -625,7 +784,7 @@ void synth_main()
 		ProfilerStop();
 	}
 
-	synth_controllers_save(SETTINGS_FILE);
+	synth_controllers_save(settings_file);
 	patch_save();
 	patch_deinitialise();
 	piglow_deinitialise();
@@ -634,29 +793,133 @@ void synth_main()
 	gfx_envelope_render_deinitialise();
 	gfx_wave_render_deinitialise();
 	mod_matrix_controller_deinitialise();
-	alsa_deinitialise();
+	audio_output_deinitialise();
 	midi_deinitialise();
 	synth_deinitialise();
 	config_destroy(&app_config);
 
-	LOG_INFO("Done: %d xruns", alsa_get_xruns_count());
+	LOG_INFO("Done: %d xruns, %d underruns", audio_output_get_xruns_count(), audio_output_get_underruns_count());
+}
+
+//-----------------------------------------------------------------------------------------------------------------------
+// Offline rendering
+//
+#define OFFLINE_BLOCK_SIZE	128
+
+void offline_render_main(const char* midi_file_path, const char* output_path, int block_size)
+{
+	midi_file_t midi_file;
+
+	if (midi_file_load(midi_file_path, &midi_file) != RESULT_OK)
+	{
+		exit(EXIT_FAILURE);
+	}
+
+	// Needed as loading controller values sends UI refresh events, which nothing reads here.
+	gfx_event_initialise();
+
+	create_settings();
+	patch_initialise();
+	synth_initialise();
+	configure_voice_rendering();
+	configure_waveforms();
+	configure_controllers();
+
+	int result = offline_render(&synth_model, &midi_file, note_channel, output_path, block_size);
+
+	midi_file_free(&midi_file);
+	patch_deinitialise();
+	synth_deinitialise();
+	config_destroy(&app_config);
+
+	if (result != RESULT_OK)
+	{
+		exit(EXIT_FAILURE);
+	}
 }
 
 //-----------------------------------------------------------------------------------------------------------------------
 // Entrypoint
 //
 
+static void usage(const char* program_name)
+{
+	fprintf(stderr, "Usage: %s [options] [config file]\n", program_name);
+	fprintf(stderr, "  -r, --render <midi file>     render a MIDI file offline instead of running live\n");
+	fprintf(stderr, "  -o, --output <wav file>      output file for offline rendering\n");
+	fprintf(stderr, "  -b, --block-size <samples>   maximum samples per update when rendering offline (default %d)\n", OFFLINE_BLOCK_SIZE);
+	fprintf(stderr, "  -p, --patch <file>           patch file to use (default %s)\n", patch_file);
+	fprintf(stderr, "  -s, --settings <file>        controller settings file to use (default %s)\n", settings_file);
+	fprintf(stderr, "  -k, --verify-kernels         check every supported set of DSP kernels against the portable C ones\n");
+}
+
 int main(int argc, char **argv)
 {
+	static const struct option long_options[] =
+	{
+		{ "render",		required_argument,	NULL, 'r' },
+		{ "output",		required_argument,	NULL, 'o' },
+		{ "block-size",	required_argument,	NULL, 'b' },
+		{ "patch",		required_argument,	NULL, 'p' },
+		{ "settings",	required_argument,	NULL, 's' },
+		{ "verify-kernels",	no_argument,	NULL, 'k' },
+		{ NULL,			0,					NULL, 0 }
+	};
+
+	const char* render_midi_file = NULL;
+	const char* render_output_file = NULL;
+	int render_block_size = OFFLINE_BLOCK_SIZE;
+	int verify_kernels = FALSE;
+	int option;
+
+	while ((option = getopt_long(argc, argv, "r:o:b:p:s:k", long_options, NULL)) != -1)
+	{
+		switch (option)
+		{
+			case 'r':
+				render_midi_file = optarg;
+				break;
+			case 'o':
+				render_output_file = optarg;
+				break;
+			case 'b':
+				render_block_size = atoi(optarg);
+				break;
+			case 'p':
+				patch_file = optarg;
+				break;
+			case 's':
+				settings_file = optarg;
+				break;
+			case 'k':
+				verify_kernels = TRUE;
+				break;
+			default:
+				usage(argv[0]);
+				exit(EXIT_FAILURE);
+		}
+	}
+
+	if ((render_midi_file == NULL) != (render_output_file == NULL) || render_block_size < 2)
+	{
+		usage(argv[0]);
+		exit(EXIT_FAILURE);
+	}
+
 	if (logging_initialise() != RESULT_OK)
 	{
 		exit(EXIT_FAILURE);
 	}
 
+	if (verify_kernels)
+	{
+		return dsp_kernels_verify() == RESULT_OK ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
 	const char* config_file = RESOURCES_SYNTH_CFG;
-	if (argc > 1)
+	if (optind < argc)
 	{
-		config_file = argv[1];
+		config_file = argv[optind];
 	}
 
 	char config_dir[PATH_MAX];
@@ -670,15 +933,9 @@ int main(int argc, char **argv)
 		exit(EXIT_FAILURE);
 	}
 
-	config_setting_t *setting_tests = config_lookup(&app_config, CFG_TESTS);
-
-	if (setting_tests != NULL)
+	if (render_midi_file != NULL)
 	{
-		config_setting_t *setting_code_timing_tests = config_setting_get_member(setting_tests, CFG_CODE_TIMING_TESTS);
-		if (setting_code_timing_tests != NULL)
-		{
-			code_timing_tests_main(setting_code_timing_tests);
-		}
+		offline_render_main(render_midi_file, render_output_file, render_block_size);
 	}
 	else
 	{
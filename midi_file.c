@@ -0,0 +1,476 @@
+// Pithesiser - a software synthesiser for Raspberry Pi
+// Copyright (C) 2015 Nicholas Tuckett
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * midi_file.c
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: ntuckett
+ */
+
+#include "midi_file.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "system_constants.h"
+#include "error_handler.h"
+
+#define DEFAULT_MICROSECONDS_PER_QUARTER	500000
+#define MICROSECONDS_PER_SECOND				1000000
+
+#define META_EVENT			0xff
+#define META_END_OF_TRACK	0x2f
+#define META_SET_TEMPO		0x51
+#define SYSEX_EVENT			0xf0
+#define SYSEX_ESCAPE_EVENT	0xf7
+
+// An event (or tempo change) as read from a track, before the tempo map is applied.
+typedef struct track_event_t
+{
+	uint32_t		tick;
+	int				sequence;
+	uint32_t		tempo;
+	unsigned char	type;
+	unsigned char	data[2];
+} track_event_t;
+
+typedef struct event_list_t
+{
+	int				count;
+	int				capacity;
+	track_event_t*	events;
+} event_list_t;
+
+typedef struct reader_t
+{
+	const unsigned char*	data;
+	size_t					size;
+	size_t					position;
+} reader_t;
+
+static int read_bytes(reader_t* reader, size_t count, const unsigned char** bytes)
+{
+	if (reader->size - reader->position < count)
+	{
+		return RESULT_ERROR;
+	}
+
+	*bytes = reader->data + reader->position;
+	reader->position += count;
+	return RESULT_OK;
+}
+
+static int read_byte(reader_t* reader, unsigned char* value)
+{
+	const unsigned char* bytes;
+	if (read_bytes(reader, 1, &bytes) != RESULT_OK)
+	{
+		return RESULT_ERROR;
+	}
+
+	*value = bytes[0];
+	return RESULT_OK;
+}
+
+static int read_big_endian(reader_t* reader, int byte_count, uint32_t* value)
+{
+	const unsigned char* bytes;
+	if (read_bytes(reader, byte_count, &bytes) != RESULT_OK)
+	{
+		return RESULT_ERROR;
+	}
+
+	*value = 0;
+	for (int i = 0; i < byte_count; i++)
+	{
+		*value = (*value << 8) | bytes[i];
+	}
+
+	return RESULT_OK;
+}
+
+static int read_variable_length(reader_t* reader, uint32_t* value)
+{
+	*value = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		unsigned char byte;
+		if (read_byte(reader, &byte) != RESULT_OK)
+		{
+			return RESULT_ERROR;
+		}
+
+		*value = (*value << 7) | (byte & 0x7f);
+		if ((byte & 0x80) == 0)
+		{
+			return RESULT_OK;
+		}
+	}
+
+	return RESULT_ERROR;
+}
+
+static track_event_t* add_event(event_list_t* list, uint32_t tick)
+{
+	if (list->count == list->capacity)
+	{
+		int new_capacity = list->capacity == 0 ? 256 : list->capacity * 2;
+		track_event_t* new_events = realloc(list->events, new_capacity * sizeof(track_event_t));
+		if (new_events == NULL)
+		{
+			return NULL;
+		}
+
+		list->events = new_events;
+		list->capacity = new_capacity;
+	}
+
+	track_event_t* event = &list->events[list->count];
+	memset(event, 0, sizeof(track_event_t));
+	event->tick = tick;
+	event->sequence = list->count++;
+	return event;
+}
+
+static int compare_events(const void* a, const void* b)
+{
+	const track_event_t* event_a = (const track_event_t*)a;
+	const track_event_t* event_b = (const track_event_t*)b;
+
+	if (event_a->tick != event_b->tick)
+	{
+		return event_a->tick < event_b->tick ? -1 : 1;
+	}
+
+	return event_a->sequence - event_b->sequence;
+}
+
+static int read_track(reader_t* track, event_list_t* events, event_list_t* tempo_changes, uint32_t* end_tick)
+{
+	uint32_t tick = 0;
+	unsigned char running_status = 0;
+
+	while (track->position < track->size)
+	{
+		uint32_t delta;
+		unsigned char status;
+
+		if (read_variable_length(track, &delta) != RESULT_OK || read_byte(track, &status) != RESULT_OK)
+		{
+			return RESULT_ERROR;
+		}
+
+		tick += delta;
+
+		if (status == META_EVENT)
+		{
+			unsigned char meta_type;
+			uint32_t length;
+			const unsigned char* meta_data;
+
+			if (read_byte(track, &meta_type) != RESULT_OK || read_variable_length(track, &length) != RESULT_OK
+				|| read_bytes(track, length, &meta_data) != RESULT_OK)
+			{
+				return RESULT_ERROR;
+			}
+
+			if (meta_type == META_SET_TEMPO && length == 3)
+			{
+				track_event_t* tempo_change = add_event(tempo_changes, tick);
+				if (tempo_change == NULL)
+				{
+					return RESULT_ERROR;
+				}
+				tempo_change->tempo = (meta_data[0] << 16) | (meta_data[1] << 8) | meta_data[2];
+			}
+			else if (meta_type == META_END_OF_TRACK)
+			{
+				break;
+			}
+		}
+		else if (status == SYSEX_EVENT || status == SYSEX_ESCAPE_EVENT)
+		{
+			uint32_t length;
+			const unsigned char* sysex_data;
+
+			if (read_variable_length(track, &length) != RESULT_OK || read_bytes(track, length, &sysex_data) != RESULT_OK)
+			{
+				return RESULT_ERROR;
+			}
+		}
+		else
+		{
+			unsigned char data[2] = { 0, 0 };
+
+			if (status & 0x80)
+			{
+				running_status = status;
+				if (read_byte(track, &data[0]) != RESULT_OK)
+				{
+					return RESULT_ERROR;
+				}
+			}
+			else if (running_status != 0)
+			{
+				data[0] = status;
+				status = running_status;
+			}
+			else
+			{
+				return RESULT_ERROR;
+			}
+
+			unsigned char event_type = status & 0xf0;
+			if (event_type != 0xc0 && event_type != 0xd0 && read_byte(track, &data[1]) != RESULT_OK)
+			{
+				return RESULT_ERROR;
+			}
+
+			// A note on with zero velocity is a note off.
+			if (event_type == 0x90 && data[1] == 0)
+			{
+				status = 0x80 | (status & 0x0f);
+			}
+
+			track_event_t* event = add_event(events, tick);
+			if (event == NULL)
+			{
+				return RESULT_ERROR;
+			}
+			event->type = status;
+			event->data[0] = data[0];
+			event->data[1] = data[1];
+		}
+	}
+
+	if (tick > *end_tick)
+	{
+		*end_tick = tick;
+	}
+
+	return RESULT_OK;
+}
+
+// Converts ticks to sample positions, keeping the running position scaled up so that
+// rounding doesn't accumulate across tempo changes.
+typedef struct tempo_map_t
+{
+	const event_list_t*	tempo_changes;
+	int					next_change;
+	uint32_t			base_tick;
+	int64_t				base_scaled;
+	int64_t				scale_per_tick;
+	int64_t				scale;
+	int					metrical;
+	int					ticks_per_quarter;
+} tempo_map_t;
+
+static void tempo_map_initialise(tempo_map_t* map, const event_list_t* tempo_changes, uint16_t division)
+{
+	memset(map, 0, sizeof(tempo_map_t));
+	map->tempo_changes = tempo_changes;
+
+	if (division & 0x8000)
+	{
+		// SMPTE timing: negative frame rate in the top byte, ticks per frame in the bottom.
+		int frames_per_second = -(int8_t)(division >> 8);
+		int ticks_per_frame = division & 0xff;
+
+		if (frames_per_second == 29)
+		{
+			map->scale_per_tick = SYSTEM_SAMPLE_RATE * 1001LL;
+			map->scale = 30000LL * ticks_per_frame;
+		}
+		else
+		{
+			map->scale_per_tick = SYSTEM_SAMPLE_RATE;
+			map->scale = (int64_t)frames_per_second * ticks_per_frame;
+		}
+	}
+	else
+	{
+		map->metrical = 1;
+		map->ticks_per_quarter = division;
+		map->scale_per_tick = (int64_t)DEFAULT_MICROSECONDS_PER_QUARTER * SYSTEM_SAMPLE_RATE;
+		map->scale = (int64_t)division * MICROSECONDS_PER_SECOND;
+	}
+}
+
+static int64_t tempo_map_get_sample_position(tempo_map_t* map, uint32_t tick)
+{
+	if (map->metrical)
+	{
+		while (map->next_change < map->tempo_changes->count && map->tempo_changes->events[map->next_change].tick <= tick)
+		{
+			const track_event_t* change = &map->tempo_changes->events[map->next_change++];
+			map->base_scaled += (int64_t)(change->tick - map->base_tick) * map->scale_per_tick;
+			map->base_tick = change->tick;
+			map->scale_per_tick = (int64_t)change->tempo * SYSTEM_SAMPLE_RATE;
+		}
+	}
+
+	return (map->base_scaled + (int64_t)(tick - map->base_tick) * map->scale_per_tick) / map->scale;
+}
+
+static int parse_midi_file(reader_t* reader, midi_file_t* midi_file)
+{
+	const unsigned char* chunk_id;
+	uint32_t header_length;
+	uint32_t format;
+	uint32_t track_count;
+	uint32_t division;
+
+	if (read_bytes(reader, 4, &chunk_id) != RESULT_OK || memcmp(chunk_id, "MThd", 4) != 0
+		|| read_big_endian(reader, 4, &header_length) != RESULT_OK || header_length < 6
+		|| read_big_endian(reader, 2, &format) != RESULT_OK
+		|| read_big_endian(reader, 2, &track_count) != RESULT_OK
+		|| read_big_endian(reader, 2, &division) != RESULT_OK)
+	{
+		push_custom_error("not a standard MIDI file");
+		return RESULT_ERROR;
+	}
+
+	if (format > 1)
+	{
+		push_custom_error("only format 0 and 1 MIDI files are supported");
+		return RESULT_ERROR;
+	}
+
+	// Either form of division needs a non-zero tick count; for SMPTE timing, that's the ticks per frame in the bottom byte.
+	if (division == 0 || ((division & 0x8000) && (division & 0xff) == 0))
+	{
+		push_custom_error("invalid time division");
+		return RESULT_ERROR;
+	}
+
+	const unsigned char* header_extra;
+	if (read_bytes(reader, header_length - 6, &header_extra) != RESULT_OK)
+	{
+		push_custom_error("truncated MIDI file");
+		return RESULT_ERROR;
+	}
+
+	event_list_t events = { 0, 0, NULL };
+	event_list_t tempo_changes = { 0, 0, NULL };
+	uint32_t end_tick = 0;
+	int result = RESULT_OK;
+
+	for (uint32_t i = 0; i < track_count && result == RESULT_OK; )
+	{
+		const unsigned char* track_data;
+		uint32_t chunk_length;
+
+		if (read_bytes(reader, 4, &chunk_id) != RESULT_OK || read_big_endian(reader, 4, &chunk_length) != RESULT_OK
+			|| read_bytes(reader, chunk_length, &track_data) != RESULT_OK)
+		{
+			push_custom_error("truncated MIDI file");
+			result = RESULT_ERROR;
+		}
+		else if (memcmp(chunk_id, "MTrk", 4) == 0)
+		{
+			reader_t track = { track_data, chunk_length, 0 };
+			if (read_track(&track, &events, &tempo_changes, &end_tick) != RESULT_OK)
+			{
+				push_custom_error("invalid MIDI track data");
+				result = RESULT_ERROR;
+			}
+			i++;
+		}
+	}
+
+	if (result == RESULT_OK)
+	{
+		qsort(events.events, events.count, sizeof(track_event_t), compare_events);
+		qsort(tempo_changes.events, tempo_changes.count, sizeof(track_event_t), compare_events);
+
+		midi_file->events = malloc((events.count > 0 ? events.count : 1) * sizeof(midi_file_event_t));
+		if (midi_file->events == NULL)
+		{
+			push_last_error();
+			result = RESULT_ERROR;
+		}
+		else
+		{
+			tempo_map_t tempo_map;
+			tempo_map_initialise(&tempo_map, &tempo_changes, division);
+
+			for (int i = 0; i < events.count; i++)
+			{
+				midi_file_event_t* event = &midi_file->events[i];
+				event->sample_position = tempo_map_get_sample_position(&tempo_map, events.events[i].tick);
+				event->type = events.events[i].type;
+				event->data[0] = events.events[i].data[0];
+				event->data[1] = events.events[i].data[1];
+			}
+
+			midi_file->event_count = events.count;
+			midi_file->length_samples = tempo_map_get_sample_position(&tempo_map, end_tick);
+		}
+	}
+
+	free(events.events);
+	free(tempo_changes.events);
+	return result;
+}
+
+int midi_file_load(const char* file_path, midi_file_t* midi_file)
+{
+	memset(midi_file, 0, sizeof(midi_file_t));
+
+	FILE* file = fopen(file_path, "rb");
+	if (file == NULL)
+	{
+		push_last_error();
+		goto error;
+	}
+
+	fseek(file, 0, SEEK_END);
+	long file_size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	unsigned char* file_data = malloc(file_size > 0 ? file_size : 1);
+	if (file_data == NULL || fread(file_data, 1, file_size, file) != (size_t)file_size)
+	{
+		push_last_error();
+		free(file_data);
+		fclose(file);
+		goto error;
+	}
+
+	fclose(file);
+
+	reader_t reader = { file_data, file_size, 0 };
+	int result = parse_midi_file(&reader, midi_file);
+	free(file_data);
+
+	if (result != RESULT_OK)
+	{
+		goto error;
+	}
+
+	return RESULT_OK;
+
+error:
+	pop_error_report("midi_file_load failed");
+	return RESULT_ERROR;
+}
+
+void midi_file_free(midi_file_t* midi_file)
+{
+	free(midi_file->events);
+	midi_file->events = NULL;
+	midi_file->event_count = 0;
+}
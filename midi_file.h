@@ -15,15 +15,35 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 /*
- * output_conversion_timing_test.h
+ * midi_file.h
  *
- *  Created on: 16 Feb 2013
+ *  Created on: 16 Oct 2026
  *      Author: ntuckett
+ *
+ *  Standard MIDI File (format 0 and 1) loading. All tracks are merged into one event list
+ *  ordered by time, with the tempo map applied to give each event a sample position.
  */
 
-#ifndef OUTPUT_CONVERSION_TIMING_TEST_H_
-#define OUTPUT_CONVERSION_TIMING_TEST_H_
+#ifndef MIDI_FILE_H_
+#define MIDI_FILE_H_
+
+#include <stdint.h>
+
+typedef struct midi_file_event_t
+{
+	int64_t			sample_position;
+	unsigned char	type;
+	unsigned char	data[2];
+} midi_file_event_t;
+
+typedef struct midi_file_t
+{
+	int					event_count;
+	midi_file_event_t*	events;
+	int64_t				length_samples;
+} midi_file_t;
 
-extern void output_conversion_timing_test(int count);
+extern int midi_file_load(const char* file_path, midi_file_t* midi_file);
+extern void midi_file_free(midi_file_t* midi_file);
 
-#endif /* OUTPUT_CONVERSION_TIMING_TEST_H_ */
+#endif /* MIDI_FILE_H_ */
@@ -23,50 +23,37 @@
 
 #include "mixer.h"
 
-void copy_mono_to_stereo(sample_t *source, int32_t left, int32_t right, int sample_count, sample_t *dest)
+// Bus samples are wide enough not to need clamping.
+void mixdown_bus_to_bus(bus_sample_t *source, int sample_count, bus_sample_t *dest)
 {
-	for (int i = 0; i < sample_count; i++)
+	for (int i = 0; i < sample_count * 2; i++)
 	{
-		int32_t original_sample = *source;
+		*dest++ += *source++;
+	}
+}
 
-		int32_t mixed_sample = (original_sample * left) / PAN_MAX;
-		*dest++ = mixed_sample;
+void mixer_dither_init(mixer_dither_t *dither)
+{
+	dither->random_state = 0x2545f491;
+}
 
-		mixed_sample = (original_sample * right) / PAN_MAX;
-		*dest++ = mixed_sample;
-		source++;
-	}
+static inline uint32_t mixer_dither_random(mixer_dither_t *dither)
+{
+	dither->random_state ^= dither->random_state << 13;
+	dither->random_state ^= dither->random_state >> 17;
+	dither->random_state ^= dither->random_state << 5;
+	return dither->random_state;
 }
 
-void mixdown_mono_to_stereo(sample_t *source, int32_t left, int32_t right, int sample_count, sample_t *dest)
+// The difference of two uniform values in 0 to 1 LSB has a triangular distribution over -1 to +1 LSB.
+// Each random number gives the four values for a left & right pair, so MIXER_BUS_PRECISION can be at most 8.
+void mixer_dither_bus(mixer_dither_t *dither, bus_sample_t *bus, int sample_count)
 {
 	for (int i = 0; i < sample_count; i++)
 	{
-		int32_t original_sample = *source;
-
-		int32_t mixed_sample = (original_sample * left) / PAN_MAX + *dest;
-
-		if (mixed_sample < -SAMPLE_MAX)
-		{
-			mixed_sample = -SAMPLE_MAX;
-		}
-		else if (mixed_sample > SAMPLE_MAX)
-		{
-			mixed_sample = SAMPLE_MAX;
-		}
-		*dest++ = mixed_sample;
-
-		mixed_sample = (original_sample * right) / PAN_MAX + *dest;
+		uint32_t random = mixer_dither_random(dither);
 
-		if (mixed_sample < -SAMPLE_MAX)
-		{
-			mixed_sample = -SAMPLE_MAX;
-		}
-		else if (mixed_sample > SAMPLE_MAX)
-		{
-			mixed_sample = SAMPLE_MAX;
-		}
-		*dest++ = mixed_sample;
-		source++;
+		*bus++ += (int32_t)(random & (MIXER_BUS_ONE - 1)) - (int32_t)((random >> 8) & (MIXER_BUS_ONE - 1));
+		*bus++ += (int32_t)((random >> 16) & (MIXER_BUS_ONE - 1)) - (int32_t)(random >> 24 & (MIXER_BUS_ONE - 1));
 	}
 }
@@ -24,12 +24,25 @@
 #ifndef MIXER_H_
 #define MIXER_H_
 
+#include <stdint.h>
 #include "system_constants.h"
 
-extern void copy_mono_to_stereo(sample_t *source, int32_t left, int32_t right, int sample_count, sample_t *dest);
-extern void mixdown_mono_to_stereo(sample_t *source, int32_t left, int32_t right, int sample_count, sample_t *dest);
+// Voices are summed on a 32-bit stereo bus, which carries MIXER_BUS_PRECISION bits below a sample_t's
+// least significant bit. It is only rounded and saturated to sample_t once every voice has been added,
+// so clipping doesn't depend on the order voices are mixed in, and there is headroom for 256 full scale voices.
+#define MIXER_BUS_PRECISION		8
+#define MIXER_BUS_ONE			(1 << MIXER_BUS_PRECISION)
 
-extern void copy_mono_to_stereo_asm(sample_t *source, int32_t left, int32_t right, int sample_count, sample_t *dest);
-extern void mixdown_mono_to_stereo_asm(sample_t *source, int32_t left, int32_t right, int sample_count, sample_t *dest);
+typedef int32_t bus_sample_t;
+
+// TPDF (triangular) dither of +/-1 sample_t LSB, added to the bus before it is rounded to sample_t.
+typedef struct mixer_dither_t
+{
+	uint32_t	random_state;
+} mixer_dither_t;
+
+extern void mixdown_bus_to_bus(bus_sample_t *source, int sample_count, bus_sample_t *dest);
+extern void mixer_dither_init(mixer_dither_t *dither);
+extern void mixer_dither_bus(mixer_dither_t *dither, bus_sample_t *bus, int sample_count);
 
 #endif /* MIXER_H_ */
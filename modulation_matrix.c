@@ -43,6 +43,11 @@ typedef struct mod_matrix_connection_t
 
 mod_matrix_connection_t	connections[MOD_MATRIX_MAX_CONNECTIONS];
 
+// The live connections packed in sink order, rebuilt whenever they change, so updates skip empty slots.
+// Connections to the same sink keep their slot order, as some sinks take the last value applied.
+static mod_matrix_connection_t	plan[MOD_MATRIX_MAX_CONNECTIONS];
+static int						plan_count = 0;
+
 typedef struct mod_matrix_callback_info_t mod_matrix_callback_info_t;
 typedef struct mod_matrix_callback_info_t
 {
@@ -60,6 +65,7 @@ void mod_matrix_initialise()
 	source_count	= 0;
 	sink_count		= 0;
 	memset(connections, 0, sizeof(connections));
+	plan_count		= 0;
 
 	for (int i = 0; i < MAX_MOD_MATRIX_CALLBACKS; i++)
 	{
@@ -68,12 +74,13 @@ void mod_matrix_initialise()
 	}
 }
 
-void mod_matrix_init_source(const char* name, generate_mod_matrix_value_t generate_value, get_mod_matrix_value_t get_value, mod_matrix_source_t* source)
+void mod_matrix_init_source(const char* name, generate_mod_matrix_value_t generate_value, get_mod_matrix_value_t get_value, get_mod_matrix_values_t get_values, mod_matrix_source_t* source)
 {
 	strncpy(source->name, name, MOD_MATRIX_MAX_NAME_LEN);
 	source->name[MOD_MATRIX_MAX_NAME_LEN] = 0;
 	source->generate_value = generate_value;
 	source->get_value = get_value;
+	source->get_values = get_values;
 }
 
 void mod_matrix_init_sink(const char* name, base_update_t base_update, model_update_t model_update, mod_matrix_sink_t* sink)
@@ -219,6 +226,22 @@ mod_matrix_connection_t* find_connection(mod_matrix_source_t* source, mod_matrix
 	return NULL;
 }
 
+static void compile_plan()
+{
+	plan_count = 0;
+
+	for (int i = 0; i < sink_count; i++)
+	{
+		for (int j = 0; j < MOD_MATRIX_MAX_CONNECTIONS; j++)
+		{
+			if (connections[j].sink == sinks[i] && connections[j].source != NULL)
+			{
+				plan[plan_count++] = connections[j];
+			}
+		}
+	}
+}
+
 mod_matrix_connection_t* connect(mod_matrix_source_t* source, mod_matrix_sink_t* sink)
 {
 	mod_matrix_connection_t* connection = find_free_connection();
@@ -227,6 +250,7 @@ mod_matrix_connection_t* connect(mod_matrix_source_t* source, mod_matrix_sink_t*
 	{
 		connection->source 	= source;
 		connection->sink	= sink;
+		compile_plan();
 		mod_matrix_make_callback(MOD_MATRIX_EVENT_CONNECTION, source, sink);
 	}
 
@@ -238,6 +262,7 @@ void disconnect(mod_matrix_connection_t* connection)
 	mod_matrix_make_callback(MOD_MATRIX_EVENT_DISCONNECTION, connection->source, connection->sink);
 	connection->source 	= NULL;
 	connection->sink	= NULL;
+	compile_plan();
 }
 
 int mod_matrix_connect(const char* source_name, const char* sink_name)
@@ -354,6 +379,21 @@ int mod_matrix_toggle_connection(const char* source_name, const char* sink_name)
 	}
 }
 
+void mod_matrix_get_values(mod_matrix_source_t* source, const int* subsource_ids, int count, mod_matrix_value_t* values)
+{
+	if (source->get_values != NULL)
+	{
+		source->get_values(source, subsource_ids, count, values);
+	}
+	else
+	{
+		for (int i = 0; i < count; i++)
+		{
+			values[i] = source->get_value(source, subsource_ids[i]);
+		}
+	}
+}
+
 void mod_matrix_update(void* data)
 {
 	for (int i = 0; i < source_count; i++)
@@ -372,14 +412,9 @@ void mod_matrix_update(void* data)
 		}
 	}
 
-	mod_matrix_connection_t* connection = connections;
-
-	for (int i = 0; i < MOD_MATRIX_MAX_CONNECTIONS; i++, connection++)
+	for (int i = 0; i < plan_count; i++)
 	{
-		if (connection->source != NULL && connection->sink != NULL)
-		{
-			connection->sink->model_update(connection->source, connection->sink);
-		}
+		plan[i].sink->model_update(plan[i].source, plan[i].sink);
 	}
 }
 
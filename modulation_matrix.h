@@ -42,6 +42,7 @@ typedef struct mod_matrix_sink_t mod_matrix_sink_t;
 
 typedef void (*generate_mod_matrix_value_t)(mod_matrix_source_t* source, void* data);
 typedef mod_matrix_value_t (*get_mod_matrix_value_t)(mod_matrix_source_t* source, int subsource_id);
+typedef void (*get_mod_matrix_values_t)(mod_matrix_source_t* source, const int* subsource_ids, int count, mod_matrix_value_t* values);
 typedef void (*base_update_t)(mod_matrix_sink_t* sink, void* data);
 typedef void (*model_update_t)(mod_matrix_source_t* source, mod_matrix_sink_t* sink);
 
@@ -52,6 +53,7 @@ struct mod_matrix_source_t
 	char 						name[MOD_MATRIX_MAX_NAME_LEN + 1];
 	generate_mod_matrix_value_t	generate_value;
 	get_mod_matrix_value_t		get_value;
+	get_mod_matrix_values_t		get_values;		// optional batch version of get_value
 };
 
 struct mod_matrix_sink_t
@@ -70,7 +72,7 @@ typedef enum mod_matrix_event_t
 typedef void (*mod_matrix_callback_t)(mod_matrix_event_t callback_event, mod_matrix_source_t* source, mod_matrix_sink_t* sink, void* callback_data);
 
 extern void mod_matrix_initialise();
-extern void mod_matrix_init_source(const char* name, generate_mod_matrix_value_t generate_value, get_mod_matrix_value_t get_value, mod_matrix_source_t* source);
+extern void mod_matrix_init_source(const char* name, generate_mod_matrix_value_t generate_value, get_mod_matrix_value_t get_value, get_mod_matrix_values_t get_values, mod_matrix_source_t* source);
 extern void mod_matrix_init_sink(const char* name, base_update_t base_update, model_update_t model_update, mod_matrix_sink_t* sink);
 extern void mod_matrix_add_callback(mod_matrix_callback_t callback, void* callback_data);
 extern void mod_matrix_remove_callback(mod_matrix_callback_t callback);
@@ -82,6 +84,7 @@ extern int mod_matrix_disconnect(const char* source_name, const char* sink_name)
 extern void mod_matrix_disconnect_source(const char* source_name);
 extern int mod_matrix_toggle_connection(const char* source_name, const char* sink_name);
 extern void mod_matrix_iterate_connections(void* data, connection_callback_t callback);
+extern void mod_matrix_get_values(mod_matrix_source_t* source, const int* subsource_ids, int count, mod_matrix_value_t* values);
 extern void mod_matrix_update(void* data);
 
 #endif /* MODULATION_MATRIX_H_ */
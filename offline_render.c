@@ -0,0 +1,154 @@
+// Pithesiser - a software synthesiser for Raspberry Pi
+// Copyright (C) 2015 Nicholas Tuckett
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * offline_render.c
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: ntuckett
+ *
+ *  Blocks are split at event positions so notes start and stop where the file says they do.
+ *  The mixers work on sample pairs, so positions are rounded down to an even sample.
+ *  The synth is monotimbral, so notes from every channel are played on the note channel.
+ *  Time in the synth is derived from the number of samples rendered, never the wall clock.
+ */
+
+#include "offline_render.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sndfile.h>
+#include "system_constants.h"
+#include "logging.h"
+#include "synth_model.h"
+
+// Time allowed after the end of the file for released notes to finish.
+#define TAIL_SAMPLES_MAX	(SYSTEM_SAMPLE_RATE * 10)
+
+static int64_t samples_to_ms(int64_t samples)
+{
+	return (samples * 1000) / SYSTEM_SAMPLE_RATE;
+}
+
+static double elapsed_seconds(struct timespec* start)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1000000000.0;
+}
+
+static void dispatch_event(synth_model_t* synth_model, const midi_file_event_t* event, int note_channel)
+{
+	unsigned char event_type = event->type & 0xf0;
+
+	if (event_type == 0x90)
+	{
+		synth_model_play_note(synth_model, note_channel, event->data[0]);
+	}
+	else if (event_type == 0x80)
+	{
+		synth_model_stop_note(synth_model, note_channel, event->data[0]);
+	}
+}
+
+int offline_render(synth_model_t* synth_model, const midi_file_t* midi_file, int note_channel, const char* output_path, int block_size)
+{
+	SF_INFO sndinfo;
+	memset(&sndinfo, 0, sizeof(sndinfo));
+	sndinfo.samplerate = SYSTEM_SAMPLE_RATE;
+	sndinfo.channels = CHANNELS_PER_SAMPLE;
+	sndinfo.format = SF_FORMAT_WAV | SF_FORMAT_PCM_16;
+
+	SNDFILE* sndfile = sf_open(output_path, SFM_WRITE, &sndinfo);
+	if (sndfile == NULL)
+	{
+		LOG_ERROR("Offline render: cannot open %s: %s", output_path, sf_strerror(NULL));
+		return RESULT_ERROR;
+	}
+
+	block_size &= ~1;
+	sample_t* buffer = malloc(block_size * BYTES_PER_SAMPLE);
+	if (block_size <= 0 || buffer == NULL)
+	{
+		LOG_ERROR("Offline render: cannot allocate %d sample block", block_size);
+		sf_close(sndfile);
+		return RESULT_ERROR;
+	}
+
+	struct timespec start_time;
+	clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+	int64_t position = 0;
+	int64_t end_position = midi_file->length_samples;
+	int next_event = 0;
+	int result = RESULT_OK;
+
+	while (1)
+	{
+		while (next_event < midi_file->event_count && (midi_file->events[next_event].sample_position & ~1) <= position)
+		{
+			dispatch_event(synth_model, &midi_file->events[next_event++], note_channel);
+		}
+
+		if (next_event == midi_file->event_count && position >= end_position)
+		{
+			if (synth_model->active_voices == 0 || position >= end_position + TAIL_SAMPLES_MAX)
+			{
+				break;
+			}
+		}
+
+		int64_t block_end = position + block_size;
+		if (next_event < midi_file->event_count)
+		{
+			int64_t event_position = midi_file->events[next_event].sample_position & ~1;
+			if (event_position < block_end)
+			{
+				block_end = event_position;
+			}
+		}
+
+		synth_update_state_t update_state;
+		update_state.timestep_ms = samples_to_ms(block_end) - samples_to_ms(position);
+		update_state.sample_count = block_end - position;
+		update_state.buffer_data = buffer;
+		synth_model_update(synth_model, &update_state);
+
+		if (sf_writef_short(sndfile, buffer, update_state.sample_count) != update_state.sample_count)
+		{
+			LOG_ERROR("Offline render: write to %s failed: %s", output_path, sf_strerror(sndfile));
+			result = RESULT_ERROR;
+			break;
+		}
+
+		position = block_end;
+	}
+
+	double render_seconds = elapsed_seconds(&start_time);
+	double audio_seconds = (double)position / SYSTEM_SAMPLE_RATE;
+
+	sf_write_sync(sndfile);
+	sf_close(sndfile);
+	free(buffer);
+
+	if (result == RESULT_OK)
+	{
+		LOG_INFO("Offline render: %.2fs of audio in %.3fs (%.1fx realtime)", audio_seconds, render_seconds,
+				 render_seconds > 0.0 ? audio_seconds / render_seconds : 0.0);
+	}
+
+	return result;
+}
@@ -15,17 +15,21 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 /*
- * code_timing_tests.h
+ * offline_render.h
  *
- *  Created on: 15 Feb 2013
+ *  Created on: 16 Oct 2026
  *      Author: ntuckett
+ *
+ *  Renders a MIDI file through the synth model as fast as possible, writing the result to a WAV file.
  */
 
-#ifndef CODE_TIMING_TESTS_H_
-#define CODE_TIMING_TESTS_H_
+#ifndef OFFLINE_RENDER_H_
+#define OFFLINE_RENDER_H_
+
+#include "midi_file.h"
 
-#include "libconfig.h"
+typedef struct synth_model_t synth_model_t;
 
-extern void code_timing_tests_main(config_setting_t *config);
+extern int offline_render(synth_model_t* synth_model, const midi_file_t* midi_file, int note_channel, const char* output_path, int block_size);
 
-#endif /* CODE_TIMING_TESTS_H_ */
+#endif /* OFFLINE_RENDER_H_ */
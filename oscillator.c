@@ -31,6 +31,7 @@ void osc_init(oscillator_t* osc)
 	osc->waveform 			= WAVETABLE_SINE;
 	osc->frequency			= 440;
 	osc->phase_accumulator 	= 0;
+	osc->pulse_width		= FIXED_HALF;
 	osc->level 				= 0;
 	osc->last_level			= 0;
 }
@@ -61,3 +62,34 @@ void osc_mid_output(oscillator_t* osc, sample_t *sample_data, int sample_count)
 		generator->mid_func(&generator->definition, osc, sample_data, sample_count);
 	}
 }
+
+// Generates, filters and pans onto the mix bus in one pass.
+// Returns FALSE if the waveform has no fused generator or the filter is a modulated type, in which case nothing is output.
+int osc_voice_output(oscillator_t* osc, filter_t* filter, int32_t left, int32_t right, bus_sample_t *bus, int sample_count)
+{
+	waveform_generator_t *generator = &generators[osc->waveform];
+	if (FILTER_IS_MODULATED(filter->definition.type))
+	{
+		return FALSE;
+	}
+
+	int filter_mode;
+	if (filter->definition.type == FILTER_PASS)
+	{
+		filter_mode = VOICE_FILTER_NONE;
+	}
+	else
+	{
+		filter_mode = filter->updated ? VOICE_FILTER_INTERP : VOICE_FILTER_APPLY;
+	}
+
+	generator_voice_func_t voice_func = generator->voice_func[filter_mode];
+	if (voice_func == NULL)
+	{
+		return FALSE;
+	}
+
+	voice_output_t output = { filter, left, right, bus };
+	voice_func(&generator->definition, osc, &output, sample_count);
+	return TRUE;
+}
@@ -32,12 +32,19 @@
 #include <sys/types.h>
 #include "system_constants.h"
 #include "waveform.h"
+#include "filter.h"
+#include "mixer.h"
+
+// Limits of the fraction of the cycle that a pulse wave is high for.
+#define OSC_MIN_PULSE_WIDTH		(FIXED_ONE / 20)
+#define OSC_MAX_PULSE_WIDTH		(FIXED_ONE - OSC_MIN_PULSE_WIDTH)
 
 typedef struct oscillator_t
 {
 	waveform_type_t		waveform;
 	fixed_t				frequency;
 	fixed_t				phase_accumulator;
+	fixed_t				pulse_width;
 	int32_t				level;
 	int32_t				last_level;
 } oscillator_t;
@@ -46,5 +53,6 @@ extern void osc_init(oscillator_t* osc);
 extern void osc_output(oscillator_t* osc, sample_t *sample_data, int sample_count);
 extern void osc_mix_output(oscillator_t* osc, sample_t *sample_data, int sample_count);
 extern void osc_mid_output(oscillator_t* osc, sample_t *sample_data, int sample_count);
+extern int osc_voice_output(oscillator_t* osc, filter_t* filter, int32_t left, int32_t right, bus_sample_t *bus, int sample_count);
 
 #endif /* OSCILLATOR_H_ */
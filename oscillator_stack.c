@@ -0,0 +1,171 @@
+// Pithesiser - a software synthesiser for Raspberry Pi
+// Copyright (C) 2015 Nicholas Tuckett
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * oscillator_stack.c
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: ntuckett
+ */
+
+#include "oscillator_stack.h"
+#include <string.h>
+#include <math.h>
+#include "fixed_point_math.h"
+#include "waveform_internal.h"
+#include "waveform_wavetable.h"
+
+// Unison phases start a golden ratio of a cycle apart, so the oscillators don't line up at the start of each note.
+#define OSC_STACK_UNISON_PHASE_STEP		0x9e3779b9U
+
+void osc_stack_init(osc_stack_t* stack)
+{
+	stack->count = 1;
+	stack->unison = FALSE;
+
+	for (int i = 0; i < OSC_STACK_MAX_OSCILLATORS; i++)
+	{
+		osc_init(stack->oscillator + i);
+		stack->detune[i] = FIXED_ONE;
+	}
+}
+
+static float osc_stack_clamp_level(float level)
+{
+	return level < 0.0f ? 0.0f : level > 1.0f ? 1.0f : level;
+}
+
+void osc_stack_set_definition(osc_stack_t* stack, const osc_stack_def_t* def)
+{
+	int count = def->count < 1 ? 1 : def->count > OSC_STACK_MAX_OSCILLATORS ? OSC_STACK_MAX_OSCILLATORS : def->count;
+
+	stack->count = count;
+	stack->unison = def->unison;
+
+	// The stack is mixed with saturation before the voice level is applied, so levels are scaled to sum to at most
+	// full level; otherwise even a quiet note would clip.
+	float level_sum = 0.0f;
+	for (int i = 0; i < count && !def->unison; i++)
+	{
+		level_sum += osc_stack_clamp_level(def->oscillator[i].level);
+	}
+	float level_scale = level_sum > 1.0f ? 1.0f / level_sum : 1.0f;
+
+	for (int i = 0; i < count; i++)
+	{
+		oscillator_t* osc = stack->oscillator + i;
+		float detune, level;
+
+		if (def->unison)
+		{
+			detune = count > 1 ? def->spread * ((2.0f * i) / (count - 1) - 1.0f) : 0.0f;
+			level = 1.0f / count;
+		}
+		else
+		{
+			detune = def->oscillator[i].detune;
+			level = osc_stack_clamp_level(def->oscillator[i].level) * level_scale;
+			osc->waveform = def->oscillator[i].waveform;
+		}
+
+		stack->detune[i] = DOUBLE_TO_FIXED(pow(2.0, detune / 1200.0));
+		osc->level = level * LEVEL_MAX;
+		osc->last_level = osc->level;
+	}
+}
+
+void osc_stack_reset(osc_stack_t* stack)
+{
+	for (int i = 0; i < stack->count; i++)
+	{
+		stack->oscillator[i].phase_accumulator = stack->unison ? (fixed_t)(i * OSC_STACK_UNISON_PHASE_STEP) : 0;
+	}
+}
+
+// Oscillators reading the same table are mixed in one pass by the unison kernel, which advances all their phases
+// together; for a unison stack of a wavetable waveform, that is every oscillator. Others are mixed one at a time.
+// The stack is mixed at the oscillator levels, then scaled by the voice level.
+void osc_stack_output(osc_stack_t* stack, oscillator_t* voice_osc, sample_t *sample_data, int sample_count)
+{
+	const sample_t* table[OSC_STACK_MAX_OSCILLATORS];
+	int size_bits[OSC_STACK_MAX_OSCILLATORS];
+	uint32_t phase_step[OSC_STACK_MAX_OSCILLATORS];
+
+	memset(sample_data, 0, sample_count * sizeof(sample_t));
+
+	for (int i = 0; i < stack->count; i++)
+	{
+		oscillator_t* osc = stack->oscillator + i;
+
+		if (stack->unison)
+		{
+			osc->waveform = voice_osc->waveform;
+		}
+		osc->frequency = fixed_mul(voice_osc->frequency, stack->detune[i]);
+		osc->pulse_width = voice_osc->pulse_width;
+
+		table[i] = wavetable_select(osc->waveform, osc->frequency, size_bits + i, phase_step + i);
+		if (table[i] == NULL)
+		{
+			osc_mix_output(osc, sample_data, sample_count);
+		}
+	}
+
+	for (int i = 0; i < stack->count; i++)
+	{
+		const sample_t* group_table = table[i];
+		if (group_table == NULL)
+		{
+			continue;
+		}
+
+		int group_osc[OSC_STACK_MAX_OSCILLATORS];
+		uint32_t group_phase[OSC_STACK_MAX_OSCILLATORS];
+		uint32_t group_phase_step[OSC_STACK_MAX_OSCILLATORS];
+		int32_t group_level[OSC_STACK_MAX_OSCILLATORS];
+		int group_count = 0;
+
+		for (int j = i; j < stack->count; j++)
+		{
+			if (table[j] == group_table)
+			{
+				group_osc[group_count] = j;
+				group_phase[group_count] = (uint32_t)stack->oscillator[j].phase_accumulator;
+				group_phase_step[group_count] = phase_step[j];
+				group_level[group_count] = stack->oscillator[j].level;
+				group_count++;
+				table[j] = NULL;
+			}
+		}
+
+		dsp_kernels->wavetable_unison(group_table, size_bits[i], group_count, group_phase, group_phase_step, group_level, sample_count, sample_data);
+
+		for (int j = 0; j < group_count; j++)
+		{
+			stack->oscillator[group_osc[j]].phase_accumulator = (fixed_t)group_phase[j];
+		}
+	}
+
+	CALC_AMPLITUDE_INTERPOLATION(voice_osc, amp_scale, amp_delta, sample_count);
+
+	for (int i = 0; i < sample_count; i++)
+	{
+		int32_t sample = sample_data[i];
+		SCALE_AMPLITUDE((amp_scale >> AMPL_INTERP_PRECISION), sample);
+		sample_data[i] = (sample_t)sample;
+		INTERPOLATE_AMPLITUDE(amp_scale, amp_delta);
+	}
+}
@@ -0,0 +1,67 @@
+// Pithesiser - a software synthesiser for Raspberry Pi
+// Copyright (C) 2015 Nicholas Tuckett
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * oscillator_stack.h
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: ntuckett
+ *
+ *  Several oscillators played together by one voice, each detuned from the voice's pitch.
+ *  In unison mode every oscillator plays the voice waveform, detuned evenly across the spread (e.g. a supersaw);
+ *  otherwise each has its own waveform, detune & level. Either way, the levels sum to at most full level.
+ *  The voice oscillator supplies the pitch, pulse width & level, so modulation applies to the whole stack.
+ */
+
+#ifndef OSCILLATOR_STACK_H_
+#define OSCILLATOR_STACK_H_
+
+#include "oscillator.h"
+#include "dsp_kernel.h"
+
+#define OSC_STACK_MAX_OSCILLATORS	DSP_UNISON_MAX_OSCILLATORS
+
+typedef struct osc_stack_oscillator_def_t
+{
+	waveform_type_t	waveform;
+	float			detune;			// In cents
+	float			level;			// From 0 to 1
+} osc_stack_oscillator_def_t;
+
+typedef struct osc_stack_def_t
+{
+	int							count;			// A count of 1 plays the voice oscillator alone
+	int							unison;
+	float						spread;			// Unison detune either side of the note, in cents
+	osc_stack_oscillator_def_t	oscillator[OSC_STACK_MAX_OSCILLATORS];
+} osc_stack_def_t;
+
+typedef struct osc_stack_t
+{
+	int				count;
+	int				unison;
+	fixed_t			detune[OSC_STACK_MAX_OSCILLATORS];		// Frequency ratios
+	oscillator_t	oscillator[OSC_STACK_MAX_OSCILLATORS];
+} osc_stack_t;
+
+#define OSC_STACK_ACTIVE(stack)		((stack)->count > 1)
+
+extern void osc_stack_init(osc_stack_t* stack);
+extern void osc_stack_set_definition(osc_stack_t* stack, const osc_stack_def_t* def);
+extern void osc_stack_reset(osc_stack_t* stack);
+extern void osc_stack_output(osc_stack_t* stack, oscillator_t* voice_osc, sample_t *sample_data, int sample_count);
+
+#endif /* OSCILLATOR_STACK_H_ */
@@ -0,0 +1,150 @@
+// Pithesiser - a software synthesiser for Raspberry Pi
+// Copyright (C) 2015 Nicholas Tuckett
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * render_pool.c
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: ntuckett
+ *
+ *  Each additional worker sleeps on its own start semaphore. Running a job posts every
+ *  start semaphore, runs worker 0 on the calling thread, then waits on the shared done
+ *  semaphore once per additional worker - so the job has completed on all workers when
+ *  render_pool_run returns, and no locks are held while rendering.
+ */
+
+#define _GNU_SOURCE
+
+#include "render_pool.h"
+#include <stdio.h>
+#include <unistd.h>
+#include <sched.h>
+#include "system_constants.h"
+#include "logging.h"
+
+static void* render_pool_worker_thread(void* data)
+{
+	render_pool_worker_t* worker = (render_pool_worker_t*)data;
+	render_pool_t* pool = worker->pool;
+
+	char thread_name[16];
+	snprintf(thread_name, sizeof(thread_name), "pithesiser-rnd%d", worker->index);
+	pthread_setname_np(pthread_self(), thread_name);
+
+	while (1)
+	{
+		sem_wait(&worker->start_semaphore);
+
+		if (pool->exiting)
+		{
+			break;
+		}
+
+		pool->job(worker->index, pool->job_data);
+		sem_post(&pool->done_semaphore);
+	}
+
+	return NULL;
+}
+
+static void render_pool_set_affinity(render_pool_worker_t* worker)
+{
+	long core_count = sysconf(_SC_NPROCESSORS_ONLN);
+
+	if (core_count > 1)
+	{
+		cpu_set_t cpu_set;
+		CPU_ZERO(&cpu_set);
+		CPU_SET(worker->index % core_count, &cpu_set);
+		pthread_setaffinity_np(worker->thread_handle, sizeof(cpu_set), &cpu_set);
+	}
+}
+
+int render_pool_initialise(render_pool_t* pool, int worker_count)
+{
+	if (worker_count < 1 || worker_count > RENDER_POOL_MAX_WORKERS)
+	{
+		LOG_ERROR("Invalid render worker count %d - should be between 1 and %d", worker_count, RENDER_POOL_MAX_WORKERS);
+		return RESULT_ERROR;
+	}
+
+	pool->worker_count	= 1;
+	pool->exiting		= FALSE;
+	pool->job			= NULL;
+	pool->job_data		= NULL;
+	sem_init(&pool->done_semaphore, 0, 0);
+
+	pool->worker[0].pool	= pool;
+	pool->worker[0].index	= 0;
+
+	for (int i = 1; i < worker_count; i++)
+	{
+		render_pool_worker_t* worker = pool->worker + i;
+		worker->pool	= pool;
+		worker->index	= i;
+		sem_init(&worker->start_semaphore, 0, 0);
+
+		if (pthread_create(&worker->thread_handle, NULL, render_pool_worker_thread, worker) != 0)
+		{
+			LOG_ERROR("Failed to create render worker %d", i);
+			sem_destroy(&worker->start_semaphore);
+			render_pool_deinitialise(pool);
+			return RESULT_ERROR;
+		}
+
+		render_pool_set_affinity(worker);
+		pool->worker_count++;
+	}
+
+	return RESULT_OK;
+}
+
+void render_pool_run(render_pool_t* pool, render_pool_job_t job, void* job_data)
+{
+	pool->job		= job;
+	pool->job_data	= job_data;
+
+	for (int i = 1; i < pool->worker_count; i++)
+	{
+		sem_post(&pool->worker[i].start_semaphore);
+	}
+
+	job(0, job_data);
+
+	for (int i = 1; i < pool->worker_count; i++)
+	{
+		sem_wait(&pool->done_semaphore);
+	}
+}
+
+void render_pool_deinitialise(render_pool_t* pool)
+{
+	pool->exiting = TRUE;
+
+	for (int i = 1; i < pool->worker_count; i++)
+	{
+		sem_post(&pool->worker[i].start_semaphore);
+	}
+
+	for (int i = 1; i < pool->worker_count; i++)
+	{
+		pthread_join(pool->worker[i].thread_handle, NULL);
+		sem_destroy(&pool->worker[i].start_semaphore);
+	}
+
+	sem_destroy(&pool->done_semaphore);
+	pool->worker_count = 0;
+}
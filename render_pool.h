@@ -0,0 +1,62 @@
+// Pithesiser - a software synthesiser for Raspberry Pi
+// Copyright (C) 2015 Nicholas Tuckett
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * render_pool.h
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: ntuckett
+ *
+ *  Persistent pool of worker threads used to spread audio rendering across cores.
+ *  The calling thread always acts as worker 0, so a pool of one worker runs the job inline.
+ */
+
+#ifndef RENDER_POOL_H_
+#define RENDER_POOL_H_
+
+#include <pthread.h>
+#include <semaphore.h>
+
+#define RENDER_POOL_MAX_WORKERS		8
+
+typedef void (*render_pool_job_t)(int worker_index, void* job_data);
+
+typedef struct render_pool_worker_t render_pool_worker_t;
+typedef struct render_pool_t render_pool_t;
+
+struct render_pool_worker_t
+{
+	render_pool_t*	pool;
+	int				index;
+	pthread_t		thread_handle;
+	sem_t			start_semaphore;
+};
+
+struct render_pool_t
+{
+	int						worker_count;
+	int						exiting;
+	render_pool_job_t		job;
+	void*					job_data;
+	sem_t					done_semaphore;
+	render_pool_worker_t	worker[RENDER_POOL_MAX_WORKERS];
+};
+
+extern int render_pool_initialise(render_pool_t* pool, int worker_count);
+extern void render_pool_run(render_pool_t* pool, render_pool_job_t job, void* job_data);
+extern void render_pool_deinitialise(render_pool_t* pool);
+
+#endif /* RENDER_POOL_H_ */
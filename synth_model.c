@@ -31,6 +31,8 @@
 #include "lfo.h"
 #include "setting.h"
 #include "mixer.h"
+#include "dsp_kernel.h"
+#include "filter_bank.h"
 
 const char*	SYNTH_MOD_SOURCE_LFO			= "lfo";
 const char*	SYNTH_MOD_SOURCE_ENVELOPE_1		= "envelope-1";
@@ -43,6 +45,7 @@ const char*	SYNTH_MOD_SINK_FILTER_Q			= "filter-q";
 const char*	SYNTH_MOD_SINK_FILTER_FREQ		= "filter-freq";
 const char*	SYNTH_MOD_SINK_LFO_AMPLITUDE	= "lfo-amplitude";
 const char*	SYNTH_MOD_SINK_LFO_FREQ			= "lfo-freq";
+const char*	SYNTH_MOD_SINK_PULSE_WIDTH		= "pulse-width";
 
 //=========================================================================================================================
 // Internal synth model function forward declarations
@@ -88,6 +91,17 @@ static mod_matrix_value_t lfo_get_value(mod_matrix_source_t* source, int subsour
 	return (mod_matrix_value_t) lfo_source->lfo.value;
 }
 
+static void lfo_get_values(mod_matrix_source_t* source, const int* subsource_ids, int count, mod_matrix_value_t* values)
+{
+	lfo_source_t* lfo_source = (lfo_source_t*)source;
+	mod_matrix_value_t value = (mod_matrix_value_t) lfo_source->lfo.value;
+
+	for (int i = 0; i < count; i++)
+	{
+		values[i] = value;
+	}
+}
+
 static void lfo_amplitude_base_update(mod_matrix_sink_t* sink, void* data)
 {
 	synth_model_param_sink_t* param_sink = (synth_model_param_sink_t*)sink;
@@ -138,43 +152,42 @@ static void lfo_freq_model_update(mod_matrix_source_t* source, mod_matrix_sink_t
 //-------------------------------------------------------------------------------------------------------------------------
 // Voice modulation
 //
+// Source values for all the active voices are fetched in one batch, in active voice order.
+static mod_matrix_value_t* synth_model_get_voice_values(synth_model_t* synth_model, mod_matrix_source_t* source)
+{
+	mod_matrix_get_values(source, synth_model->active_voice, synth_model->active_voices, synth_model->voice_mod_values);
+	return synth_model->voice_mod_values;
+}
+
 static void voice_amplitude_base_update(mod_matrix_sink_t* sink, void* data)
 {
 	synth_model_param_sink_t* param_sink = (synth_model_param_sink_t*)sink;
-	voice_t* voice = param_sink->synth_model->voice;
+	synth_model_t* synth_model = param_sink->synth_model;
 
-	for (int i = 0; i < param_sink->synth_model->voice_count; i++, voice++)
+	for (int i = 0; i < synth_model->active_voices; i++)
 	{
-		if (voice->current_state != NOTE_NOT_PLAYING)
-		{
-			voice->oscillator.level = LEVEL_MAX;
-		}
-		else
-		{
-			voice->oscillator.level = 0;
-		}
+		synth_model->voice[synth_model->active_voice[i]].oscillator.level = LEVEL_MAX;
 	}
 }
 
 static void voice_amplitude_model_update(mod_matrix_source_t* source, mod_matrix_sink_t* sink)
 {
 	synth_model_param_sink_t* param_sink = (synth_model_param_sink_t*)sink;
-	voice_t* voice = param_sink->synth_model->voice;
+	synth_model_t* synth_model = param_sink->synth_model;
+	mod_matrix_value_t* source_values = synth_model_get_voice_values(synth_model, source);
 
-	for (int i = 0; i < param_sink->synth_model->voice_count; i++, voice++)
+	for (int i = 0; i < synth_model->active_voices; i++)
 	{
-		if (voice->current_state != NOTE_NOT_PLAYING)
-		{
-			mod_matrix_value_t source_value = source->get_value(source, i);
+		voice_t* voice = synth_model->voice + synth_model->active_voice[i];
+		mod_matrix_value_t source_value = source_values[i];
 
-			if (source_value > 0)
-			{
-				voice->oscillator.level = (voice->oscillator.level * source_value) / MOD_MATRIX_ONE;
-			}
-			else
-			{
-				voice->oscillator.level = 0;
-			}
+		if (source_value > 0)
+		{
+			voice->oscillator.level = (voice->oscillator.level * source_value) / MOD_MATRIX_ONE;
+		}
+		else
+		{
+			voice->oscillator.level = 0;
 		}
 	}
 }
@@ -182,30 +195,27 @@ static void voice_amplitude_model_update(mod_matrix_source_t* source, mod_matrix
 static void voice_pitch_base_update(mod_matrix_sink_t* sink, void* data)
 {
 	synth_model_param_sink_t* param_sink = (synth_model_param_sink_t*)sink;
+	synth_model_t* synth_model = param_sink->synth_model;
 
-	voice_t* voice = param_sink->synth_model->voice;
-	for (int i = 0; i < param_sink->synth_model->voice_count; i++, voice++)
+	for (int i = 0; i < synth_model->active_voices; i++)
 	{
-		if (voice->current_state != NOTE_NOT_PLAYING)
-		{
-			voice->oscillator.frequency = voice->frequency;
-		}
+		voice_t* voice = synth_model->voice + synth_model->active_voice[i];
+		voice->oscillator.frequency = voice->frequency;
 	}
 }
 
 static void voice_pitch_model_update(mod_matrix_source_t* source, mod_matrix_sink_t* sink)
 {
 	synth_model_param_sink_t* param_sink = (synth_model_param_sink_t*)sink;
+	synth_model_t* synth_model = param_sink->synth_model;
+
+	mod_matrix_value_t* source_values = synth_model_get_voice_values(synth_model, source);
 
-	voice_t* voice = param_sink->synth_model->voice;
-	for (int i = 0; i < param_sink->synth_model->voice_count; i++, voice++)
+	for (int i = 0; i < synth_model->active_voices; i++)
 	{
-		if (voice->current_state != NOTE_NOT_PLAYING)
-		{
-			mod_matrix_value_t source_value = source->get_value(source, i);
-			// TODO: use a proper fixed point power function!
-			voice->oscillator.frequency = fixed_mul(voice->oscillator.frequency, powf(2.0f, (float)source_value / (float)MOD_MATRIX_ONE) * FIXED_ONE);
-		}
+		voice_t* voice = synth_model->voice + synth_model->active_voice[i];
+		mod_matrix_value_t source_value = source_values[i];
+		voice->oscillator.frequency = fixed_mul(voice->oscillator.frequency, fixed_exp2_at(source_value, MOD_MATRIX_PRECISION));
 	}
 }
 
@@ -215,21 +225,21 @@ static void voice_filter_q_model_update(mod_matrix_source_t* source, mod_matrix_
 	static const fixed_t filter_q_range	= FILTER_MAX_Q - FILTER_MIN_Q;
 
 	synth_model_param_sink_t* param_sink = (synth_model_param_sink_t*)sink;
+	synth_model_t* synth_model = param_sink->synth_model;
 
-	voice_t* voice = param_sink->synth_model->voice;
-	for (int i = 0; i < param_sink->synth_model->voice_count; i++, voice++)
+	mod_matrix_value_t* source_values = synth_model_get_voice_values(synth_model, source);
+
+	for (int i = 0; i < synth_model->active_voices; i++)
 	{
-		if (voice->current_state != NOTE_NOT_PLAYING)
+		voice_t* voice = synth_model->voice + synth_model->active_voice[i];
+		mod_matrix_value_t source_value = source_values[i];
+		if (source_value > 0)
 		{
-			mod_matrix_value_t source_value = source->get_value(source, i);
-			if (source_value > 0)
-			{
-				voice->filter_def.q = filter_q_base + (fixed_mul_at(filter_q_range, source_value, MOD_MATRIX_PRECISION));
-			}
-			else
-			{
-				voice->filter_def.q = filter_q_base;
-			}
+			voice->filter_def.q = filter_q_base + (fixed_mul_at(filter_q_range, source_value, MOD_MATRIX_PRECISION));
+		}
+		else
+		{
+			voice->filter_def.q = filter_q_base;
 		}
 	}
 }
@@ -240,25 +250,64 @@ static void voice_filter_freq_model_update(mod_matrix_source_t* source, mod_matr
 	static const fixed_t filter_freq_range	= FILTER_MAX_FREQUENCY - FILTER_MIN_FREQUENCY;
 
 	synth_model_param_sink_t* param_sink = (synth_model_param_sink_t*)sink;
+	synth_model_t* synth_model = param_sink->synth_model;
+
+	mod_matrix_value_t* source_values = synth_model_get_voice_values(synth_model, source);
 
-	voice_t* voice = param_sink->synth_model->voice;
-	for (int i = 0; i < param_sink->synth_model->voice_count; i++, voice++)
+	for (int i = 0; i < synth_model->active_voices; i++)
 	{
-		if (voice->current_state != NOTE_NOT_PLAYING)
+		voice_t* voice = synth_model->voice + synth_model->active_voice[i];
+		mod_matrix_value_t source_value = source_values[i];
+		if (source_value > 0)
 		{
-			mod_matrix_value_t source_value = source->get_value(source, i);
-			if (source_value > 0)
-			{
-				voice->filter_def.frequency = filter_freq_base + (fixed_mul_at(filter_freq_range, source_value, MOD_MATRIX_PRECISION));
-			}
-			else
-			{
-				voice->filter_def.frequency = filter_freq_base;
-			}
+			voice->filter_def.frequency = filter_freq_base + (fixed_mul_at(filter_freq_range, source_value, MOD_MATRIX_PRECISION));
+		}
+		else
+		{
+			voice->filter_def.frequency = filter_freq_base;
 		}
 	}
 }
 
+// Sources narrow the pulse from square towards the minimum width, or widen it towards the maximum when negative.
+static void voice_pulse_width_base_update(mod_matrix_sink_t* sink, void* data)
+{
+	synth_model_param_sink_t* param_sink = (synth_model_param_sink_t*)sink;
+	synth_model_t* synth_model = param_sink->synth_model;
+
+	for (int i = 0; i < synth_model->active_voices; i++)
+	{
+		synth_model->voice[synth_model->active_voice[i]].oscillator.pulse_width = FIXED_HALF;
+	}
+}
+
+static void voice_pulse_width_model_update(mod_matrix_source_t* source, mod_matrix_sink_t* sink)
+{
+	static const fixed_t pulse_width_range = FIXED_HALF - OSC_MIN_PULSE_WIDTH;
+
+	synth_model_param_sink_t* param_sink = (synth_model_param_sink_t*)sink;
+	synth_model_t* synth_model = param_sink->synth_model;
+
+	mod_matrix_value_t* source_values = synth_model_get_voice_values(synth_model, source);
+
+	for (int i = 0; i < synth_model->active_voices; i++)
+	{
+		voice_t* voice = synth_model->voice + synth_model->active_voice[i];
+		fixed_t pulse_width = voice->oscillator.pulse_width - fixed_mul_at(pulse_width_range, source_values[i], MOD_MATRIX_PRECISION);
+
+		if (pulse_width < OSC_MIN_PULSE_WIDTH)
+		{
+			pulse_width = OSC_MIN_PULSE_WIDTH;
+		}
+		else if (pulse_width > OSC_MAX_PULSE_WIDTH)
+		{
+			pulse_width = OSC_MAX_PULSE_WIDTH;
+		}
+
+		voice->oscillator.pulse_width = pulse_width;
+	}
+}
+
 //-------------------------------------------------------------------------------------------------------------------------
 // Envelope modulation
 //
@@ -295,10 +344,17 @@ static void envelope_generate_value(mod_matrix_source_t* source, void* data)
 	envelope_source_t* envelope_source = (envelope_source_t*)source;
 	synth_update_state_t* state = (synth_update_state_t*)data;
 
-	for (int i = 0; i < SYNTH_GLOBAL_ENVELOPE_INSTANCE_COUNT + state->synth_model->voice_count; i++)
+	synth_model_t* synth_model = state->synth_model;
+
+	for (int i = 0; i < SYNTH_GLOBAL_ENVELOPE_INSTANCE_COUNT; i++)
 	{
 		envelope_step(envelope_source->envelope_instance + i, state->timestep_ms);
 	}
+
+	for (int i = 0; i < synth_model->active_voices; i++)
+	{
+		envelope_step(envelope_source->envelope_instance + SYNTH_VOICE_ENVELOPE_INSTANCE_BASE + synth_model->active_voice[i], state->timestep_ms);
+	}
 }
 
 static mod_matrix_value_t envelope_get_value(mod_matrix_source_t* source, int subsource_id)
@@ -307,6 +363,16 @@ static mod_matrix_value_t envelope_get_value(mod_matrix_source_t* source, int su
 	return (mod_matrix_value_t) envelope_source->envelope_instance[subsource_id + 1].last_level;
 }
 
+static void envelope_get_values(mod_matrix_source_t* source, const int* subsource_ids, int count, mod_matrix_value_t* values)
+{
+	envelope_instance_t* voice_instances = ((envelope_source_t*)source)->envelope_instance + SYNTH_VOICE_ENVELOPE_INSTANCE_BASE;
+
+	for (int i = 0; i < count; i++)
+	{
+		values[i] = (mod_matrix_value_t) voice_instances[subsource_ids[i]].last_level;
+	}
+}
+
 void synth_model_start_global_envelopes(synth_model_t* synth_model)
 {
 	synth_model->global_envelopes_released = FALSE;
@@ -367,9 +433,9 @@ void synth_model_init_envelopes(synth_model_t* synth_model, int voice_count)
 		envelope_init(synth_model->envelope_source[2].envelope_instance + i, &synth_model->envelope[2]);
 	}
 
-	mod_matrix_init_source(SYNTH_MOD_SOURCE_ENVELOPE_1, envelope_generate_value, envelope_get_value, &synth_model->envelope_source[0].source);
-	mod_matrix_init_source(SYNTH_MOD_SOURCE_ENVELOPE_2, envelope_generate_value, envelope_get_value, &synth_model->envelope_source[1].source);
-	mod_matrix_init_source(SYNTH_MOD_SOURCE_ENVELOPE_3, envelope_generate_value, envelope_get_value, &synth_model->envelope_source[2].source);
+	mod_matrix_init_source(SYNTH_MOD_SOURCE_ENVELOPE_1, envelope_generate_value, envelope_get_value, envelope_get_values, &synth_model->envelope_source[0].source);
+	mod_matrix_init_source(SYNTH_MOD_SOURCE_ENVELOPE_2, envelope_generate_value, envelope_get_value, envelope_get_values, &synth_model->envelope_source[1].source);
+	mod_matrix_init_source(SYNTH_MOD_SOURCE_ENVELOPE_3, envelope_generate_value, envelope_get_value, envelope_get_values, &synth_model->envelope_source[2].source);
 
 	mod_matrix_add_source(&synth_model->envelope_source[0].source);
 	mod_matrix_add_source(&synth_model->envelope_source[1].source);
@@ -382,6 +448,34 @@ void synth_model_deinit_envelopes(synth_model_t* synth_model)
 	synth_model->envelope_instances = NULL;
 }
 
+//=========================================================================================================================
+// Active voice list
+//
+// Voices from starting until they have ended, in no particular order; per period work only looks at these.
+//
+static void synth_model_add_active_voice(synth_model_t* synth_model, int voice_index)
+{
+	synth_model->active_voice_position[voice_index] = synth_model->active_voices;
+	synth_model->active_voice[synth_model->active_voices++] = voice_index;
+}
+
+static void synth_model_remove_active_voice(synth_model_t* synth_model, int voice_index)
+{
+	int position = synth_model->active_voice_position[voice_index];
+
+	if (position < 0)
+	{
+		LOG_ERROR("Voice %d ended without starting", voice_index);
+		return;
+	}
+
+	// The last voice in the list takes the removed voice's place.
+	int last_voice_index = synth_model->active_voice[--synth_model->active_voices];
+	synth_model->active_voice[position] = last_voice_index;
+	synth_model->active_voice_position[last_voice_index] = position;
+	synth_model->active_voice_position[voice_index] = -1;
+}
+
 //=========================================================================================================================
 // External callbacks
 //
@@ -403,7 +497,7 @@ static void voice_event_callback(voice_event_t callback_event, voice_t* voice, v
 				synth_model_start_global_envelopes(synth_model);
 			}
 
-			synth_model->active_voices++;
+			synth_model_add_active_voice(synth_model, voice->index);
 			break;
 		}
 
@@ -415,13 +509,13 @@ static void voice_event_callback(voice_event_t callback_event, voice_t* voice, v
 
 		case VOICE_EVENT_NOTE_ENDING:
 		{
-			synth_model->ending_voices++;
+			voice_allocator_note_ending(&synth_model->voice_allocator, voice);
 
 			if (synth_model->voice_amplitude_envelope_count > 0)
 			{
 				synth_model_release_voice_envelopes(synth_model, voice->index);
 
-				if (synth_model->ending_voices == synth_model->active_voices)
+				if (voice_allocator_releasing_count(&synth_model->voice_allocator) == synth_model->active_voices)
 				{
 					synth_model_release_global_envelopes(synth_model);
 				}
@@ -436,8 +530,8 @@ static void voice_event_callback(voice_event_t callback_event, voice_t* voice, v
 		case VOICE_EVENT_VOICE_ENDED:
 		default:
 		{
-			synth_model->ending_voices--;
-			synth_model->active_voices--;
+			voice_allocator_voice_ended(&synth_model->voice_allocator, voice);
+			synth_model_remove_active_voice(synth_model, voice->index);
 			break;
 		}
 	}
@@ -466,6 +560,201 @@ static void mod_matrix_callback(mod_matrix_event_t callback_event, mod_matrix_so
 	}
 }
 
+//=========================================================================================================================
+// Voice rendering
+//
+// Voices are split across the render pool workers by index, each worker mixing its voices into a private
+// stereo buffer. Worker 0 runs on the calling thread and mixes straight into the output buffer; the other
+// worker buffers are then reduced into it in worker order, so the result does not depend on thread timing.
+//
+typedef struct voice_render_job_t
+{
+	synth_model_t*			synth_model;
+	synth_update_state_t*	update_state;
+	int32_t					voice_level;
+} voice_render_job_t;
+
+static void synth_model_free_worker_buffers(synth_model_t* synth_model)
+{
+	for (int i = 0; i < RENDER_POOL_MAX_WORKERS; i++)
+	{
+		free(synth_model->worker_buffer[i]);
+		synth_model->worker_buffer[i] = NULL;
+	}
+
+	synth_model->worker_buffer_samples = 0;
+}
+
+static int synth_model_prepare_worker_buffers(synth_model_t* synth_model, size_t sample_count)
+{
+	if (sample_count > synth_model->worker_buffer_samples)
+	{
+		synth_model_free_worker_buffers(synth_model);
+
+		for (int i = 0; i < synth_model->render_pool.worker_count; i++)
+		{
+			synth_model->worker_buffer[i] = (bus_sample_t*)malloc(sample_count * sizeof(bus_sample_t) * 2);
+			if (synth_model->worker_buffer[i] == NULL)
+			{
+				LOG_ERROR("Cannot allocate %d sample buffers for %d render workers", (int)sample_count, synth_model->render_pool.worker_count);
+				synth_model_free_worker_buffers(synth_model);
+				return RESULT_ERROR;
+			}
+		}
+
+		synth_model->worker_buffer_samples = sample_count;
+	}
+
+	return RESULT_OK;
+}
+
+// Falls back to rendering on the calling thread alone, which needs just one buffer, if the workers' buffers
+// can't be allocated. Returns FALSE if even that fails, when there's nothing to render into.
+static int synth_model_ensure_worker_buffers(synth_model_t* synth_model, size_t sample_count)
+{
+	if (synth_model_prepare_worker_buffers(synth_model, sample_count) == RESULT_OK)
+	{
+		return TRUE;
+	}
+
+	if (synth_model->render_pool.worker_count > 1)
+	{
+		render_pool_deinitialise(&synth_model->render_pool);
+		render_pool_initialise(&synth_model->render_pool, 1);
+		return synth_model_prepare_worker_buffers(synth_model, sample_count) == RESULT_OK;
+	}
+
+	return FALSE;
+}
+
+// Each worker renders every worker_count'th active voice.
+// Fused voices are generated, filtered and mixed one at a time in a single pass.
+static int synth_model_render_fused_voices(voice_render_job_t* job, int worker_index, bus_sample_t* bus)
+{
+	synth_model_t* synth_model = job->synth_model;
+	synth_update_state_t* update_state = job->update_state;
+	int worker_count = synth_model->render_pool.worker_count;
+	int sample_count = update_state->sample_count;
+
+	sample_t *voice_buffer = (sample_t*)alloca(sample_count * sizeof(sample_t));
+	int audible = FALSE;
+
+	for (int i = worker_index; i < synth_model->active_voices; i += worker_count)
+	{
+		int voice_index = synth_model->active_voice[i];
+		int voice_state = voice_update_fused(synth_model->voice + voice_index, job->voice_level, voice_buffer, bus, sample_count, update_state->timestep_ms);
+		synth_model->voice_render_state[voice_index] = voice_state;
+		audible |= voice_state == VOICE_ACTIVE;
+	}
+
+	return audible;
+}
+
+// Otherwise voices are rendered in batches of FILTER_BANK_LANES, so their filters can be applied together as a filter bank.
+// Modulated filter types have no bank kernel, and are applied voice by voice.
+static int synth_model_render_batched_voices(voice_render_job_t* job, int worker_index, bus_sample_t* bus)
+{
+	synth_model_t* synth_model = job->synth_model;
+	synth_update_state_t* update_state = job->update_state;
+	int worker_count = synth_model->render_pool.worker_count;
+	int sample_count = update_state->sample_count;
+
+	sample_t *lane_buffers = (sample_t*)alloca(FILTER_BANK_LANES * sample_count * sizeof(sample_t));
+	int audible = FALSE;
+	filter_bank_t filter_bank;
+
+	for (int first = worker_index; first < synth_model->active_voices; first += worker_count * FILTER_BANK_LANES)
+	{
+		int lane_voice[FILTER_BANK_LANES];
+		int lane_count = 0;
+
+		filter_bank_init(&filter_bank, lane_buffers, sample_count);
+
+		for (int i = first; i < synth_model->active_voices && lane_count < FILTER_BANK_LANES; i += worker_count, lane_count++)
+		{
+			int voice_index = synth_model->active_voice[i];
+			voice_t* voice = synth_model->voice + voice_index;
+			sample_t* voice_buffer = filter_bank.sample_data[lane_count];
+			int voice_state = voice_update_unfiltered(voice, job->voice_level, voice_buffer, sample_count, update_state->timestep_ms);
+
+			synth_model->voice_render_state[voice_index] = voice_state;
+			lane_voice[lane_count] = voice_index;
+
+			if (voice_state == VOICE_ACTIVE)
+			{
+				if (voice->filter.definition.type != FILTER_PASS && !FILTER_IS_MODULATED(voice->filter.definition.type))
+				{
+					filter_bank_set_lane(&filter_bank, lane_count, &voice->filter);
+				}
+				else
+				{
+					filter_apply(&voice->filter, voice_buffer, sample_count);
+				}
+			}
+		}
+
+		filter_bank_apply(&filter_bank, sample_count);
+
+		for (int lane = 0; lane < lane_count; lane++)
+		{
+			if (synth_model->voice_render_state[lane_voice[lane]] == VOICE_ACTIVE)
+			{
+				dsp_kernels->mixdown_mono_to_bus(filter_bank.sample_data[lane], PAN_MAX, PAN_MAX, sample_count, bus);
+				audible = TRUE;
+			}
+		}
+	}
+
+	return audible;
+}
+
+// Each worker mixes its voices onto its own bus.
+static void synth_model_render_voices(int worker_index, void* job_data)
+{
+	voice_render_job_t* job = (voice_render_job_t*)job_data;
+	synth_model_t* synth_model = job->synth_model;
+	bus_sample_t *bus = synth_model->worker_buffer[worker_index];
+
+	memset(bus, 0, job->update_state->sample_count * sizeof(bus_sample_t) * 2);
+
+	if (synth_model->fused_voices)
+	{
+		synth_model->worker_audible[worker_index] = synth_model_render_fused_voices(job, worker_index, bus);
+	}
+	else
+	{
+		synth_model->worker_audible[worker_index] = synth_model_render_batched_voices(job, worker_index, bus);
+	}
+}
+
+// Sums the worker buses into the first, then rounds & saturates that to the output buffer in one pass.
+static int synth_model_reduce_worker_buffers(synth_model_t* synth_model, synth_update_state_t* update_state)
+{
+	bus_sample_t* bus = synth_model->worker_buffer[0];
+	int audible = synth_model->worker_audible[0];
+
+	for (int i = 1; i < synth_model->render_pool.worker_count; i++)
+	{
+		if (synth_model->worker_audible[i])
+		{
+			mixdown_bus_to_bus(synth_model->worker_buffer[i], update_state->sample_count, bus);
+			audible = TRUE;
+		}
+	}
+
+	if (audible)
+	{
+		if (synth_model->dither)
+		{
+			mixer_dither_bus(&synth_model->mixer_dither, bus, update_state->sample_count);
+		}
+
+		dsp_kernels->bus_to_stereo(bus, update_state->sample_count, (sample_t*)update_state->buffer_data);
+	}
+
+	return audible;
+}
+
 //=========================================================================================================================
 // Synth model entrypoints
 //
@@ -473,13 +762,29 @@ void synth_model_initialise(synth_model_t* synth_model, int voice_count)
 {
 	synth_model->voice_count 					= voice_count;
 	synth_model->active_voices					= 0;
-	synth_model->ending_voices					= 0;
 	synth_model->global_envelopes_released		= FALSE;
 	synth_model->voice_amplitude_envelope_count	= 0;
-	synth_model->ducking_levels					= NULL;
+	synth_model->ducking_levels					= (int32_t*)malloc((voice_count + 1) * sizeof(int32_t));
+	synth_model_set_ducking_curve(synth_model, 0.0f);
 
 	synth_model->voice = (voice_t*)calloc(synth_model->voice_count, sizeof(voice_t));
 	voices_initialise(synth_model->voice, synth_model->voice_count);
+	voice_allocator_initialise(&synth_model->voice_allocator, synth_model->voice, synth_model->voice_count);
+
+	memset(synth_model->worker_buffer, 0, sizeof(synth_model->worker_buffer));
+	synth_model->worker_buffer_samples = 0;
+	synth_model->voice_render_state = (int*)calloc(synth_model->voice_count, sizeof(int));
+	synth_model->active_voice = (int*)calloc(synth_model->voice_count, sizeof(int));
+	synth_model->voice_mod_values = (mod_matrix_value_t*)calloc(synth_model->voice_count, sizeof(mod_matrix_value_t));
+	synth_model->active_voice_position = (int*)malloc(synth_model->voice_count * sizeof(int));
+	for (int i = 0; i < synth_model->voice_count; i++)
+	{
+		synth_model->active_voice_position[i] = -1;
+	}
+	synth_model->fused_voices = FALSE;
+	synth_model->dither = FALSE;
+	mixer_dither_init(&synth_model->mixer_dither);
+	render_pool_initialise(&synth_model->render_pool, 1);
 
 	synth_model_init_param_sink(SYNTH_MOD_SINK_NOTE_AMPLITUDE, voice_amplitude_base_update, voice_amplitude_model_update, synth_model, &synth_model->voice_amplitude_sink);
 	synth_model_init_param_sink(SYNTH_MOD_SINK_NOTE_PITCH, voice_pitch_base_update, voice_pitch_model_update, synth_model, &synth_model->voice_pitch_sink);
@@ -487,12 +792,13 @@ void synth_model_initialise(synth_model_t* synth_model, int voice_count)
 	synth_model_init_param_sink(SYNTH_MOD_SINK_FILTER_FREQ, NULL, voice_filter_freq_model_update, synth_model, &synth_model->voice_filter_freq_sink);
 	synth_model_init_param_sink(SYNTH_MOD_SINK_LFO_AMPLITUDE, lfo_amplitude_base_update, lfo_amplitude_model_update, synth_model, &synth_model->lfo_amplitude_sink);
 	synth_model_init_param_sink(SYNTH_MOD_SINK_LFO_FREQ, lfo_freq_base_update, lfo_freq_model_update, synth_model, &synth_model->lfo_freq_sink);
+	synth_model_init_param_sink(SYNTH_MOD_SINK_PULSE_WIDTH, voice_pulse_width_base_update, voice_pulse_width_model_update, synth_model, &synth_model->voice_pulse_width_sink);
 
 	synth_model_init_envelopes(synth_model, voice_count);
 
 	lfo_init(&synth_model->lfo_def);
 	lfo_init(&synth_model->lfo_source.lfo);
-	mod_matrix_init_source(SYNTH_MOD_SOURCE_LFO, lfo_generate_value, lfo_get_value, &synth_model->lfo_source.source);
+	mod_matrix_init_source(SYNTH_MOD_SOURCE_LFO, lfo_generate_value, lfo_get_value, lfo_get_values, &synth_model->lfo_source.source);
 	mod_matrix_add_source(&synth_model->lfo_source.source);
 
 	voices_add_callback(voice_event_callback, synth_model);
@@ -508,8 +814,21 @@ void synth_model_deinitialise(synth_model_t* synth_model)
 	voices_remove_callback(voice_event_callback);
 	mod_matrix_remove_callback(mod_matrix_callback);
 	synth_model_deinit_envelopes(synth_model);
+	render_pool_deinitialise(&synth_model->render_pool);
+	synth_model_free_worker_buffers(synth_model);
+	free(synth_model->voice_render_state);
+	synth_model->voice_render_state = NULL;
+	free(synth_model->active_voice);
+	synth_model->active_voice = NULL;
+	free(synth_model->voice_mod_values);
+	synth_model->voice_mod_values = NULL;
+	free(synth_model->active_voice_position);
+	synth_model->active_voice_position = NULL;
+	voice_allocator_deinitialise(&synth_model->voice_allocator);
 	free(synth_model->voice);
 	synth_model->voice = NULL;
+	free(synth_model->ducking_levels);
+	synth_model->ducking_levels = NULL;
 }
 
 void synth_model_update(synth_model_t* synth_model, synth_update_state_t* update_state)
@@ -518,55 +837,48 @@ void synth_model_update(synth_model_t* synth_model, synth_update_state_t* update
 
 	// Update components used in modulation matrix that rely on state not
 	// available in the modulation matrix (at least for now).
-	for (int i = 0; i < synth_model->voice_count; i++)
+	for (int i = 0; i < synth_model->active_voices; i++)
 	{
-		voice_preupdate(synth_model->voice + i, update_state->timestep_ms, &synth_model->global_filter_def);
+		voice_preupdate(synth_model->voice + synth_model->active_voice[i], update_state->timestep_ms, &synth_model->global_filter_def);
 	}
 
 	mod_matrix_update(update_state);
 
-	int first_audible_voice = -1;
 	int last_active_voices = synth_model->active_voices;
-	int32_t auto_duck_level = LEVEL_MAX;
-	if (synth_model->ducking_levels != NULL)
-	{
-		auto_duck_level = synth_model->ducking_levels[synth_model->active_voices];
-	}
+	int32_t auto_duck_level = synth_model->ducking_levels[synth_model->active_voices];
 
-	sample_t *voice_buffer = (sample_t*)alloca(update_state->sample_count * sizeof(sample_t));
 	int master_volume = setting_get_value_int(synth_model->setting_master_volume);
-	int32_t voice_level = (master_volume * auto_duck_level) / LEVEL_MAX;
 	size_t buffer_bytes = update_state->sample_count * sizeof(sample_t) * 2;
 
-	for (int i = 0; i < synth_model->voice_count; i++)
+	voice_render_job_t render_job;
+	render_job.synth_model	= synth_model;
+	render_job.update_state	= update_state;
+	render_job.voice_level	= (master_volume * auto_duck_level) / LEVEL_MAX;
+
+	if (!synth_model_ensure_worker_buffers(synth_model, update_state->sample_count))
 	{
-		switch(voice_update(synth_model->voice + i, voice_level, voice_buffer, update_state->sample_count, update_state->timestep_ms))
-		{
-			case VOICE_IDLE:
-				break;
-			case VOICE_ACTIVE:
-			{
-				if (first_audible_voice < 0)
-				{
-					first_audible_voice = i;
-					//copy_mono_to_stereo(voice_buffer, PAN_MAX, PAN_MAX, buffer_samples, buffer_data);
-					copy_mono_to_stereo_asm(voice_buffer, PAN_MAX, PAN_MAX, update_state->sample_count, update_state->buffer_data);
-				}
-				else
-				{
-					//mixdown_mono_to_stereo(voice_buffer, PAN_MAX, PAN_MAX, buffer_samples, buffer_data);
-					mixdown_mono_to_stereo_asm(voice_buffer, PAN_MAX, PAN_MAX, update_state->sample_count, update_state->buffer_data);
-				}
-				break;
-			}
-		}
+		memset(update_state->buffer_data, 0, buffer_bytes);
+		return;
 	}
 
-	if (first_audible_voice < 0)
+	render_pool_run(&synth_model->render_pool, synth_model_render_voices, &render_job);
+
+	if (!synth_model_reduce_worker_buffers(synth_model, update_state))
 	{
 		memset(update_state->buffer_data, 0, buffer_bytes);
 	}
 
+	// Voices that have gone silent are killed here rather than on the workers, so voice callbacks stay on this thread.
+	// Killing a voice removes it from the active list, so walk the list backwards.
+	for (int i = synth_model->active_voices - 1; i >= 0; i--)
+	{
+		int voice_index = synth_model->active_voice[i];
+		if (synth_model->voice_render_state[voice_index] == VOICE_GONE_IDLE)
+		{
+			voice_kill(synth_model->voice + voice_index);
+		}
+	}
+
 	if (last_active_voices != synth_model->active_voices)
 	{
 		if (synth_model->active_voices < 0)
@@ -578,18 +890,13 @@ void synth_model_update(synth_model_t* synth_model, synth_update_state_t* update
 
 void synth_model_play_note(synth_model_t* synth_model, int channel, unsigned char midi_note)
 {
-	voice_t *candidate_voice = voice_find_next_likely_free(synth_model->voice, synth_model->voice_count, channel);
-
-	if (candidate_voice != NULL)
-	{
-		int master_waveform = setting_get_value_enum_as_int(synth_model->setting_master_waveform);
-		voice_play_note(candidate_voice, midi_note, master_waveform);
-	}
+	int master_waveform = setting_get_value_enum_as_int(synth_model->setting_master_waveform);
+	voice_allocator_play_note(&synth_model->voice_allocator, channel, midi_note, master_waveform);
 }
 
 void synth_model_stop_note(synth_model_t* synth_model, int channel, unsigned char midi_note)
 {
-	voice_t *playing_voice = voice_find_playing_note(synth_model->voice, synth_model->voice_count, channel, midi_note);
+	voice_t *playing_voice = voice_allocator_find_note(&synth_model->voice_allocator, channel, midi_note);
 
 	if (playing_voice != NULL)
 	{
@@ -599,13 +906,53 @@ void synth_model_stop_note(synth_model_t* synth_model, int channel, unsigned cha
 
 void synth_model_set_midi_channel(synth_model_t* synth_model, int midi_channel)
 {
-	for (int i = 0 ; i < synth_model->voice_count; i++)
+	voice_allocator_set_midi_channel(&synth_model->voice_allocator, midi_channel);
+}
+
+void synth_model_set_ducking_levels(synth_model_t* synth_model, const int32_t* ducking_levels)
+{
+	memcpy(synth_model->ducking_levels, ducking_levels, (synth_model->voice_count + 1) * sizeof(int32_t));
+}
+
+void synth_model_set_ducking_curve(synth_model_t* synth_model, float exponent)
+{
+	synth_model->ducking_levels[0] = LEVEL_MAX;
+
+	for (int i = 1; i <= synth_model->voice_count; i++)
 	{
-		synth_model->voice[i].midi_channel = midi_channel;
+		synth_model->ducking_levels[i] = LEVEL_MAX * powf((float)i, -exponent);
 	}
 }
 
-void synth_model_set_ducking_levels(synth_model_t* synth_model, int32_t* ducking_levels)
+void synth_model_set_fused_voices(synth_model_t* synth_model, int fused_voices)
 {
-	synth_model->ducking_levels = ducking_levels;
+	synth_model->fused_voices = fused_voices;
+}
+
+void synth_model_set_dither(synth_model_t* synth_model, int dither)
+{
+	synth_model->dither = dither;
+}
+
+// Every voice plays the same stack; set it while no notes are playing.
+void synth_model_set_oscillator_stack(synth_model_t* synth_model, const osc_stack_def_t* stack_def)
+{
+	for (int i = 0; i < synth_model->voice_count; i++)
+	{
+		osc_stack_set_definition(&synth_model->voice[i].oscillator_stack, stack_def);
+	}
+}
+
+int synth_model_set_render_threads(synth_model_t* synth_model, int thread_count)
+{
+	render_pool_deinitialise(&synth_model->render_pool);
+	synth_model_free_worker_buffers(synth_model);
+
+	if (render_pool_initialise(&synth_model->render_pool, thread_count) != RESULT_OK)
+	{
+		render_pool_initialise(&synth_model->render_pool, 1);
+		return RESULT_ERROR;
+	}
+
+	return RESULT_OK;
 }
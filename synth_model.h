@@ -29,6 +29,9 @@
 #include "filter.h"
 #include "lfo.h"
 #include "modulation_matrix.h"
+#include "render_pool.h"
+#include "mixer.h"
+#include "voice_allocator.h"
 
 // Forward declarations
 typedef struct setting_t setting_t;
@@ -39,11 +42,23 @@ typedef struct voice_t voice_t;
 #define SYNTH_GLOBAL_ENVELOPE_INSTANCE			0
 #define SYNTH_GLOBAL_ENVELOPE_INSTANCE_COUNT	1
 #define SYNTH_VOICE_ENVELOPE_INSTANCE_BASE		(SYNTH_GLOBAL_ENVELOPE_INSTANCE_COUNT)
+#define SYNTH_MAX_VOICES						128
+
+// Auto ducking scales the mix of n voices by 1 / n^exponent to avoid clipping.
+#define SYNTH_DUCKING_EXPONENT_DEFAULT			0.65f
 
 extern const char*	SYNTH_MOD_SOURCE_LFO;
+extern const char*	SYNTH_MOD_SOURCE_ENVELOPE_1;
+extern const char*	SYNTH_MOD_SOURCE_ENVELOPE_2;
+extern const char*	SYNTH_MOD_SOURCE_ENVELOPE_3;
 
 extern const char*	SYNTH_MOD_SINK_NOTE_AMPLITUDE;
 extern const char*	SYNTH_MOD_SINK_NOTE_PITCH;
+extern const char*	SYNTH_MOD_SINK_FILTER_Q;
+extern const char*	SYNTH_MOD_SINK_FILTER_FREQ;
+extern const char*	SYNTH_MOD_SINK_LFO_AMPLITUDE;
+extern const char*	SYNTH_MOD_SINK_LFO_FREQ;
+extern const char*	SYNTH_MOD_SINK_PULSE_WIDTH;
 
 typedef struct synth_model_t synth_model_t;
 
@@ -76,7 +91,7 @@ struct synth_model_t
 	filter_definition_t		global_filter_def;
 	envelope_instance_t*	envelope_instances;
 	lfo_t					lfo_def;
-	int32_t* 				ducking_levels;
+	int32_t* 				ducking_levels;		// indexed by active voice count, voice_count + 1 entries
 
 	// Sources
 	lfo_source_t		lfo_source;
@@ -89,14 +104,28 @@ struct synth_model_t
 	synth_model_param_sink_t voice_filter_freq_sink;
 	synth_model_param_sink_t lfo_amplitude_sink;
 	synth_model_param_sink_t lfo_freq_sink;
+	synth_model_param_sink_t voice_pulse_width_sink;
 
 	// Voices
 	int			voice_count;
 	int			active_voices;
-	int			ending_voices;
+	int*		active_voice;			// indices of the active voices, active_voices long
+	int*		active_voice_position;	// per voice position in active_voice, -1 when idle
+	mod_matrix_value_t*	voice_mod_values;	// per active voice source values, for the voice sinks
 	int			global_envelopes_released;
 	int			voice_amplitude_envelope_count;
 	voice_t* 	voice;
+	voice_allocator_t	voice_allocator;
+
+	// Rendering
+	render_pool_t	render_pool;
+	bus_sample_t*	worker_buffer[RENDER_POOL_MAX_WORKERS];
+	int				worker_audible[RENDER_POOL_MAX_WORKERS];
+	size_t			worker_buffer_samples;
+	int*			voice_render_state;
+	int				fused_voices;
+	int				dither;
+	mixer_dither_t	mixer_dither;
 };
 
 #define STATE_UNCHANGED	0
@@ -121,7 +150,12 @@ typedef struct synth_update_state_t
 
 extern void synth_model_initialise(synth_model_t* synth_model, int voice_count);
 extern void synth_model_set_midi_channel(synth_model_t* synth_model, int midi_channel);
-extern void synth_model_set_ducking_levels(synth_model_t* synth_model, int32_t* ducking_levels);
+extern void synth_model_set_ducking_levels(synth_model_t* synth_model, const int32_t* ducking_levels);
+extern void synth_model_set_ducking_curve(synth_model_t* synth_model, float exponent);
+extern int synth_model_set_render_threads(synth_model_t* synth_model, int thread_count);
+extern void synth_model_set_fused_voices(synth_model_t* synth_model, int fused_voices);
+extern void synth_model_set_dither(synth_model_t* synth_model, int dither);
+extern void synth_model_set_oscillator_stack(synth_model_t* synth_model, const osc_stack_def_t* stack_def);
 extern void synth_model_update(synth_model_t* synth_model, synth_update_state_t* update_state);
 extern void synth_model_play_note(synth_model_t* synth_model, int channel, unsigned char midi_note);
 extern void synth_model_stop_note(synth_model_t* synth_model, int channel, unsigned char midi_note);
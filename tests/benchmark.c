@@ -0,0 +1,434 @@
+// Pithesiser - a software synthesiser for Raspberry Pi
+// Copyright (C) 2015 Nicholas Tuckett
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * benchmark.c
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: ntuckett
+ *
+ *  Entry point for pithesiser-bench. Each run times a batch of calls with CLOCK_MONOTONIC,
+ *  giving one per-call time per run; statistics are taken across the runs.
+ *  Cycle figures are derived from the CPU clock, which is read from cpufreq unless given with
+ *  --cpu-mhz - pin the governor to "performance" for stable numbers.
+ */
+
+#include "benchmark.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <time.h>
+#include "../system_constants.h"
+#include "../logging.h"
+#include "../dsp_kernel.h"
+
+#define DEFAULT_WARMUP_RUNS		20
+#define DEFAULT_RUNS			200
+#define DEFAULT_ITERATIONS		64
+#define DEFAULT_MAX_VOICES		8
+
+static const char* CPU_FREQ_PATH = "/sys/devices/system/cpu/cpu0/cpufreq/scaling_cur_freq";
+
+typedef enum
+{
+	OUTPUT_TEXT,
+	OUTPUT_CSV,
+	OUTPUT_JSON
+} output_format_t;
+
+typedef struct benchmark_result_t
+{
+	char*		group;
+	char*		name;
+	int			samples_per_call;
+	double		min_ns;
+	double		median_ns;
+	double		p99_ns;
+	double		mean_ns;
+} benchmark_result_t;
+
+benchmark_options_t benchmark_options =
+{
+	DEFAULT_WARMUP_RUNS,
+	DEFAULT_RUNS,
+	DEFAULT_ITERATIONS,
+	0.0,
+	NULL,
+	DEFAULT_MAX_VOICES
+};
+
+typedef struct benchmark_metric_t
+{
+	char*		group;
+	char*		name;
+	double		value;
+	const char*	unit;
+} benchmark_metric_t;
+
+static benchmark_result_t* results = NULL;
+static int result_count = 0;
+static int result_capacity = 0;
+
+static benchmark_metric_t* metrics = NULL;
+static int metric_count = 0;
+static int metric_capacity = 0;
+
+static int64_t get_time_ns()
+{
+	struct timespec tspec;
+	clock_gettime(CLOCK_MONOTONIC, &tspec);
+	return (int64_t)tspec.tv_sec * 1000000000LL + tspec.tv_nsec;
+}
+
+static int compare_doubles(const void* a, const void* b)
+{
+	double value_a = *(const double*)a;
+	double value_b = *(const double*)b;
+	return (value_a > value_b) - (value_a < value_b);
+}
+
+static double read_cpu_mhz()
+{
+	double mhz = 0.0;
+	FILE* file = fopen(CPU_FREQ_PATH, "r");
+
+	if (file != NULL)
+	{
+		long khz;
+		if (fscanf(file, "%ld", &khz) == 1)
+		{
+			mhz = khz / 1000.0;
+		}
+		fclose(file);
+	}
+
+	return mhz;
+}
+
+static double cycles_per_sample(const benchmark_result_t* result)
+{
+	if (result->samples_per_call <= 0 || benchmark_options.cpu_mhz <= 0.0)
+	{
+		return 0.0;
+	}
+
+	return (result->median_ns * benchmark_options.cpu_mhz / 1000.0) / result->samples_per_call;
+}
+
+static double ns_per_sample(const benchmark_result_t* result)
+{
+	return result->samples_per_call > 0 ? result->median_ns / result->samples_per_call : 0.0;
+}
+
+double benchmark_run(const char* group, const char* name, benchmark_func_t func, void* data, int samples_per_call)
+{
+	if (benchmark_options.filter != NULL)
+	{
+		char full_name[256];
+		snprintf(full_name, sizeof(full_name), "%s/%s", group, name);
+		if (strstr(full_name, benchmark_options.filter) == NULL)
+		{
+			return -1.0;
+		}
+	}
+
+	for (int i = 0; i < benchmark_options.warmup_runs * benchmark_options.iterations; i++)
+	{
+		func(data);
+	}
+
+	double* run_ns = malloc(benchmark_options.runs * sizeof(double));
+	double total_ns = 0.0;
+
+	for (int run = 0; run < benchmark_options.runs; run++)
+	{
+		int64_t start_ns = get_time_ns();
+		for (int i = 0; i < benchmark_options.iterations; i++)
+		{
+			func(data);
+		}
+		int64_t end_ns = get_time_ns();
+
+		run_ns[run] = (double)(end_ns - start_ns) / benchmark_options.iterations;
+		total_ns += run_ns[run];
+	}
+
+	qsort(run_ns, benchmark_options.runs, sizeof(double), compare_doubles);
+
+	if (result_count == result_capacity)
+	{
+		result_capacity = result_capacity == 0 ? 64 : result_capacity * 2;
+		results = realloc(results, result_capacity * sizeof(benchmark_result_t));
+	}
+
+	benchmark_result_t* result = &results[result_count++];
+	int p99_index = (benchmark_options.runs * 99 + 99) / 100 - 1;
+
+	result->group = strdup(group);
+	result->name = strdup(name);
+	result->samples_per_call = samples_per_call;
+	result->min_ns = run_ns[0];
+	result->median_ns = run_ns[benchmark_options.runs / 2];
+	result->p99_ns = run_ns[p99_index];
+	result->mean_ns = total_ns / benchmark_options.runs;
+
+	free(run_ns);
+
+	fprintf(stderr, "%-16s %-40s median %10.0fns  %6.2f cycles/sample\n", group, name, result->median_ns, cycles_per_sample(result));
+
+	return result->p99_ns;
+}
+
+void benchmark_report(const char* group, const char* name, double value, const char* unit)
+{
+	if (metric_count == metric_capacity)
+	{
+		metric_capacity = metric_capacity == 0 ? 8 : metric_capacity * 2;
+		metrics = realloc(metrics, metric_capacity * sizeof(benchmark_metric_t));
+	}
+
+	benchmark_metric_t* metric = &metrics[metric_count++];
+	metric->group = strdup(group);
+	metric->name = strdup(name);
+	metric->value = value;
+	metric->unit = unit;
+
+	fprintf(stderr, "%-16s %-40s %g %s\n", group, name, value, unit);
+}
+
+//-----------------------------------------------------------------------------------------------------------------------
+// Result output
+//
+
+static void write_text(FILE* file)
+{
+	fprintf(file, "CPU clock: %.0fMHz, %s kernels, %d runs of %d calls after %d warmup runs\n", benchmark_options.cpu_mhz,
+			dsp_kernels->name, benchmark_options.runs, benchmark_options.iterations, benchmark_options.warmup_runs);
+	fprintf(file, "%-16s %-40s %12s %12s %12s %10s %12s\n", "group", "benchmark", "min ns", "median ns", "p99 ns", "ns/sample", "cycles/sample");
+
+	for (int i = 0; i < result_count; i++)
+	{
+		benchmark_result_t* result = &results[i];
+		fprintf(file, "%-16s %-40s %12.0f %12.0f %12.0f %10.2f %12.2f\n", result->group, result->name,
+				result->min_ns, result->median_ns, result->p99_ns, ns_per_sample(result), cycles_per_sample(result));
+	}
+
+	for (int i = 0; i < metric_count; i++)
+	{
+		fprintf(file, "%-16s %-40s %12g %s\n", metrics[i].group, metrics[i].name, metrics[i].value, metrics[i].unit);
+	}
+}
+
+static void write_csv(FILE* file)
+{
+	fprintf(file, "group,benchmark,samples_per_call,runs,iterations,min_ns,median_ns,p99_ns,mean_ns,ns_per_sample,cpu_mhz,cycles_per_sample\n");
+
+	for (int i = 0; i < result_count; i++)
+	{
+		benchmark_result_t* result = &results[i];
+		fprintf(file, "%s,%s,%d,%d,%d,%.1f,%.1f,%.1f,%.1f,%.3f,%.0f,%.3f\n", result->group, result->name, result->samples_per_call,
+				benchmark_options.runs, benchmark_options.iterations, result->min_ns, result->median_ns, result->p99_ns,
+				result->mean_ns, ns_per_sample(result), benchmark_options.cpu_mhz, cycles_per_sample(result));
+	}
+
+	if (metric_count > 0)
+	{
+		fprintf(file, "\ngroup,metric,value,unit\n");
+		for (int i = 0; i < metric_count; i++)
+		{
+			fprintf(file, "%s,%s,%g,%s\n", metrics[i].group, metrics[i].name, metrics[i].value, metrics[i].unit);
+		}
+	}
+}
+
+static void write_json(FILE* file)
+{
+	fprintf(file, "{\n  \"cpu_mhz\": %.0f,\n  \"kernels\": \"%s\",\n  \"runs\": %d,\n  \"iterations\": %d,\n  \"warmup_runs\": %d,\n  \"results\": [\n",
+			benchmark_options.cpu_mhz, dsp_kernels->name, benchmark_options.runs, benchmark_options.iterations, benchmark_options.warmup_runs);
+
+	for (int i = 0; i < result_count; i++)
+	{
+		benchmark_result_t* result = &results[i];
+		fprintf(file, "    { \"group\": \"%s\", \"benchmark\": \"%s\", \"samples_per_call\": %d, \"min_ns\": %.1f, \"median_ns\": %.1f, "
+				"\"p99_ns\": %.1f, \"mean_ns\": %.1f, \"ns_per_sample\": %.3f, \"cycles_per_sample\": %.3f }%s\n",
+				result->group, result->name, result->samples_per_call, result->min_ns, result->median_ns, result->p99_ns,
+				result->mean_ns, ns_per_sample(result), cycles_per_sample(result), i < result_count - 1 ? "," : "");
+	}
+
+	fprintf(file, "  ],\n  \"metrics\": [\n");
+
+	for (int i = 0; i < metric_count; i++)
+	{
+		fprintf(file, "    { \"group\": \"%s\", \"metric\": \"%s\", \"value\": %g, \"unit\": \"%s\" }%s\n",
+				metrics[i].group, metrics[i].name, metrics[i].value, metrics[i].unit, i < metric_count - 1 ? "," : "");
+	}
+
+	fprintf(file, "  ]\n}\n");
+}
+
+//-----------------------------------------------------------------------------------------------------------------------
+// Entrypoint
+//
+
+static void usage(const char* program_name)
+{
+	fprintf(stderr, "Usage: %s [options]\n", program_name);
+	fprintf(stderr, "  -w, --warmup <runs>       untimed runs before timing (default %d)\n", DEFAULT_WARMUP_RUNS);
+	fprintf(stderr, "  -n, --runs <runs>         timed runs per benchmark (default %d)\n", DEFAULT_RUNS);
+	fprintf(stderr, "  -i, --iterations <calls>  calls per timed run (default %d)\n", DEFAULT_ITERATIONS);
+	fprintf(stderr, "  -m, --cpu-mhz <mhz>       CPU clock for cycle figures (default: read from cpufreq)\n");
+	fprintf(stderr, "  -v, --max-voices <count>  highest voice count for synth model benchmarks (default %d)\n", DEFAULT_MAX_VOICES);
+	fprintf(stderr, "  -k, --kernels <set>       DSP kernels used by the synth model benchmarks (default %s)\n", DSP_KERNELS_AUTO);
+	fprintf(stderr, "  -g, --filter <text>       only run benchmarks whose group/name contains text\n");
+	fprintf(stderr, "  -f, --format <format>     text, csv or json (default text)\n");
+	fprintf(stderr, "  -o, --output <file>       write results to file rather than stdout\n");
+}
+
+int main(int argc, char **argv)
+{
+	static const struct option long_options[] =
+	{
+		{ "warmup",		required_argument,	NULL, 'w' },
+		{ "runs",		required_argument,	NULL, 'n' },
+		{ "iterations",	required_argument,	NULL, 'i' },
+		{ "cpu-mhz",	required_argument,	NULL, 'm' },
+		{ "max-voices",	required_argument,	NULL, 'v' },
+		{ "kernels",	required_argument,	NULL, 'k' },
+		{ "filter",		required_argument,	NULL, 'g' },
+		{ "format",		required_argument,	NULL, 'f' },
+		{ "output",		required_argument,	NULL, 'o' },
+		{ NULL,			0,					NULL, 0 }
+	};
+
+	output_format_t format = OUTPUT_TEXT;
+	const char* output_path = NULL;
+	const char* kernels = DSP_KERNELS_AUTO;
+	int option;
+
+	while ((option = getopt_long(argc, argv, "w:n:i:m:v:k:g:f:o:", long_options, NULL)) != -1)
+	{
+		switch (option)
+		{
+			case 'w':
+				benchmark_options.warmup_runs = atoi(optarg);
+				break;
+			case 'n':
+				benchmark_options.runs = atoi(optarg);
+				break;
+			case 'i':
+				benchmark_options.iterations = atoi(optarg);
+				break;
+			case 'm':
+				benchmark_options.cpu_mhz = atof(optarg);
+				break;
+			case 'v':
+				benchmark_options.max_voices = atoi(optarg);
+				break;
+			case 'k':
+				kernels = optarg;
+				break;
+			case 'g':
+				benchmark_options.filter = optarg;
+				break;
+			case 'f':
+				if (strcmp(optarg, "text") == 0)
+					format = OUTPUT_TEXT;
+				else if (strcmp(optarg, "csv") == 0)
+					format = OUTPUT_CSV;
+				else if (strcmp(optarg, "json") == 0)
+					format = OUTPUT_JSON;
+				else
+				{
+					usage(argv[0]);
+					return EXIT_FAILURE;
+				}
+				break;
+			case 'o':
+				output_path = optarg;
+				break;
+			default:
+				usage(argv[0]);
+				return EXIT_FAILURE;
+		}
+	}
+
+	if (benchmark_options.runs < 1 || benchmark_options.iterations < 1 || benchmark_options.warmup_runs < 0 || benchmark_options.max_voices < 1)
+	{
+		usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	if (logging_initialise() != RESULT_OK || dsp_kernels_initialise(kernels) != RESULT_OK)
+	{
+		return EXIT_FAILURE;
+	}
+
+	if (benchmark_options.cpu_mhz <= 0.0)
+	{
+		benchmark_options.cpu_mhz = read_cpu_mhz();
+	}
+
+	waveform_benchmarks();
+	filter_benchmarks();
+	mixer_benchmarks();
+	envelope_benchmarks();
+	synth_model_benchmarks();
+	output_conversion_benchmarks();
+	fixed_point_benchmarks();
+
+	FILE* output = stdout;
+	if (output_path != NULL && (output = fopen(output_path, "w")) == NULL)
+	{
+		perror(output_path);
+		return EXIT_FAILURE;
+	}
+
+	switch (format)
+	{
+		case OUTPUT_CSV:
+			write_csv(output);
+			break;
+		case OUTPUT_JSON:
+			write_json(output);
+			break;
+		default:
+			write_text(output);
+			break;
+	}
+
+	if (output != stdout)
+	{
+		fclose(output);
+	}
+
+	for (int i = 0; i < result_count; i++)
+	{
+		free(results[i].group);
+		free(results[i].name);
+	}
+
+	free(results);
+
+	for (int i = 0; i < metric_count; i++)
+	{
+		free(metrics[i].group);
+		free(metrics[i].name);
+	}
+
+	free(metrics);
+	return EXIT_SUCCESS;
+}
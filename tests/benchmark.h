@@ -0,0 +1,62 @@
+// Pithesiser - a software synthesiser for Raspberry Pi
+// Copyright (C) 2015 Nicholas Tuckett
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * benchmark.h
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: ntuckett
+ *
+ *  Benchmark harness: each benchmark is a function timed over repeated runs after a warmup,
+ *  with min/median/p99 statistics reported per call and per sample.
+ */
+
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+// Period size the benchmarks render at - the same as the live synth.
+#define BENCHMARK_PERIOD_SAMPLES	128
+
+typedef void (*benchmark_func_t)(void* data);
+
+typedef struct benchmark_options_t
+{
+	int			warmup_runs;
+	int			runs;
+	int			iterations;
+	double		cpu_mhz;
+	const char*	filter;
+	int			max_voices;
+} benchmark_options_t;
+
+extern benchmark_options_t benchmark_options;
+
+// Times func(data), which is expected to process samples_per_call samples (0 if per-sample figures don't apply).
+// Returns the p99 time per call in ns, or a negative value if the benchmark was filtered out.
+extern double benchmark_run(const char* group, const char* name, benchmark_func_t func, void* data, int samples_per_call);
+
+// Records a figure derived from benchmark runs, reported after the timings.
+extern void benchmark_report(const char* group, const char* name, double value, const char* unit);
+
+extern void waveform_benchmarks();
+extern void filter_benchmarks();
+extern void mixer_benchmarks();
+extern void envelope_benchmarks();
+extern void synth_model_benchmarks();
+extern void output_conversion_benchmarks();
+extern void fixed_point_benchmarks();
+
+#endif /* BENCHMARK_H_ */
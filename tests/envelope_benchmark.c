@@ -0,0 +1,83 @@
+// Pithesiser - a software synthesiser for Raspberry Pi
+// Copyright (C) 2015 Nicholas Tuckett
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * envelope_benchmark.c
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: ntuckett
+ */
+
+#include "benchmark.h"
+#include "../system_constants.h"
+#include "../envelope.h"
+#include "../modulation_matrix.h"
+
+static const char* GROUP_ENVELOPE = "envelope";
+
+// A period of BENCHMARK_PERIOD_SAMPLES is just under 3ms.
+#define TIMESTEP_MS		3
+
+static envelope_stage_t benchmark_stages[4] =
+{
+	{ 0,					MOD_MATRIX_ONE,		100,			},
+	{ MOD_MATRIX_ONE,		MOD_MATRIX_ONE / 2,	250				},
+	{ MOD_MATRIX_ONE / 2,	MOD_MATRIX_ONE / 2,	DURATION_HELD	},
+	{ LEVEL_CURRENT,		0,					100				}
+};
+
+static void envelope_held_benchmark(void* data)
+{
+	envelope_step((envelope_instance_t*)data, TIMESTEP_MS);
+}
+
+// Cycles through every stage: released as soon as sustain is reached, restarted once complete.
+static void envelope_cycling_benchmark(void* data)
+{
+	envelope_instance_t* instance = (envelope_instance_t*)data;
+
+	envelope_step(instance, TIMESTEP_MS);
+
+	if (instance->stage == ENVELOPE_STAGE_SUSTAIN)
+	{
+		envelope_go_to_stage(instance, ENVELOPE_STAGE_RELEASE);
+	}
+	else if (envelope_completed(instance))
+	{
+		envelope_start(instance);
+	}
+}
+
+void envelope_benchmarks()
+{
+	envelope_t envelope;
+	envelope_instance_t instance;
+
+	envelopes_initialise();
+
+	envelope.peak = MOD_MATRIX_ONE;
+	envelope.stage_count = 4;
+	envelope.stages = benchmark_stages;
+
+	envelope_init(&instance, &envelope);
+	envelope_start(&instance);
+	envelope_go_to_stage(&instance, ENVELOPE_STAGE_SUSTAIN);
+	benchmark_run(GROUP_ENVELOPE, "envelope_step_held", envelope_held_benchmark, &instance, BENCHMARK_PERIOD_SAMPLES);
+
+	envelope_init(&instance, &envelope);
+	envelope_start(&instance);
+	benchmark_run(GROUP_ENVELOPE, "envelope_step_cycling", envelope_cycling_benchmark, &instance, BENCHMARK_PERIOD_SAMPLES);
+}
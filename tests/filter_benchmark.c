@@ -0,0 +1,232 @@
+// Pithesiser - a software synthesiser for Raspberry Pi
+// Copyright (C) 2015 Nicholas Tuckett
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * filter_benchmark.c
+ *
+ *  Created on: 15 Feb 2013
+ *      Author: ntuckett
+ */
+
+#include "benchmark.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../system_constants.h"
+#include "../fixed_point_math.h"
+#include "../filter.h"
+#include "../filter_bank.h"
+#include "../dsp_kernel.h"
+#include "../float_filter.h"
+
+static const char* GROUP_FILTER = "filter";
+
+typedef struct filter_benchmark_t
+{
+	const dsp_kernels_t*	kernels;
+	filter_t				filter;
+	filter_t				last_filter;
+	float_filter_t			float_filter;
+	filter_bank_t			bank;
+	sample_t				buffer[BENCHMARK_PERIOD_SAMPLES];
+	sample_t				bank_buffer[BENCHMARK_PERIOD_SAMPLES * FILTER_BANK_LANES];
+	float					float_signal[BENCHMARK_PERIOD_SAMPLES];
+	float					float_buffer[BENCHMARK_PERIOD_SAMPLES];
+} filter_benchmark_t;
+
+static void fill_test_signal(filter_benchmark_t* benchmark)
+{
+	for (int i = 0; i < BENCHMARK_PERIOD_SAMPLES; i++)
+	{
+		// Square wave, so the filters always have something to work on.
+		benchmark->buffer[i] = (i & 32) ? SAMPLE_MAX / 2 : -SAMPLE_MAX / 2;
+		benchmark->float_signal[i] = (i & 32) ? 0.5f : -0.5f;
+	}
+
+	for (int i = 0; i < BENCHMARK_PERIOD_SAMPLES * FILTER_BANK_LANES; i++)
+	{
+		benchmark->bank_buffer[i] = (i & 32) ? SAMPLE_MAX / 2 : -SAMPLE_MAX / 2;
+	}
+}
+
+static void filter_update_benchmark(void* data)
+{
+	filter_benchmark_t* benchmark = (filter_benchmark_t*)data;
+	filter_update(&benchmark->filter);
+}
+
+// Moves through frequency and Q each call, as a modulated cutoff would.
+static void filter_update_swept_benchmark(void* data)
+{
+	filter_benchmark_t* benchmark = (filter_benchmark_t*)data;
+	filter_definition_t* definition = &benchmark->filter.definition;
+
+	definition->frequency += definition->frequency >> 4;
+	if (definition->frequency > FILTER_MAX_FREQUENCY)
+	{
+		definition->frequency = FILTER_MIN_FREQUENCY;
+	}
+	definition->q += FIXED_ONE / 64;
+	if (definition->q > FILTER_MAX_Q)
+	{
+		definition->q = FILTER_MIN_Q;
+	}
+	filter_update(&benchmark->filter);
+}
+
+static void filter_apply_benchmark(void* data)
+{
+	filter_benchmark_t* benchmark = (filter_benchmark_t*)data;
+	filter_apply(&benchmark->filter, benchmark->buffer, BENCHMARK_PERIOD_SAMPLES);
+}
+
+static void filter_apply_updated_benchmark(void* data)
+{
+	filter_benchmark_t* benchmark = (filter_benchmark_t*)data;
+	benchmark->filter.updated = 1;
+	filter_apply(&benchmark->filter, benchmark->buffer, BENCHMARK_PERIOD_SAMPLES);
+}
+
+static void filter_kernel_benchmark(void* data)
+{
+	filter_benchmark_t* benchmark = (filter_benchmark_t*)data;
+	benchmark->kernels->filter_apply(benchmark->buffer, BENCHMARK_PERIOD_SAMPLES, &benchmark->filter.state);
+}
+
+static void filter_interp_kernel_benchmark(void* data)
+{
+	filter_benchmark_t* benchmark = (filter_benchmark_t*)data;
+	benchmark->kernels->filter_apply_interp(benchmark->buffer, BENCHMARK_PERIOD_SAMPLES, &benchmark->filter.state, &benchmark->last_filter.state);
+}
+
+static void filter_bank_kernel_benchmark(void* data)
+{
+	filter_benchmark_t* benchmark = (filter_benchmark_t*)data;
+	benchmark->kernels->filter_bank_apply(&benchmark->bank, BENCHMARK_PERIOD_SAMPLES);
+}
+
+static void filter_bank_interp_kernel_benchmark(void* data)
+{
+	filter_benchmark_t* benchmark = (filter_benchmark_t*)data;
+	benchmark->kernels->filter_bank_apply_interp(&benchmark->bank, BENCHMARK_PERIOD_SAMPLES);
+}
+
+// Sweeps the cutoff every call, so modulated filters ramp across each buffer.
+static void filter_apply_modulated_swept_benchmark(void* data)
+{
+	filter_benchmark_t* benchmark = (filter_benchmark_t*)data;
+	filter_definition_t* definition = &benchmark->filter.definition;
+
+	definition->frequency += definition->frequency >> 4;
+	if (definition->frequency > FILTER_MAX_FREQUENCY)
+	{
+		definition->frequency = FILTER_MIN_FREQUENCY;
+	}
+	filter_update(&benchmark->filter);
+	filter_apply(&benchmark->filter, benchmark->buffer, BENCHMARK_PERIOD_SAMPLES);
+}
+
+static void float_filter_apply_benchmark(void* data)
+{
+	filter_benchmark_t* benchmark = (filter_benchmark_t*)data;
+
+	// Refilled each time, as repeatedly filtering the output decays into denormals.
+	memcpy(benchmark->float_buffer, benchmark->float_signal, sizeof(benchmark->float_buffer));
+	float_filter_apply(&benchmark->float_filter, benchmark->float_buffer, BENCHMARK_PERIOD_SAMPLES);
+}
+
+static filter_benchmark_t* create_filter_benchmark(int type)
+{
+	filter_benchmark_t* benchmark = calloc(1, sizeof(filter_benchmark_t));
+
+	filter_init(&benchmark->filter);
+	benchmark->filter.definition.type = type;
+	benchmark->filter.definition.frequency = 880 * FILTER_FIXED_ONE;
+	benchmark->filter.definition.q = FIXED_HALF;
+	filter_update(&benchmark->filter);
+	benchmark->last_filter = benchmark->filter;
+
+	// Every lane filtered, as with a full batch of playing voices.
+	filter_bank_init(&benchmark->bank, benchmark->bank_buffer, BENCHMARK_PERIOD_SAMPLES);
+	for (int lane = 0; lane < FILTER_BANK_LANES; lane++)
+	{
+		filter_bank_set_lane(&benchmark->bank, lane, &benchmark->filter);
+	}
+
+	float_filter_init(&benchmark->float_filter);
+	benchmark->float_filter.definition.type = type;
+	benchmark->float_filter.definition.frequency = 880.0f;
+	benchmark->float_filter.definition.q = 0.5f;
+	float_filter_update(&benchmark->float_filter);
+
+	fill_test_signal(benchmark);
+	return benchmark;
+}
+
+void filter_benchmarks()
+{
+	filter_benchmark_t* benchmark = create_filter_benchmark(FILTER_LPF);
+
+	benchmark_run(GROUP_FILTER, "filter_update", filter_update_benchmark, benchmark, 0);
+
+	filter_benchmark_t* swept_benchmark = create_filter_benchmark(FILTER_LPF);
+	benchmark_run(GROUP_FILTER, "filter_update_swept", filter_update_swept_benchmark, swept_benchmark, 0);
+	free(swept_benchmark);
+
+	benchmark_run(GROUP_FILTER, "filter_apply_lpf", filter_apply_benchmark, benchmark, BENCHMARK_PERIOD_SAMPLES);
+	benchmark_run(GROUP_FILTER, "filter_apply_lpf_updated", filter_apply_updated_benchmark, benchmark, BENCHMARK_PERIOD_SAMPLES);
+
+	for (int i = 0; i < dsp_kernels_count(); i++)
+	{
+		char name[64];
+
+		benchmark->kernels = dsp_kernels_get(i);
+		if (benchmark->kernels->supported())
+		{
+			sprintf(name, "filter_kernel_%s", benchmark->kernels->name);
+			benchmark_run(GROUP_FILTER, name, filter_kernel_benchmark, benchmark, BENCHMARK_PERIOD_SAMPLES);
+			sprintf(name, "filter_interp_kernel_%s", benchmark->kernels->name);
+			benchmark_run(GROUP_FILTER, name, filter_interp_kernel_benchmark, benchmark, BENCHMARK_PERIOD_SAMPLES);
+			sprintf(name, "filter_bank_kernel_%s", benchmark->kernels->name);
+			benchmark_run(GROUP_FILTER, name, filter_bank_kernel_benchmark, benchmark, BENCHMARK_PERIOD_SAMPLES * FILTER_BANK_LANES);
+			sprintf(name, "filter_bank_interp_kernel_%s", benchmark->kernels->name);
+			benchmark_run(GROUP_FILTER, name, filter_bank_interp_kernel_benchmark, benchmark, BENCHMARK_PERIOD_SAMPLES * FILTER_BANK_LANES);
+		}
+	}
+
+	benchmark_run(GROUP_FILTER, "float_filter_apply_lpf", float_filter_apply_benchmark, benchmark, BENCHMARK_PERIOD_SAMPLES);
+	free(benchmark);
+
+	benchmark = create_filter_benchmark(FILTER_HPF);
+	benchmark_run(GROUP_FILTER, "filter_apply_hpf", filter_apply_benchmark, benchmark, BENCHMARK_PERIOD_SAMPLES);
+	free(benchmark);
+
+	benchmark = create_filter_benchmark(FILTER_PASS);
+	benchmark_run(GROUP_FILTER, "filter_apply_pass", filter_apply_benchmark, benchmark, BENCHMARK_PERIOD_SAMPLES);
+	free(benchmark);
+
+	benchmark = create_filter_benchmark(FILTER_SVF_LPF);
+	benchmark_run(GROUP_FILTER, "filter_apply_svf_lpf", filter_apply_benchmark, benchmark, BENCHMARK_PERIOD_SAMPLES);
+	benchmark_run(GROUP_FILTER, "filter_apply_svf_lpf_swept", filter_apply_modulated_swept_benchmark, benchmark, BENCHMARK_PERIOD_SAMPLES);
+	benchmark_run(GROUP_FILTER, "float_filter_apply_svf_lpf", float_filter_apply_benchmark, benchmark, BENCHMARK_PERIOD_SAMPLES);
+	free(benchmark);
+
+	benchmark = create_filter_benchmark(FILTER_LADDER);
+	benchmark_run(GROUP_FILTER, "filter_apply_ladder", filter_apply_benchmark, benchmark, BENCHMARK_PERIOD_SAMPLES);
+	benchmark_run(GROUP_FILTER, "filter_apply_ladder_swept", filter_apply_modulated_swept_benchmark, benchmark, BENCHMARK_PERIOD_SAMPLES);
+	benchmark_run(GROUP_FILTER, "float_filter_apply_ladder", float_filter_apply_benchmark, benchmark, BENCHMARK_PERIOD_SAMPLES);
+	free(benchmark);
+}
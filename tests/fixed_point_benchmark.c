@@ -0,0 +1,91 @@
+// Pithesiser - a software synthesiser for Raspberry Pi
+// Copyright (C) 2015 Nicholas Tuckett
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+/*
+ * fixed_point_benchmark.c
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: ntuckett
+ */
+
+#include "benchmark.h"
+#include <stdlib.h>
+#include <math.h>
+#include "../system_constants.h"
+#include "../fixed_point_math.h"
+#include "../modulation_matrix.h"
+
+static const char* GROUP_FIXED_POINT = "fixed_point";
+
+// One pitch modulation value per voice, spanning an octave either way.
+#define EXP2_VALUE_COUNT	128
+#define EXP2_CHECK_OCTAVES	4
+
+static mod_matrix_value_t exp2_input[EXP2_VALUE_COUNT];
+static fixed_t exp2_output[EXP2_VALUE_COUNT];
+
+static void fixed_exp2_benchmark(void* data)
+{
+	for (int i = 0; i < EXP2_VALUE_COUNT; i++)
+	{
+		exp2_output[i] = fixed_exp2_at(exp2_input[i], MOD_MATRIX_PRECISION);
+	}
+}
+
+static void powf_exp2_benchmark(void* data)
+{
+	for (int i = 0; i < EXP2_VALUE_COUNT; i++)
+	{
+		exp2_output[i] = powf(2.0f, (float)exp2_input[i] / (float)MOD_MATRIX_ONE) * FIXED_ONE;
+	}
+}
+
+// Largest difference from pow in cents, over every input in the range.
+static double fixed_exp2_max_error_cents(int octaves)
+{
+	double max_error = 0.0;
+
+	for (int x = -octaves * MOD_MATRIX_ONE; x <= octaves * MOD_MATRIX_ONE; x++)
+	{
+		double expected = pow(2.0, (double)x / MOD_MATRIX_ONE);
+		double actual = (double)fixed_exp2_at(x, MOD_MATRIX_PRECISION) / FIXED_ONE;
+		double error = fabs(1200.0 * log2(actual / expected));
+
+		if (error > max_error)
+		{
+			max_error = error;
+		}
+	}
+
+	return max_error;
+}
+
+void fixed_point_benchmarks()
+{
+	for (int i = 0; i < EXP2_VALUE_COUNT; i++)
+	{
+		exp2_input[i] = (i * 2 * MOD_MATRIX_ONE) / EXP2_VALUE_COUNT - MOD_MATRIX_ONE;
+	}
+
+	if (benchmark_run(GROUP_FIXED_POINT, "fixed_exp2_128_values", fixed_exp2_benchmark, NULL, 0) >= 0.0)
+	{
+		benchmark_report(GROUP_FIXED_POINT, "fixed_exp2_max_error_1_octave", fixed_exp2_max_error_cents(1), "cents");
+		benchmark_report(GROUP_FIXED_POINT, "fixed_exp2_max_error_4_octaves", fixed_exp2_max_error_cents(EXP2_CHECK_OCTAVES), "cents");
+	}
+
+	benchmark_run(GROUP_FIXED_POINT, "powf_exp2_128_values", powf_exp2_benchmark, NULL, 0);
+}
@@ -0,0 +1,85 @@
+// Pithesiser - a software synthesiser for Raspberry Pi
+// Copyright (C) 2015 Nicholas Tuckett
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "benchmark.h"
+#include <stdio.h>
+#include <memory.h>
+#include <stdlib.h>
+#include "../system_constants.h"
+#include "../mixer.h"
+#include "../dsp_kernel.h"
+
+static const char* GROUP_MIXER = "mixer";
+
+typedef struct mixer_benchmark_t
+{
+	const dsp_kernels_t*	kernels;
+	mixer_dither_t		dither;
+	sample_t			source[BENCHMARK_PERIOD_SAMPLES * 2];
+	sample_t			dest[BENCHMARK_PERIOD_SAMPLES * 2];
+	bus_sample_t		bus[BENCHMARK_PERIOD_SAMPLES * 2];
+} mixer_benchmark_t;
+
+static void bus_mixer_benchmark(void* data)
+{
+	mixer_benchmark_t* benchmark = (mixer_benchmark_t*)data;
+	benchmark->kernels->mixdown_mono_to_bus(benchmark->source, PAN_MAX, PAN_MAX, BENCHMARK_PERIOD_SAMPLES, benchmark->bus);
+}
+
+static void bus_output_benchmark(void* data)
+{
+	mixer_benchmark_t* benchmark = (mixer_benchmark_t*)data;
+	benchmark->kernels->bus_to_stereo(benchmark->bus, BENCHMARK_PERIOD_SAMPLES, benchmark->dest);
+}
+
+static void bus_dither_benchmark(void* data)
+{
+	mixer_benchmark_t* benchmark = (mixer_benchmark_t*)data;
+	mixer_dither_bus(&benchmark->dither, benchmark->bus, BENCHMARK_PERIOD_SAMPLES);
+}
+
+// Bus mixing doesn't clamp, so the source is silent to stop repeated runs overflowing the bus;
+// the bus is filled with values that always clamp when converted to samples.
+static void run_bus_benchmark(const char* name, benchmark_func_t func, const dsp_kernels_t* kernels)
+{
+	mixer_benchmark_t* benchmark = calloc(1, sizeof(mixer_benchmark_t));
+
+	memset(benchmark->bus, 127, sizeof(benchmark->bus));
+	benchmark->kernels = kernels;
+	mixer_dither_init(&benchmark->dither);
+
+	benchmark_run(GROUP_MIXER, name, func, benchmark, BENCHMARK_PERIOD_SAMPLES);
+	free(benchmark);
+}
+
+void mixer_benchmarks()
+{
+	for (int i = 0; i < dsp_kernels_count(); i++)
+	{
+		const dsp_kernels_t* kernels = dsp_kernels_get(i);
+		char name[64];
+
+		if (kernels->supported())
+		{
+			sprintf(name, "mixdown_bus_kernel_%s", kernels->name);
+			run_bus_benchmark(name, bus_mixer_benchmark, kernels);
+			sprintf(name, "bus_to_stereo_kernel_%s", kernels->name);
+			run_bus_benchmark(name, bus_output_benchmark, kernels);
+		}
+	}
+
+	run_bus_benchmark("bus_dither", bus_dither_benchmark, NULL);
+}
@@ -15,17 +15,23 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 /*
- * output_conversion_timing_test.c
+ * output_conversion_benchmark.c
  *
  *  Created on: 16 Feb 2013
  *      Author: ntuckett
  */
+#include "benchmark.h"
 #include <stdio.h>
 #include <sys/types.h>
 #include <limits.h>
-#include "../master_time.h"
 
-static const int TEST_BUFFER_SIZE = 128;
+static const char* GROUP_OUTPUT_CONVERSION = "output_conversion";
+
+typedef struct output_conversion_benchmark_t
+{
+	float	float_sample_buffer[BENCHMARK_PERIOD_SAMPLES * 2];
+	int16_t	int_sample_buffer[BENCHMARK_PERIOD_SAMPLES * 2];
+} output_conversion_benchmark_t;
 
 static void float_to_int_16_cast(float *float_sample_buffer, int16_t *int_sample_buffer, int sample_count)
 {
@@ -35,26 +41,20 @@ static void float_to_int_16_cast(float *float_sample_buffer, int16_t *int_sample
 	}
 }
 
-static void float_to_int16_timing_test(int count)
+static void float_to_int16_benchmark(void* data)
 {
-	float	float_sample_buffer[TEST_BUFFER_SIZE * 2];
-	int16_t	int_sample_buffer[TEST_BUFFER_SIZE * 2];
-
-	int32_t start_time = get_elapsed_time_ms();
-	for (int i = 0; i < count; i++)
-	{
-		float_to_int_16_cast(float_sample_buffer, int_sample_buffer, TEST_BUFFER_SIZE);
-	}
-
-	int32_t end_time = get_elapsed_time_ms();
-
-	printf("Cast & scale float to int16: for %d iterations %dms\n", count, end_time - start_time);
+	output_conversion_benchmark_t* benchmark = (output_conversion_benchmark_t*)data;
+	float_to_int_16_cast(benchmark->float_sample_buffer, benchmark->int_sample_buffer, BENCHMARK_PERIOD_SAMPLES);
 }
 
-void output_conversion_timing_test(int count)
+void output_conversion_benchmarks()
 {
-	printf("*********************************************************************\n");
-	printf("Output conversion Timing Test\n");
+	static output_conversion_benchmark_t benchmark;
+
+	for (int i = 0; i < BENCHMARK_PERIOD_SAMPLES * 2; i++)
+	{
+		benchmark.float_sample_buffer[i] = (i & 1) ? 0.5f : -0.5f;
+	}
 
-	float_to_int16_timing_test(count);
+	benchmark_run(GROUP_OUTPUT_CONVERSION, "float_to_int16_cast", float_to_int16_benchmark, &benchmark, BENCHMARK_PERIOD_SAMPLES);
 }
@@ -0,0 +1,253 @@
+// Pithesiser - a software synthesiser for Raspberry Pi
+// Copyright (C) 2015 Nicholas Tuckett
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+/*
+ * synth_model_benchmark.c
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: ntuckett
+ */
+
+#include "benchmark.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include "../system_constants.h"
+#include "../modulation_matrix.h"
+#include "../setting.h"
+#include "../synth_model.h"
+#include "../voice.h"
+#include "../waveform.h"
+
+static const char* GROUP_MOD_MATRIX = "mod_matrix";
+static const char* GROUP_SYNTH_MODEL = "synth_model";
+
+// A period of BENCHMARK_PERIOD_SAMPLES is just under 3ms.
+#define TIMESTEP_MS		3
+
+#define BENCHMARK_CHANNEL	0
+#define BENCHMARK_BASE_NOTE	48
+#define BENCHMARK_NOTE_STEP	7
+
+// Notes are kept an octave below the top of the fixed point frequency range (about 8kHz), leaving room for
+// vibrato; this limits how many voices can be held on one channel. More voices than this are sounded by striking
+// notes again: each releases the voice already playing the note, and with a long release that voice keeps sounding
+// through a benchmark.
+#define BENCHMARK_NOTE_LIMIT	108
+#define BENCHMARK_RELEASE_MS	60000
+#define BENCHMARK_ATTACK_MS		150
+
+// The polyphony search times many voice counts, so uses fewer runs than the other benchmarks.
+#define POLYPHONY_WARMUP_RUNS	2
+#define POLYPHONY_RUNS			50
+#define POLYPHONY_ITERATIONS	8
+
+static const char* benchmark_waveform_names[] =
+{
+	"WAVETABLE_SINE",
+	"WAVETABLE_SAW",
+	"WAVETABLE_SAW_BL"
+};
+
+static enum_type_info_t benchmark_waveform_type =
+{
+	WAVETABLE_SAW_BL + 1,
+	benchmark_waveform_names
+};
+
+static synth_model_t synth_model;
+
+static void synth_model_benchmark_initialise()
+{
+	mod_matrix_initialise();
+
+	synth_model.setting_master_volume = setting_create("master-volume");
+	synth_model.setting_master_waveform = setting_create("master-waveform");
+	setting_init_as_int(synth_model.setting_master_volume, LEVEL_MAX);
+	setting_init_as_enum(synth_model.setting_master_waveform, (int)WAVETABLE_SAW_BL, &benchmark_waveform_type);
+
+	synth_model_initialise(&synth_model, SYNTH_MAX_VOICES);
+	synth_model_set_midi_channel(&synth_model, BENCHMARK_CHANNEL);
+	waveform_initialise(NULL);
+
+	// A typical patch: enveloped amplitude and filter, with vibrato.
+	synth_model.global_filter_def.type = FILTER_LPF;
+	mod_matrix_connect(SYNTH_MOD_SOURCE_ENVELOPE_1, SYNTH_MOD_SINK_NOTE_AMPLITUDE);
+	mod_matrix_connect(SYNTH_MOD_SOURCE_ENVELOPE_2, SYNTH_MOD_SINK_FILTER_FREQ);
+	mod_matrix_connect(SYNTH_MOD_SOURCE_LFO, SYNTH_MOD_SINK_NOTE_PITCH);
+	synth_model.envelope[0].stages[ENVELOPE_STAGE_RELEASE].duration = BENCHMARK_RELEASE_MS;
+}
+
+static void synth_model_benchmark_deinitialise()
+{
+	setting_destroy(synth_model.setting_master_volume);
+	setting_destroy(synth_model.setting_master_waveform);
+	synth_model_deinitialise(&synth_model);
+}
+
+// A voice released before it's been updated has no level to release from, and ends at once.
+static void synth_model_run_attack()
+{
+	sample_t buffer[BENCHMARK_PERIOD_SAMPLES * 2];
+	synth_update_state_t update_state;
+
+	update_state.synth_model = &synth_model;
+	update_state.timestep_ms = TIMESTEP_MS;
+	update_state.sample_count = BENCHMARK_PERIOD_SAMPLES;
+	update_state.buffer_data = buffer;
+
+	for (int time_ms = 0; time_ms < BENCHMARK_ATTACK_MS; time_ms += TIMESTEP_MS)
+	{
+		synth_model_update(&synth_model, &update_state);
+	}
+}
+
+static void synth_model_play_notes(int note_count)
+{
+	for (int i = 0; i < synth_model.voice_count; i++)
+	{
+		voice_stop_note(synth_model.voice + i);
+		voice_kill(synth_model.voice + i);
+	}
+
+	// The step has no common factor with the note limit, so every voice up to the limit gets its own note.
+	for (int i = 0; i < note_count; i++)
+	{
+		if (i == BENCHMARK_NOTE_LIMIT)
+		{
+			synth_model_run_attack();
+		}
+
+		synth_model_play_note(&synth_model, BENCHMARK_CHANNEL, (BENCHMARK_BASE_NOTE + i * BENCHMARK_NOTE_STEP) % BENCHMARK_NOTE_LIMIT);
+	}
+}
+
+static void mod_matrix_update_benchmark(void* data)
+{
+	synth_update_state_t* update_state = (synth_update_state_t*)data;
+	for (int i = 0; i < synth_model.active_voices; i++)
+	{
+		voice_preupdate(synth_model.voice + synth_model.active_voice[i], update_state->timestep_ms, &synth_model.global_filter_def);
+	}
+	mod_matrix_update(update_state);
+}
+
+static void synth_model_update_benchmark(void* data)
+{
+	synth_model_update(&synth_model, (synth_update_state_t*)data);
+}
+
+static void synth_model_note_on_off_benchmark(void* data)
+{
+	static int note_index = 0;
+
+	// Once the free voices are used up, with every voice sounding, each note on has to steal a voice.
+	unsigned char midi_note = (unsigned char)(note_index++ % BENCHMARK_NOTE_LIMIT);
+	synth_model_play_note(&synth_model, BENCHMARK_CHANNEL, midi_note);
+	synth_model_stop_note(&synth_model, BENCHMARK_CHANNEL, midi_note);
+}
+
+// Searches for the most voices a single render thread can update within a period, going by p99 times.
+static void synth_model_polyphony_benchmark(synth_update_state_t* update_state, const char* mode)
+{
+	char name[64];
+	double period_ns = BENCHMARK_PERIOD_SAMPLES * 1000000000.0 / SYSTEM_SAMPLE_RATE;
+	benchmark_options_t saved_options = benchmark_options;
+	int sustainable = 0;
+	int unsustainable = SYNTH_MAX_VOICES + 1;
+	int voices = SYNTH_MAX_VOICES;
+
+	benchmark_options.warmup_runs = POLYPHONY_WARMUP_RUNS;
+	benchmark_options.runs = POLYPHONY_RUNS;
+	benchmark_options.iterations = POLYPHONY_ITERATIONS;
+
+	while (unsustainable - sustainable > 1)
+	{
+		synth_model_play_notes(voices);
+		sprintf(name, "synth_model_polyphony%s_%d_voices", mode, voices);
+		double p99_ns = benchmark_run(GROUP_SYNTH_MODEL, name, synth_model_update_benchmark, update_state, BENCHMARK_PERIOD_SAMPLES);
+
+		if (p99_ns < 0.0)
+		{
+			break;
+		}
+
+		if (p99_ns <= period_ns)
+		{
+			sustainable = voices;
+		}
+		else
+		{
+			unsustainable = voices;
+		}
+
+		voices = (sustainable + unsustainable) / 2;
+	}
+
+	benchmark_options = saved_options;
+
+	if (unsustainable - sustainable <= 1)
+	{
+		sprintf(name, "max_polyphony%s_per_core", mode);
+		benchmark_report(GROUP_SYNTH_MODEL, name, sustainable, sustainable == SYNTH_MAX_VOICES ? "voices (synth maximum)" : "voices");
+	}
+}
+
+void synth_model_benchmarks()
+{
+	char name[64];
+	synth_update_state_t update_state;
+	sample_t* buffer = (sample_t*)calloc(BENCHMARK_PERIOD_SAMPLES * 2, sizeof(sample_t));
+
+	synth_model_benchmark_initialise();
+
+	update_state.synth_model = &synth_model;
+	update_state.timestep_ms = TIMESTEP_MS;
+	update_state.sample_count = BENCHMARK_PERIOD_SAMPLES;
+	update_state.buffer_data = buffer;
+
+	int max_voices = benchmark_options.max_voices < SYNTH_MAX_VOICES ? benchmark_options.max_voices : SYNTH_MAX_VOICES;
+
+	for (int voices = 1; voices <= max_voices; voices++)
+	{
+		synth_model_play_notes(voices);
+		sprintf(name, "mod_matrix_update_%d_voices", voices);
+		benchmark_run(GROUP_MOD_MATRIX, name, mod_matrix_update_benchmark, &update_state, BENCHMARK_PERIOD_SAMPLES);
+
+		synth_model_play_notes(voices);
+		sprintf(name, "synth_model_update_%d_voices", voices);
+		benchmark_run(GROUP_SYNTH_MODEL, name, synth_model_update_benchmark, &update_state, BENCHMARK_PERIOD_SAMPLES);
+
+		synth_model_set_fused_voices(&synth_model, TRUE);
+		synth_model_play_notes(voices);
+		sprintf(name, "synth_model_update_fused_%d_voices", voices);
+		benchmark_run(GROUP_SYNTH_MODEL, name, synth_model_update_benchmark, &update_state, BENCHMARK_PERIOD_SAMPLES);
+		synth_model_set_fused_voices(&synth_model, FALSE);
+	}
+
+	synth_model_play_notes(BENCHMARK_NOTE_LIMIT);
+	sprintf(name, "synth_model_note_on_off_%d_voices", BENCHMARK_NOTE_LIMIT);
+	benchmark_run(GROUP_SYNTH_MODEL, name, synth_model_note_on_off_benchmark, NULL, 0);
+
+	synth_model_polyphony_benchmark(&update_state, "");
+	synth_model_set_fused_voices(&synth_model, TRUE);
+	synth_model_polyphony_benchmark(&update_state, "_fused");
+	synth_model_set_fused_voices(&synth_model, FALSE);
+
+	synth_model_play_notes(0);
+	synth_model_benchmark_deinitialise();
+	free(buffer);
+}
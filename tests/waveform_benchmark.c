@@ -0,0 +1,492 @@
+// Pithesiser - a software synthesiser for Raspberry Pi
+// Copyright (C) 2015 Nicholas Tuckett
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * waveform_benchmark.c
+ *
+ *  Created on: 16 Feb 2013
+ *      Author: ntuckett
+ */
+
+#include "benchmark.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../system_constants.h"
+#include "../waveform.h"
+#include "../oscillator.h"
+#include "../waveform_internal.h"
+#include "../float_waveform.h"
+#include "../fixed_point_math.h"
+#include "../dsp_kernel.h"
+#include "../waveform_wavetable.h"
+#include "../oscillator_stack.h"
+
+static const char* GROUP_WAVEFORM = "waveform";
+
+static const char* waveform_names[WAVE_COUNT] =
+{
+	"wavetable_sine",
+	"wavetable_saw",
+	"wavetable_saw_bl",
+	"wavetable_sine_linear",
+	"wavetable_saw_linear",
+	"wavetable_saw_linear_bl",
+	"wavetable_sine_hermite",
+	"wavetable_saw_hermite_bl",
+	"wavetable_sine_optimal",
+	"wavetable_saw_optimal_bl",
+	"procedural_sine",
+	"procedural_saw",
+	"procedural_saw_blep",
+	"procedural_square_blep",
+	"procedural_pulse_blep",
+	"procedural_triangle_blep",
+	"lfo_sine",
+	"lfo_saw_down",
+	"lfo_saw_up",
+	"lfo_triangle",
+	"lfo_square",
+	"lfo_halfsaw_down",
+	"lfo_halfsaw_up",
+	"lfo_halfsine",
+	"lfo_halftriangle"
+};
+
+typedef struct generator_benchmark_t
+{
+	waveform_generator_t*	generator;
+	generator_output_func_t	func;
+	oscillator_t			osc;
+	sample_t				buffer[BENCHMARK_PERIOD_SAMPLES * 2];
+} generator_benchmark_t;
+
+typedef void (*float_procedural_func_t)(float_oscillator_t *osc, float *sample_buffer, int sample_count);
+
+typedef struct float_waveform_benchmark_t
+{
+	float_oscillator_t	osc;
+	float_waveform_t	waveform;
+	float_procedural_func_t	procedural_func;
+	float				buffer[BENCHMARK_PERIOD_SAMPLES * 2];
+} float_waveform_benchmark_t;
+
+static void generator_benchmark(void* data)
+{
+	generator_benchmark_t* benchmark = (generator_benchmark_t*)data;
+	benchmark->func(&benchmark->generator->definition, &benchmark->osc, benchmark->buffer, BENCHMARK_PERIOD_SAMPLES);
+	benchmark->osc.last_level = benchmark->osc.level;
+}
+
+static void float_procedural_sine_benchmark(void* data)
+{
+	float_waveform_benchmark_t* benchmark = (float_waveform_benchmark_t*)data;
+	waveform_float_procedural_sine(&benchmark->osc, benchmark->buffer, BENCHMARK_PERIOD_SAMPLES);
+	benchmark->osc.last_level = benchmark->osc.level;
+}
+
+static void float_procedural_sine_mix_benchmark(void* data)
+{
+	float_waveform_benchmark_t* benchmark = (float_waveform_benchmark_t*)data;
+	waveform_float_procedural_sine_mix(&benchmark->osc, benchmark->buffer, BENCHMARK_PERIOD_SAMPLES);
+	benchmark->osc.last_level = benchmark->osc.level;
+}
+
+static void float_procedural_benchmark(void* data)
+{
+	float_waveform_benchmark_t* benchmark = (float_waveform_benchmark_t*)data;
+	benchmark->procedural_func(&benchmark->osc, benchmark->buffer, BENCHMARK_PERIOD_SAMPLES);
+	benchmark->osc.last_level = benchmark->osc.level;
+}
+
+static void float_wavetable_sine_benchmark(void* data)
+{
+	float_waveform_benchmark_t* benchmark = (float_waveform_benchmark_t*)data;
+	waveform_float_wavetable_sine(&benchmark->waveform, &benchmark->osc, benchmark->buffer, BENCHMARK_PERIOD_SAMPLES);
+	benchmark->osc.last_level = benchmark->osc.level;
+}
+
+static void float_wavetable_sine_mix_benchmark(void* data)
+{
+	float_waveform_benchmark_t* benchmark = (float_waveform_benchmark_t*)data;
+	waveform_float_wavetable_sine_mix(&benchmark->waveform, &benchmark->osc, benchmark->buffer, BENCHMARK_PERIOD_SAMPLES);
+	benchmark->osc.last_level = benchmark->osc.level;
+}
+
+static void run_generator_benchmark(waveform_type_t waveform, generator_output_func_t func, const char* variant)
+{
+	if (func == NULL)
+	{
+		return;
+	}
+
+	generator_benchmark_t* benchmark = calloc(1, sizeof(generator_benchmark_t));
+	osc_init(&benchmark->osc);
+	benchmark->generator = &generators[waveform];
+	benchmark->func = func;
+	benchmark->osc.waveform = waveform;
+	benchmark->osc.frequency = DOUBLE_TO_FIXED(440.0);
+	benchmark->osc.pulse_width = DOUBLE_TO_FIXED(0.25);
+	benchmark->osc.level = LEVEL_MAX;
+	benchmark->osc.last_level = LEVEL_MAX;
+
+	char name[64];
+	snprintf(name, sizeof(name), "%s_%s", waveform_names[waveform], variant);
+	benchmark_run(GROUP_WAVEFORM, name, generator_benchmark, benchmark, BENCHMARK_PERIOD_SAMPLES);
+	free(benchmark);
+}
+
+//-----------------------------------------------------------------------------------------------------------------------
+// Wavetable interpolation
+//
+// Each way of interpolating a table is timed on its own, then its signal to noise ratio & response measured on sines
+// that are oversampled by different amounts in the table, to pick the cheapest interpolation that meets a target SNR.
+// Band-limited tables are oversampled at least 2x at the top of each level's range, and 4x at the bottom.
+// The SIMD kernels match the C ones bit for bit, so only their timings are reported.
+//
+#define INTERP_TABLE_BITS		10
+#define INTERP_TABLE_SIZE		(1 << INTERP_TABLE_BITS)
+#define INTERP_SNR_SAMPLES		8192
+#define INTERP_PHASE_STEP		(0x00400000 + 0x12345)		// Just over a table sample per output sample
+
+typedef struct wavetable_kernel_benchmark_t
+{
+	wavetable_kernel_t	kernel;
+	const sample_t*		table;
+	uint32_t			phase;
+	sample_t			buffer[BENCHMARK_PERIOD_SAMPLES];
+} wavetable_kernel_benchmark_t;
+
+typedef struct interpolation_t
+{
+	const char*			name;
+	wavetable_kernel_t	kernel;
+	int					polynomial;
+} interpolation_t;
+
+// As wavetable_output does, for comparison.
+static void wavetable_nearest(const sample_t *table, int size_bits, uint32_t phase, uint32_t phase_step, int sample_count, sample_t *dest)
+{
+	for (int i = 0; i < sample_count; i++, phase += phase_step)
+	{
+		dest[i] = table[phase >> (32 - size_bits)];
+	}
+}
+
+static void wavetable_linear(const sample_t *table, int size_bits, uint32_t phase, uint32_t phase_step, int sample_count, sample_t *dest)
+{
+	int index_shift = 32 - size_bits;
+
+	for (int i = 0; i < sample_count; i++, phase += phase_step)
+	{
+		uint32_t index = phase >> index_shift;
+		int32_t delta = (sample_t)(table[(index + 1) & ((1 << size_bits) - 1)] - table[index]);
+		dest[i] = table[index] + ((delta * (int32_t)((phase >> (index_shift - 15)) & 0x7fff)) >> 15);
+	}
+}
+
+static const int interp_oversampling[] = { 16, 4, 2 };
+
+static void wavetable_kernel_benchmark(void* data)
+{
+	wavetable_kernel_benchmark_t* benchmark = (wavetable_kernel_benchmark_t*)data;
+
+	benchmark->kernel(benchmark->table, INTERP_TABLE_BITS, benchmark->phase, INTERP_PHASE_STEP, BENCHMARK_PERIOD_SAMPLES, benchmark->buffer);
+	benchmark->phase += INTERP_PHASE_STEP * BENCHMARK_PERIOD_SAMPLES;
+}
+
+static double run_wavetable_kernel_benchmark(const char* name, wavetable_kernel_t kernel, const sample_t* table)
+{
+	wavetable_kernel_benchmark_t* benchmark = calloc(1, sizeof(wavetable_kernel_benchmark_t));
+	benchmark->kernel = kernel;
+	benchmark->table = table;
+
+	double result = benchmark_run(GROUP_WAVEFORM, name, wavetable_kernel_benchmark, benchmark, BENCHMARK_PERIOD_SAMPLES);
+	free(benchmark);
+	return result;
+}
+
+// A table of cycles sine cycles, in samples & as polynomial coefficients.
+static void generate_interp_tables(int cycles, sample_t* table, sample_t* coeffs)
+{
+	for (int i = 0; i <= INTERP_TABLE_SIZE; i++)
+	{
+		table[i] = lround(sin(i * cycles * (2.0 * M_PI / INTERP_TABLE_SIZE)) * SHRT_MAX);
+	}
+	wavetable_generate_poly_coeffs(table, coeffs, INTERP_TABLE_BITS);
+}
+
+// Gain & phase errors are a frequency response rather than noise, so noise is measured against the sine that best
+// fits the output, and that sine's level relative to the table's is reported as the response.
+static void measure_interpolation(const interpolation_t* interpolation, int cycles, const sample_t* table, const sample_t* coeffs, double* snr, double* response)
+{
+	sample_t* buffer = malloc(INTERP_SNR_SAMPLES * sizeof(sample_t));
+	double sin_level = 0.0, cos_level = 0.0, sin_power = 0.0, cos_power = 0.0;
+	uint32_t start_phase = 0x1234567;
+	uint32_t phase = start_phase;
+
+	interpolation->kernel(interpolation->polynomial ? coeffs : table, INTERP_TABLE_BITS, phase, INTERP_PHASE_STEP, INTERP_SNR_SAMPLES, buffer);
+
+	for (int i = 0; i < INTERP_SNR_SAMPLES; i++, phase += INTERP_PHASE_STEP)
+	{
+		double angle = phase * cycles * (2.0 * M_PI / 4294967296.0);
+		sin_level += buffer[i] * sin(angle);
+		cos_level += buffer[i] * cos(angle);
+		sin_power += sin(angle) * sin(angle);
+		cos_power += cos(angle) * cos(angle);
+	}
+
+	sin_level /= sin_power;
+	cos_level /= cos_power;
+
+	double signal = 0.0, noise = 0.0;
+	phase = start_phase;
+
+	for (int i = 0; i < INTERP_SNR_SAMPLES; i++, phase += INTERP_PHASE_STEP)
+	{
+		double angle = phase * cycles * (2.0 * M_PI / 4294967296.0);
+		double fitted = sin_level * sin(angle) + cos_level * cos(angle);
+		signal += fitted * fitted;
+		noise += (buffer[i] - fitted) * (buffer[i] - fitted);
+	}
+
+	free(buffer);
+	*snr = 10.0 * log10(signal / noise);
+	*response = 20.0 * log10(sqrt(sin_level * sin_level + cos_level * cos_level) / SHRT_MAX);
+}
+
+static void run_interpolation_benchmarks()
+{
+	const interpolation_t interpolations[] =
+	{
+		{ "nearest", wavetable_nearest, FALSE },
+		{ "linear", wavetable_linear, FALSE },
+		{ "hermite", dsp_kernels_c.wavetable_hermite, FALSE },
+		{ "optimal", dsp_kernels_c.wavetable_polynomial, TRUE }
+	};
+	char name[64];
+
+	sample_t* table = malloc((INTERP_TABLE_SIZE + 1) * sizeof(sample_t));
+	sample_t* coeffs = malloc(INTERP_TABLE_SIZE * DSP_POLY_COEFFS * sizeof(sample_t));
+
+	generate_interp_tables(1, table, coeffs);
+
+	for (int i = 0; i < dsp_kernels_count(); i++)
+	{
+		const dsp_kernels_t* kernels = dsp_kernels_get(i);
+
+		if (kernels->supported())
+		{
+			snprintf(name, sizeof(name), "wavetable_hermite_kernel_%s", kernels->name);
+			run_wavetable_kernel_benchmark(name, kernels->wavetable_hermite, table);
+			snprintf(name, sizeof(name), "wavetable_polynomial_kernel_%s", kernels->name);
+			run_wavetable_kernel_benchmark(name, kernels->wavetable_polynomial, coeffs);
+		}
+	}
+
+	for (int i = 0; i < sizeof(interpolations) / sizeof(interpolations[0]); i++)
+	{
+		const interpolation_t* interpolation = &interpolations[i];
+
+		generate_interp_tables(1, table, coeffs);
+		snprintf(name, sizeof(name), "wavetable_interp_%s", interpolation->name);
+		if (run_wavetable_kernel_benchmark(name, interpolation->kernel, interpolation->polynomial ? coeffs : table) < 0.0)
+		{
+			continue;
+		}
+
+		for (int j = 0; j < sizeof(interp_oversampling) / sizeof(interp_oversampling[0]); j++)
+		{
+			// 2x oversampled has 4 table samples per cycle.
+			int cycles = INTERP_TABLE_SIZE / (interp_oversampling[j] * 2);
+
+			double snr, response;
+
+			generate_interp_tables(cycles, table, coeffs);
+			measure_interpolation(interpolation, cycles, table, coeffs, &snr, &response);
+			snprintf(name, sizeof(name), "wavetable_interp_%s_snr_%dx", interpolation->name, interp_oversampling[j]);
+			benchmark_report(GROUP_WAVEFORM, name, snr, "dB");
+			snprintf(name, sizeof(name), "wavetable_interp_%s_response_%dx", interpolation->name, interp_oversampling[j]);
+			benchmark_report(GROUP_WAVEFORM, name, response, "dB");
+		}
+	}
+
+	free(coeffs);
+	free(table);
+}
+
+//-----------------------------------------------------------------------------------------------------------------------
+// Unison
+//
+// A 7 oscillator supersaw, rendered by each set's unison kernel, through an oscillator stack, and as the same
+// oscillators mixed one after another for comparison.
+//
+#define UNISON_OSCILLATORS		7
+#define UNISON_SPREAD			25.0f
+
+typedef struct unison_kernel_benchmark_t
+{
+	wavetable_unison_kernel_t	kernel;
+	const sample_t*				table;
+	int							size_bits;
+	uint32_t					phase[UNISON_OSCILLATORS];
+	uint32_t					phase_step[UNISON_OSCILLATORS];
+	int32_t						level[UNISON_OSCILLATORS];
+	sample_t					buffer[BENCHMARK_PERIOD_SAMPLES];
+} unison_kernel_benchmark_t;
+
+typedef struct unison_benchmark_t
+{
+	oscillator_t	voice_osc;
+	osc_stack_t		stack;
+	sample_t		buffer[BENCHMARK_PERIOD_SAMPLES];
+} unison_benchmark_t;
+
+static void unison_kernel_benchmark(void* data)
+{
+	unison_kernel_benchmark_t* benchmark = (unison_kernel_benchmark_t*)data;
+	benchmark->kernel(benchmark->table, benchmark->size_bits, UNISON_OSCILLATORS, benchmark->phase, benchmark->phase_step, benchmark->level, BENCHMARK_PERIOD_SAMPLES, benchmark->buffer);
+}
+
+static void unison_stack_benchmark(void* data)
+{
+	unison_benchmark_t* benchmark = (unison_benchmark_t*)data;
+	osc_stack_output(&benchmark->stack, &benchmark->voice_osc, benchmark->buffer, BENCHMARK_PERIOD_SAMPLES);
+}
+
+static void unison_sequential_benchmark(void* data)
+{
+	unison_benchmark_t* benchmark = (unison_benchmark_t*)data;
+
+	osc_output(benchmark->stack.oscillator, benchmark->buffer, BENCHMARK_PERIOD_SAMPLES);
+	for (int i = 1; i < UNISON_OSCILLATORS; i++)
+	{
+		osc_mix_output(benchmark->stack.oscillator + i, benchmark->buffer, BENCHMARK_PERIOD_SAMPLES);
+	}
+}
+
+static void run_unison_benchmarks()
+{
+	osc_stack_def_t stack_def = { UNISON_OSCILLATORS, TRUE, UNISON_SPREAD };
+	unison_benchmark_t* benchmark = calloc(1, sizeof(unison_benchmark_t));
+	unison_kernel_benchmark_t* kernel_benchmark = calloc(1, sizeof(unison_kernel_benchmark_t));
+	char name[64];
+
+	osc_init(&benchmark->voice_osc);
+	benchmark->voice_osc.waveform = WAVETABLE_SAW_BL;
+	benchmark->voice_osc.frequency = DOUBLE_TO_FIXED(440.0);
+	benchmark->voice_osc.level = LEVEL_MAX;
+	benchmark->voice_osc.last_level = LEVEL_MAX;
+
+	osc_stack_init(&benchmark->stack);
+	osc_stack_set_definition(&benchmark->stack, &stack_def);
+	osc_stack_reset(&benchmark->stack);
+
+	// The stack sets each oscillator's frequency as it renders.
+	osc_stack_output(&benchmark->stack, &benchmark->voice_osc, benchmark->buffer, BENCHMARK_PERIOD_SAMPLES);
+
+	for (int i = 0; i < UNISON_OSCILLATORS; i++)
+	{
+		oscillator_t* osc = benchmark->stack.oscillator + i;
+
+		kernel_benchmark->table = wavetable_select(WAVETABLE_SAW_BL, osc->frequency, &kernel_benchmark->size_bits, kernel_benchmark->phase_step + i);
+		kernel_benchmark->phase[i] = (uint32_t)osc->phase_accumulator;
+		kernel_benchmark->level[i] = osc->level;
+	}
+
+	for (int i = 0; i < dsp_kernels_count(); i++)
+	{
+		const dsp_kernels_t* kernels = dsp_kernels_get(i);
+
+		if (kernels->supported())
+		{
+			kernel_benchmark->kernel = kernels->wavetable_unison;
+			snprintf(name, sizeof(name), "wavetable_unison_kernel_%s", kernels->name);
+			benchmark_run(GROUP_WAVEFORM, name, unison_kernel_benchmark, kernel_benchmark, BENCHMARK_PERIOD_SAMPLES);
+		}
+	}
+
+	benchmark_run(GROUP_WAVEFORM, "supersaw_stack", unison_stack_benchmark, benchmark, BENCHMARK_PERIOD_SAMPLES);
+
+	// Linearly interpolated like the stack, at the stack's levels.
+	for (int i = 0; i < UNISON_OSCILLATORS; i++)
+	{
+		benchmark->stack.oscillator[i].waveform = WAVETABLE_SAW_LINEAR_BL;
+	}
+	benchmark_run(GROUP_WAVEFORM, "supersaw_sequential", unison_sequential_benchmark, benchmark, BENCHMARK_PERIOD_SAMPLES);
+
+	free(kernel_benchmark);
+	free(benchmark);
+}
+
+static void run_float_benchmarks()
+{
+	float_waveform_benchmark_t* benchmark = calloc(1, sizeof(float_waveform_benchmark_t));
+	float_generate_sine(&benchmark->waveform, 10);		// 1024 samples, as the fixed point sine table
+	benchmark->osc.frequency = 440.0f;
+	benchmark->osc.level = 1.0f;
+	benchmark->osc.last_level = 1.0f;
+
+	benchmark_run(GROUP_WAVEFORM, "float_procedural_sine_output", float_procedural_sine_benchmark, benchmark, BENCHMARK_PERIOD_SAMPLES);
+	benchmark_run(GROUP_WAVEFORM, "float_procedural_sine_mix", float_procedural_sine_mix_benchmark, benchmark, BENCHMARK_PERIOD_SAMPLES);
+	benchmark_run(GROUP_WAVEFORM, "float_wavetable_sine_output", float_wavetable_sine_benchmark, benchmark, BENCHMARK_PERIOD_SAMPLES);
+	benchmark_run(GROUP_WAVEFORM, "float_wavetable_sine_mix", float_wavetable_sine_mix_benchmark, benchmark, BENCHMARK_PERIOD_SAMPLES);
+
+	free(benchmark->waveform.samples);
+	free(benchmark);
+}
+
+static void run_float_procedural_benchmark(float_procedural_func_t func, const char* name)
+{
+	float_waveform_benchmark_t* benchmark = calloc(1, sizeof(float_waveform_benchmark_t));
+	benchmark->procedural_func = func;
+	benchmark->osc.frequency = 440.0f;
+	benchmark->osc.pulse_width = 0.25f;
+	benchmark->osc.level = 1.0f;
+	benchmark->osc.last_level = 1.0f;
+
+	benchmark_run(GROUP_WAVEFORM, name, float_procedural_benchmark, benchmark, BENCHMARK_PERIOD_SAMPLES);
+	free(benchmark);
+}
+
+static void run_float_polyblep_benchmarks()
+{
+	run_float_procedural_benchmark(waveform_float_polyblep_saw, "float_polyblep_saw_output");
+	run_float_procedural_benchmark(waveform_float_polyblep_saw_mix, "float_polyblep_saw_mix");
+	run_float_procedural_benchmark(waveform_float_polyblep_square, "float_polyblep_square_output");
+	run_float_procedural_benchmark(waveform_float_polyblep_square_mix, "float_polyblep_square_mix");
+	run_float_procedural_benchmark(waveform_float_polyblep_pulse, "float_polyblep_pulse_output");
+	run_float_procedural_benchmark(waveform_float_polyblep_pulse_mix, "float_polyblep_pulse_mix");
+	run_float_procedural_benchmark(waveform_float_polyblep_triangle, "float_polyblep_triangle_output");
+	run_float_procedural_benchmark(waveform_float_polyblep_triangle_mix, "float_polyblep_triangle_mix");
+}
+
+void waveform_benchmarks()
+{
+	waveform_initialise(NULL);
+
+	for (int waveform = 0; waveform < WAVE_COUNT; waveform++)
+	{
+		run_generator_benchmark(waveform, generators[waveform].output_func, "output");
+		run_generator_benchmark(waveform, generators[waveform].mix_func, "mix");
+		run_generator_benchmark(waveform, generators[waveform].mid_func, "mid");
+	}
+
+	run_interpolation_benchmarks();
+	run_unison_benchmarks();
+	run_float_benchmarks();
+	run_float_polyblep_benchmarks();
+}
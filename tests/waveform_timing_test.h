@@ -1,29 +0,0 @@
-// Pithesiser - a software synthesiser for Raspberry Pi
-// Copyright (C) 2015 Nicholas Tuckett
-// 
-// This program is free software: you can redistribute it and/or modify
-// it under the terms of the GNU General Public License as published by
-// the Free Software Foundation, either version 3 of the License, or
-// (at your option) any later version.
-// 
-// This program is distributed in the hope that it will be useful,
-// but WITHOUT ANY WARRANTY; without even the implied warranty of
-// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-// GNU General Public License for more details.
-// 
-// You should have received a copy of the GNU General Public License
-// along with this program.  If not, see <http://www.gnu.org/licenses/>.
-
-/*
- * waveform_timing_test.h
- *
- *  Created on: 16 Feb 2013
- *      Author: ntuckett
- */
-
-#ifndef WAVEFORM_TIMING_TEST_H_
-#define WAVEFORM_TIMING_TEST_H_
-
-extern void waveform_timing_test(int count);
-
-#endif /* WAVEFORM_TIMING_TEST_H_ */
@@ -25,6 +25,7 @@
 #include <stddef.h>
 #include "midi.h"
 #include "logging.h"
+#include "dsp_kernel.h"
 
 #define MAX_VOICE_CALLBACKS		4
 
@@ -45,9 +46,9 @@ static void init_voice(voice_t *voice)
 	voice->midi_channel = 0;
 	voice->last_state = NOTE_NOT_PLAYING;
 	voice->current_state = NOTE_NOT_PLAYING;
-	voice->play_counter = 0;
 
 	osc_init(&voice->oscillator);
+	osc_stack_init(&voice->oscillator_stack);
 	filter_init(&voice->filter);
 	voice->filter_def = voice->filter.definition;
 }
@@ -133,6 +134,7 @@ void voice_preupdate(voice_t *voice, int32_t timestep_ms, filter_definition_t *f
 		else if (voice->current_state >= 0)
 		{
 			voice->oscillator.phase_accumulator = 0;
+			osc_stack_reset(&voice->oscillator_stack);
 			voice_make_callback(VOICE_EVENT_NOTE_STARTING, voice);
 			filter_silence(&voice->filter);
 		}
@@ -148,7 +150,8 @@ void voice_preupdate(voice_t *voice, int32_t timestep_ms, filter_definition_t *f
 	voice->filter_def = *filter_def;
 }
 
-int voice_update(voice_t *voice, int32_t master_level, sample_t *voice_buffer, int buffer_samples, int32_t timestep_ms)
+// Updates the voice level & filter ahead of rendering, returning VOICE_ACTIVE if there is anything to render.
+static int voice_prepare_update(voice_t *voice, int32_t master_level)
 {
 	int voice_state = VOICE_IDLE;
 
@@ -170,14 +173,12 @@ int voice_update(voice_t *voice, int32_t master_level, sample_t *voice_buffer, i
 
 		if (voice->oscillator.level > 0 || voice->oscillator.last_level != 0)
 		{
-			osc_output(&voice->oscillator, voice_buffer, buffer_samples);
-			filter_apply(&voice->filter, voice_buffer, buffer_samples);
-			voice->oscillator.last_level = voice->oscillator.level;
 			voice_state = VOICE_ACTIVE;
 		}
 		else if (voice->current_state == NOTE_ENDING)
 		{
-			voice_kill(voice);
+			// Killing the voice is left to the caller, as voice callbacks must only be made from
+			// the thread that owns the synth model, while voices may be updated on render workers.
 			voice_state = VOICE_GONE_IDLE;
 		}
 	}
@@ -185,6 +186,54 @@ int voice_update(voice_t *voice, int32_t master_level, sample_t *voice_buffer, i
 	return voice_state;
 }
 
+// Plays the oscillator stack in place of the voice oscillator when it has more than one oscillator.
+static void voice_output(voice_t *voice, sample_t *voice_buffer, int buffer_samples)
+{
+	if (OSC_STACK_ACTIVE(&voice->oscillator_stack))
+	{
+		osc_stack_output(&voice->oscillator_stack, &voice->oscillator, voice_buffer, buffer_samples);
+	}
+	else
+	{
+		osc_output(&voice->oscillator, voice_buffer, buffer_samples);
+	}
+}
+
+// Renders the voice without applying its filter, so the caller can filter several voices together.
+int voice_update_unfiltered(voice_t *voice, int32_t master_level, sample_t *voice_buffer, int buffer_samples, int32_t timestep_ms)
+{
+	int voice_state = voice_prepare_update(voice, master_level);
+
+	if (voice_state == VOICE_ACTIVE)
+	{
+		voice_output(voice, voice_buffer, buffer_samples);
+		voice->oscillator.last_level = voice->oscillator.level;
+	}
+
+	return voice_state;
+}
+
+// Renders, filters and mixes the voice onto the mix bus in a single pass where the waveform allows,
+// otherwise through voice_buffer. Oscillator stacks are always rendered through voice_buffer.
+int voice_update_fused(voice_t *voice, int32_t master_level, sample_t *voice_buffer, bus_sample_t *bus, int buffer_samples, int32_t timestep_ms)
+{
+	int voice_state = voice_prepare_update(voice, master_level);
+
+	if (voice_state == VOICE_ACTIVE)
+	{
+		if (OSC_STACK_ACTIVE(&voice->oscillator_stack) || !osc_voice_output(&voice->oscillator, &voice->filter, PAN_MAX, PAN_MAX, bus, buffer_samples))
+		{
+			voice_output(voice, voice_buffer, buffer_samples);
+			filter_apply(&voice->filter, voice_buffer, buffer_samples);
+			dsp_kernels->mixdown_mono_to_bus(voice_buffer, PAN_MAX, PAN_MAX, buffer_samples, bus);
+		}
+
+		voice->oscillator.last_level = voice->oscillator.level;
+	}
+
+	return voice_state;
+}
+
 void voice_play_note(voice_t *voice, int midi_note, waveform_type_t waveform)
 {
 	int initial_state = voice->current_state;
@@ -213,55 +262,10 @@ void voice_kill(voice_t * voice)
 {
 	if (voice->current_state != NOTE_NOT_PLAYING)
 	{
+		// Idle voices are no longer pre-updated, so settle the state here.
 		voice->current_state = NOTE_NOT_PLAYING;
+		voice->last_state = NOTE_NOT_PLAYING;
+		voice->oscillator.level = 0;
 		voice_make_callback(VOICE_EVENT_VOICE_ENDED, voice);
 	}
 }
-
-voice_t *voice_find_next_likely_free(voice_t *voices, int voice_count, int midi_channel)
-{
-	int candidate_voice = -1;
-	int lowest_play_counter = INT_MAX;
-
-	for (int i = 0; i < voice_count; i++)
-	{
-		if (voices[i].midi_channel == midi_channel)
-		{
-			if (voices[i].current_state == NOTE_NOT_PLAYING)
-			{
-				candidate_voice = i;
-				break;
-			}
-			else
-			{
-				if (voices[i].play_counter < lowest_play_counter)
-				{
-					lowest_play_counter = voices[i].play_counter;
-					candidate_voice = i;
-				}
-			}
-		}
-	}
-
-	if (candidate_voice >= 0)
-	{
-		return voices + candidate_voice;
-	}
-	else
-	{
-		return NULL;
-	}
-}
-
-voice_t *voice_find_playing_note(voice_t *voices, int voice_count, int midi_channel, int midi_note)
-{
-	for (int i = 0; i < voice_count; i++)
-	{
-		if (voices[i].current_state == midi_note && voices[i].midi_channel == midi_channel)
-		{
-			return voices + i;
-		}
-	}
-
-	return NULL;
-}
@@ -26,6 +26,7 @@
 
 #include "envelope.h"
 #include "oscillator.h"
+#include "oscillator_stack.h"
 #include "lfo.h"
 #include "filter.h"
 
@@ -44,9 +45,9 @@ typedef struct voice_t
 	int note;
 	int last_state;
 	int current_state;
-	int play_counter;
 	fixed_t frequency;
 	oscillator_t oscillator;
+	osc_stack_t oscillator_stack;
 	filter_definition_t filter_def;
 	filter_t filter;
 } voice_t;
@@ -66,11 +67,10 @@ extern void voices_add_callback(voice_callback_t callback, void* callback_data);
 extern void voices_remove_callback(voice_callback_t callback);
 
 extern void voice_preupdate(voice_t *voice, int32_t timestep_ms, filter_definition_t *filter_def);
-extern int voice_update(voice_t *voice, int32_t master_level, sample_t *voice_buffer, int buffer_samples, int32_t timestep_ms);
+extern int voice_update_unfiltered(voice_t *voice, int32_t master_level, sample_t *voice_buffer, int buffer_samples, int32_t timestep_ms);
+extern int voice_update_fused(voice_t *voice, int32_t master_level, sample_t *voice_buffer, bus_sample_t *bus, int buffer_samples, int32_t timestep_ms);
 extern void voice_play_note(voice_t *voice, int midi_note, waveform_type_t waveform);
 extern void voice_stop_note(voice_t *voice);
 extern void voice_kill(voice_t * voice);
-extern voice_t *voice_find_next_likely_free(voice_t *voices, int voice_count, int midi_channel);
-extern voice_t *voice_find_playing_note(voice_t *voices, int voice_count, int midi_channel, int midi_note);
 
 #endif /* VOICE_H_ */
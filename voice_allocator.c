@@ -0,0 +1,234 @@
+// Pithesiser - a software synthesiser for Raspberry Pi
+// Copyright (C) 2015 Nicholas Tuckett
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+/*
+ * voice_allocator.c
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: ntuckett
+ *
+ *  The lists are doubly linked through per voice index arrays, so moving a voice between
+ *  lists is constant time. New voices join the tail of a list, so each head is the oldest.
+ */
+
+#include "voice_allocator.h"
+#include <stdlib.h>
+#include "system_constants.h"
+#include "logging.h"
+
+#define NO_VOICE	-1
+
+static int note_key(int midi_channel, int midi_note)
+{
+	return (midi_channel & (VOICE_ALLOCATOR_CHANNEL_COUNT - 1)) * VOICE_ALLOCATOR_NOTE_COUNT + (midi_note & (VOICE_ALLOCATOR_NOTE_COUNT - 1));
+}
+
+static void list_init(voice_list_t* list)
+{
+	list->head = NO_VOICE;
+	list->tail = NO_VOICE;
+	list->count = 0;
+}
+
+static void list_append(voice_allocator_t* allocator, voice_list_t* list, int voice_index)
+{
+	allocator->prev[voice_index] = list->tail;
+	allocator->next[voice_index] = NO_VOICE;
+
+	if (list->tail != NO_VOICE)
+	{
+		allocator->next[list->tail] = voice_index;
+	}
+	else
+	{
+		list->head = voice_index;
+	}
+
+	list->tail = voice_index;
+	list->count++;
+	allocator->list[voice_index] = list;
+}
+
+static void list_remove(voice_allocator_t* allocator, int voice_index)
+{
+	voice_list_t* list = allocator->list[voice_index];
+	int prev = allocator->prev[voice_index];
+	int next = allocator->next[voice_index];
+
+	if (prev != NO_VOICE)
+	{
+		allocator->next[prev] = next;
+	}
+	else
+	{
+		list->head = next;
+	}
+
+	if (next != NO_VOICE)
+	{
+		allocator->prev[next] = prev;
+	}
+	else
+	{
+		list->tail = prev;
+	}
+
+	list->count--;
+	allocator->list[voice_index] = NULL;
+}
+
+static void move_to_list(voice_allocator_t* allocator, voice_list_t* list, int voice_index)
+{
+	if (allocator->list[voice_index] != NULL)
+	{
+		list_remove(allocator, voice_index);
+	}
+
+	list_append(allocator, list, voice_index);
+}
+
+static void clear_note(voice_allocator_t* allocator, int voice_index)
+{
+	int key = allocator->key[voice_index];
+
+	if (key != NO_VOICE)
+	{
+		if (allocator->note_voice[key] == voice_index)
+		{
+			allocator->note_voice[key] = NO_VOICE;
+		}
+		allocator->key[voice_index] = NO_VOICE;
+	}
+}
+
+int voice_allocator_initialise(voice_allocator_t* allocator, voice_t* voices, int voice_count)
+{
+	allocator->voice		= voices;
+	allocator->voice_count	= voice_count;
+	allocator->midi_channel	= 0;
+	allocator->next			= (int*)malloc(voice_count * sizeof(int));
+	allocator->prev			= (int*)malloc(voice_count * sizeof(int));
+	allocator->list			= (voice_list_t**)malloc(voice_count * sizeof(voice_list_t*));
+	allocator->key			= (int*)malloc(voice_count * sizeof(int));
+
+	if (allocator->next == NULL || allocator->prev == NULL || allocator->list == NULL || allocator->key == NULL)
+	{
+		LOG_ERROR("Failed to allocate voice allocator for %d voices", voice_count);
+		voice_allocator_deinitialise(allocator);
+		return RESULT_ERROR;
+	}
+
+	list_init(&allocator->free);
+	list_init(&allocator->held);
+	list_init(&allocator->releasing);
+
+	for (int i = 0; i < VOICE_ALLOCATOR_CHANNEL_COUNT * VOICE_ALLOCATOR_NOTE_COUNT; i++)
+	{
+		allocator->note_voice[i] = NO_VOICE;
+	}
+
+	for (int i = 0; i < voice_count; i++)
+	{
+		allocator->key[i] = NO_VOICE;
+		allocator->list[i] = NULL;
+		list_append(allocator, &allocator->free, i);
+	}
+
+	return RESULT_OK;
+}
+
+void voice_allocator_deinitialise(voice_allocator_t* allocator)
+{
+	free(allocator->next);
+	free(allocator->prev);
+	free(allocator->list);
+	free(allocator->key);
+	allocator->next = NULL;
+	allocator->prev = NULL;
+	allocator->list = NULL;
+	allocator->key = NULL;
+	allocator->voice_count = 0;
+}
+
+void voice_allocator_set_midi_channel(voice_allocator_t* allocator, int midi_channel)
+{
+	allocator->midi_channel = midi_channel;
+
+	for (int i = 0; i < allocator->voice_count; i++)
+	{
+		allocator->voice[i].midi_channel = midi_channel;
+	}
+}
+
+voice_t* voice_allocator_play_note(voice_allocator_t* allocator, int midi_channel, int midi_note, waveform_type_t waveform)
+{
+	if (midi_channel != allocator->midi_channel)
+	{
+		return NULL;
+	}
+
+	int key = note_key(midi_channel, midi_note);
+
+	// A repeated note releases the voice already holding it, and plays on a new one.
+	if (allocator->note_voice[key] != NO_VOICE)
+	{
+		voice_stop_note(allocator->voice + allocator->note_voice[key]);
+	}
+
+	int voice_index = allocator->free.head;
+	if (voice_index == NO_VOICE)
+	{
+		voice_index = allocator->releasing.head;
+	}
+	if (voice_index == NO_VOICE)
+	{
+		voice_index = allocator->held.head;
+	}
+	if (voice_index == NO_VOICE)
+	{
+		return NULL;
+	}
+
+	clear_note(allocator, voice_index);
+	move_to_list(allocator, &allocator->held, voice_index);
+	allocator->note_voice[key] = voice_index;
+	allocator->key[voice_index] = key;
+
+	voice_t* voice = allocator->voice + voice_index;
+	voice_play_note(voice, midi_note, waveform);
+
+	return voice;
+}
+
+voice_t* voice_allocator_find_note(voice_allocator_t* allocator, int midi_channel, int midi_note)
+{
+	int voice_index = allocator->note_voice[note_key(midi_channel, midi_note)];
+
+	return voice_index != NO_VOICE ? allocator->voice + voice_index : NULL;
+}
+
+void voice_allocator_note_ending(voice_allocator_t* allocator, voice_t* voice)
+{
+	clear_note(allocator, voice->index);
+	move_to_list(allocator, &allocator->releasing, voice->index);
+}
+
+void voice_allocator_voice_ended(voice_allocator_t* allocator, voice_t* voice)
+{
+	clear_note(allocator, voice->index);
+	move_to_list(allocator, &allocator->free, voice->index);
+}
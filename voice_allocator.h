@@ -0,0 +1,76 @@
+// Pithesiser - a software synthesiser for Raspberry Pi
+// Copyright (C) 2015 Nicholas Tuckett
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+/*
+ * voice_allocator.h
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: ntuckett
+ *
+ *  Constant time voice allocation: idle voices sit on a free list, sounding voices on age ordered
+ *  held and releasing lists, and a (channel, note) map finds the voice holding a note.
+ *  When no voice is free the oldest releasing voice is stolen, then the oldest held voice.
+ */
+
+#ifndef VOICE_ALLOCATOR_H_
+#define VOICE_ALLOCATOR_H_
+
+#include "voice.h"
+
+#define VOICE_ALLOCATOR_CHANNEL_COUNT	16
+#define VOICE_ALLOCATOR_NOTE_COUNT		128
+
+typedef struct voice_list_t
+{
+	int	head;
+	int	tail;
+	int	count;
+} voice_list_t;
+
+typedef struct voice_allocator_t
+{
+	voice_t*		voice;
+	int				voice_count;
+	int				midi_channel;
+
+	// Per voice links, the list the voice is on and the note map key it holds (-1 when none).
+	int*			next;
+	int*			prev;
+	voice_list_t**	list;
+	int*			key;
+
+	voice_list_t	free;
+	voice_list_t	held;
+	voice_list_t	releasing;
+
+	int				note_voice[VOICE_ALLOCATOR_CHANNEL_COUNT * VOICE_ALLOCATOR_NOTE_COUNT];
+} voice_allocator_t;
+
+extern int voice_allocator_initialise(voice_allocator_t* allocator, voice_t* voices, int voice_count);
+extern void voice_allocator_deinitialise(voice_allocator_t* allocator);
+extern void voice_allocator_set_midi_channel(voice_allocator_t* allocator, int midi_channel);
+
+extern voice_t* voice_allocator_play_note(voice_allocator_t* allocator, int midi_channel, int midi_note, waveform_type_t waveform);
+extern voice_t* voice_allocator_find_note(voice_allocator_t* allocator, int midi_channel, int midi_note);
+
+// Voice event notifications, to keep the lists in step with the voices.
+extern void voice_allocator_note_ending(voice_allocator_t* allocator, voice_t* voice);
+extern void voice_allocator_voice_ended(voice_allocator_t* allocator, voice_t* voice);
+
+#define voice_allocator_releasing_count(allocator)	((allocator)->releasing.count)
+
+#endif /* VOICE_ALLOCATOR_H_ */
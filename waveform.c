@@ -25,21 +25,30 @@
 #include "waveform_internal.h"
 #include "waveform_wavetable.h"
 #include "waveform_procedural.h"
+#include "waveform_polyblep.h"
 
 waveform_generator_t generators[WAVE_COUNT];
 
-void waveform_initialise()
+void waveform_initialise(const char* wavetable_cache_file)
 {
-	init_wavetables();
+	init_wavetables(wavetable_cache_file);
 	init_wavetable_generator(WAVETABLE_SINE, &generators[WAVETABLE_SINE]);
 	init_wavetable_generator(WAVETABLE_SAW, &generators[WAVETABLE_SAW]);
 	init_wavetable_generator(WAVETABLE_SAW_BL, &generators[WAVETABLE_SAW_BL]);
 	init_wavetable_generator(WAVETABLE_SINE_LINEAR, &generators[WAVETABLE_SINE_LINEAR]);
 	init_wavetable_generator(WAVETABLE_SAW_LINEAR, &generators[WAVETABLE_SAW_LINEAR]);
 	init_wavetable_generator(WAVETABLE_SAW_LINEAR_BL, &generators[WAVETABLE_SAW_LINEAR_BL]);
+	init_wavetable_generator(WAVETABLE_SINE_HERMITE, &generators[WAVETABLE_SINE_HERMITE]);
+	init_wavetable_generator(WAVETABLE_SAW_HERMITE_BL, &generators[WAVETABLE_SAW_HERMITE_BL]);
+	init_wavetable_generator(WAVETABLE_SINE_OPTIMAL, &generators[WAVETABLE_SINE_OPTIMAL]);
+	init_wavetable_generator(WAVETABLE_SAW_OPTIMAL_BL, &generators[WAVETABLE_SAW_OPTIMAL_BL]);
 
 	init_procedural_generator(PROCEDURAL_SINE, &generators[PROCEDURAL_SINE]);
 	init_procedural_generator(PROCEDURAL_SAW, &generators[PROCEDURAL_SAW]);
+	init_polyblep_generator(PROCEDURAL_SAW_BLEP, &generators[PROCEDURAL_SAW_BLEP]);
+	init_polyblep_generator(PROCEDURAL_SQUARE_BLEP, &generators[PROCEDURAL_SQUARE_BLEP]);
+	init_polyblep_generator(PROCEDURAL_PULSE_BLEP, &generators[PROCEDURAL_PULSE_BLEP]);
+	init_polyblep_generator(PROCEDURAL_TRIANGLE_BLEP, &generators[PROCEDURAL_TRIANGLE_BLEP]);
 	init_procedural_generator(LFO_PROCEDURAL_SINE, &generators[LFO_PROCEDURAL_SINE]);
 	init_procedural_generator(LFO_PROCEDURAL_SAW_DOWN, &generators[LFO_PROCEDURAL_SAW_DOWN]);
 	init_procedural_generator(LFO_PROCEDURAL_SAW_UP, &generators[LFO_PROCEDURAL_SAW_UP]);
@@ -34,9 +34,17 @@ typedef enum
 	WAVETABLE_SINE_LINEAR,
 	WAVETABLE_SAW_LINEAR,
 	WAVETABLE_SAW_LINEAR_BL,
+	WAVETABLE_SINE_HERMITE,
+	WAVETABLE_SAW_HERMITE_BL,
+	WAVETABLE_SINE_OPTIMAL,
+	WAVETABLE_SAW_OPTIMAL_BL,
 
 	PROCEDURAL_SINE,
 	PROCEDURAL_SAW,
+	PROCEDURAL_SAW_BLEP,
+	PROCEDURAL_SQUARE_BLEP,
+	PROCEDURAL_PULSE_BLEP,
+	PROCEDURAL_TRIANGLE_BLEP,
 
 	LFO_PROCEDURAL_SINE,
 	LFO_PROCEDURAL_SAW_DOWN,
@@ -49,13 +57,14 @@ typedef enum
 	LFO_PROCEDURAL_HALFTRIANGLE,
 
 	WAVE_FIRST_AUDIBLE =	WAVETABLE_SINE,
-	WAVE_LAST_AUDIBLE = 	PROCEDURAL_SAW,
+	WAVE_LAST_AUDIBLE = 	PROCEDURAL_TRIANGLE_BLEP,
 	WAVE_FIRST_LFO = 		LFO_PROCEDURAL_SINE,
 	WAVE_LAST_LFO =			LFO_PROCEDURAL_HALFTRIANGLE,
 
 	WAVE_COUNT
 } waveform_type_t;
 
-extern void waveform_initialise();
+// Builds the wavetables, or maps them from cache_file when it holds a valid copy (NULL disables caching).
+extern void waveform_initialise(const char* wavetable_cache_file);
 
 #endif /* WAVEFORM_H_ */
@@ -25,9 +25,14 @@
 #define WAVEFORM_INTERNAL_H_
 
 #include <sys/types.h>
+#include "filter.h"
+#include "mixer.h"
+#include "dsp_kernel_internal.h"
 
 #define GENFLAG_NONE				0x00000000
 #define GENFLAG_LINEAR_INTERP		0x00000001
+#define GENFLAG_HERMITE_INTERP		0x00000002
+#define GENFLAG_POLY_INTERP			0x00000004
 
 typedef struct
 {
@@ -38,12 +43,31 @@ typedef struct
 typedef struct oscillator_t oscillator_t;
 typedef void (*generator_output_func_t)(waveform_generator_def_t *generator_def, oscillator_t* osc, sample_t *sample_data, int sample_count);
 
+// Where a voice generator sends its samples.
+typedef struct voice_output_t
+{
+	filter_t*	filter;
+	int32_t			left;
+	int32_t			right;
+	bus_sample_t*	bus;
+} voice_output_t;
+
+typedef void (*generator_voice_func_t)(waveform_generator_def_t *generator_def, oscillator_t* osc, voice_output_t* output, int sample_count);
+
+// How a voice generator filters its samples: not at all for a pass filter, with fixed coefficients, or ramping
+// them from an updated filter's last state.
+#define VOICE_FILTER_NONE		0
+#define VOICE_FILTER_APPLY		1
+#define VOICE_FILTER_INTERP		2
+#define VOICE_FILTER_MODES		3
+
 typedef struct
 {
 	waveform_generator_def_t	definition;
 	generator_output_func_t		output_func;
 	generator_output_func_t		mix_func;
 	generator_output_func_t		mid_func;
+	generator_voice_func_t		voice_func[VOICE_FILTER_MODES];
 } waveform_generator_t;
 
 extern waveform_generator_t generators[];
@@ -66,4 +90,247 @@ extern waveform_generator_t generators[];
 
 #define STORE_SAMPLE(sample, sample_ptr)			*sample_ptr++ = (sample_t)sample;
 
+// Scales a FIXED_PRECISION frequency in Hz to a phase step, for phases that run over 32 bits for a cycle,
+// as a 32-bit multiply rather than a divide.
+#define GENERATOR_PHASE_STEP_SCALE					((u_int32_t)((1ULL << (64 - FIXED_PRECISION)) / SYSTEM_SAMPLE_RATE))
+
+static inline u_int32_t generator_phase_step(fixed_t frequency)
+{
+	return ((u_int64_t)frequency * GENERATOR_PHASE_STEP_SCALE) >> 32;
+}
+
+//-----------------------------------------------------------------------------------------------------------------------
+// Fused voice output
+//
+// Voice generators take each sample through the voice filter and pan, onto the stereo mix bus, in the same loop
+// that generates it. The results match osc_output, filter_apply and the C bus mixer kernel bit for bit.
+// The filter mode is a compile time argument, like the generator target, so each mode has a loop of its own.
+//
+
+// Held in locals across the generator loop, so the compiler can keep it all in registers.
+typedef struct voice_output_state_t
+{
+	int32_t			left;
+	int32_t			right;
+	bus_sample_t*	bus_ptr;
+	sample_t		last_sample;
+
+	fixed_t		input_coeff0, input_coeff1, input_coeff2, output_coeff0, output_coeff1;
+	fixed_t		input_step0, input_step1, input_step2, output_step0, output_step1;
+	fixed_t		history0, history1, output0, output1;
+} voice_output_state_t;
+
+static __attribute__((always_inline)) inline void voice_output_begin(voice_output_state_t* state, voice_output_t* output, int sample_count)
+{
+	filter_t* filter = output->filter;
+	filter_state_t* current = &filter->state;
+	filter_state_t* last = filter->updated ? &filter->last_state : current;
+
+	state->left = output->left;
+	state->right = output->right;
+	state->bus_ptr = output->bus;
+	state->last_sample = 0;
+
+	// An updated filter ramps from the coefficients & history of its last state, as filter_apply_interp does.
+	// Otherwise it ramps from its state to itself, in steps of zero.
+	filter_state_t coeffs, step;
+	dsp_filter_ramp(current, last, sample_count, &coeffs, &step);
+
+	state->input_coeff0 = coeffs.input_coeff[0];
+	state->input_coeff1 = coeffs.input_coeff[1];
+	state->input_coeff2 = coeffs.input_coeff[2];
+	state->output_coeff0 = coeffs.output_coeff[0];
+	state->output_coeff1 = coeffs.output_coeff[1];
+	state->input_step0 = step.input_coeff[0];
+	state->input_step1 = step.input_coeff[1];
+	state->input_step2 = step.input_coeff[2];
+	state->output_step0 = step.output_coeff[0];
+	state->output_step1 = step.output_coeff[1];
+
+	state->history0 = last->history[0];
+	state->history1 = last->history[1];
+	state->output0 = last->output[0];
+	state->output1 = last->output[1];
+}
+
+static __attribute__((always_inline)) inline void voice_output_sample(voice_output_state_t* state, int filter_mode, int32_t generated)
+{
+	fixed_t sample = (sample_t)generated;
+	sample_t filtered;
+
+	if (filter_mode != VOICE_FILTER_NONE)
+	{
+		if (filter_mode == VOICE_FILTER_INTERP)
+		{
+			state->input_coeff0 += state->input_step0;
+			state->input_coeff1 += state->input_step1;
+			state->input_coeff2 += state->input_step2;
+			state->output_coeff0 += state->output_step0;
+			state->output_coeff1 += state->output_step1;
+		}
+
+		fixed_t output = dsp_filter_sample(state->input_coeff0, state->input_coeff1, state->input_coeff2, state->output_coeff0, state->output_coeff1,
+											sample, state->history0, state->history1, state->output0, state->output1);
+		filtered = (sample_t)output;
+
+		state->output1 = state->output0;
+		state->output0 = output;
+		state->history1 = state->history0;
+		state->history0 = sample;
+	}
+	else
+	{
+		filtered = (sample_t)sample;
+		state->last_sample = filtered;
+	}
+
+	state->bus_ptr[0] += (filtered * state->left) >> DSP_BUS_PAN_SHIFT;
+	state->bus_ptr[1] += (filtered * state->right) >> DSP_BUS_PAN_SHIFT;
+	state->bus_ptr += 2;
+}
+
+// Stores the filter state back as filter_apply would.
+static __attribute__((always_inline)) inline void voice_output_end(voice_output_state_t* state, int filter_mode, voice_output_t* output)
+{
+	filter_t* filter = output->filter;
+
+	if (filter_mode == VOICE_FILTER_NONE)
+	{
+		filter->state.history[1] = filter->state.history[0];
+		filter->state.history[0] = state->last_sample;
+		filter->state.output[1] = filter->state.output[0];
+		filter->state.output[0] = state->last_sample;
+		return;
+	}
+
+	filter->state.history[0] = state->history0;
+	filter->state.history[1] = state->history1;
+	filter->state.output[0] = state->output0;
+	filter->state.output[1] = state->output1;
+
+	filter->updated = 0;
+}
+
+//-----------------------------------------------------------------------------------------------------------------------
+// Generator template
+//
+// DEFINE_GENERATORS builds the output, mix and voice generators of a waveform from one loop, specialised at compile
+// time for each target and voice filter mode, so the per-sample loop has no tests of flags or targets in it. The waveform supplies
+// inline functions over a state type of its own:
+//
+//	int		begin(state_type *state, waveform_generator_def_t *generator, oscillator_t *osc)
+//				sets up the state, returning FALSE if there is nothing to generate
+//	int		block(state_type *state, int sample_count)
+//				prepares the next block of samples, returning how many of sample_count it covers
+//	int32_t	next_sample(state_type *state)
+//				returns the next sample at full level, and advances the phase
+//	void	end(state_type *state, oscillator_t *osc)
+//				stores the phase back in the oscillator
+//
+// Waveforms that calculate each sample as it's needed use generator_block_all. Those that render a block at a
+// time, such as through a DSP kernel, return at most the size of their block buffer.
+//
+
+typedef enum
+{
+	GENERATOR_STORE,
+	GENERATOR_MIX,
+	GENERATOR_VOICE
+} generator_target_t;
+
+static __attribute__((always_inline)) inline int generator_block_all(void *state, int sample_count)
+{
+	return sample_count;
+}
+
+static __attribute__((always_inline)) inline void generator_emit(generator_target_t target, int filter_mode, int32_t sample, sample_t **sample_ptr, voice_output_state_t *output_state)
+{
+	if (target == GENERATOR_STORE)
+	{
+		STORE_SAMPLE(sample, (*sample_ptr));
+	}
+	else if (target == GENERATOR_MIX)
+	{
+		MIX((int32_t)**sample_ptr, sample, mixed);
+		STORE_SAMPLE(mixed, (*sample_ptr));
+	}
+	else
+	{
+		voice_output_sample(output_state, filter_mode, sample);
+	}
+}
+
+#define DEFINE_GENERATORS(name, state_type, begin, block, next_sample, end)											\
+static __attribute__((always_inline)) inline void name##_generate(waveform_generator_def_t *generator, oscillator_t* osc, sample_t *sample_data, voice_output_t* output, int sample_count, generator_target_t target, int filter_mode)	\
+{																												\
+	state_type state;																							\
+	if (!begin(&state, generator, osc))																			\
+	{																											\
+		return;																									\
+	}																											\
+																												\
+	sample_t *sample_ptr = sample_data;																			\
+	voice_output_state_t output_state;																			\
+	if (target == GENERATOR_VOICE)																				\
+	{																											\
+		voice_output_begin(&output_state, output, sample_count);												\
+	}																											\
+	CALC_AMPLITUDE_INTERPOLATION(osc, amp_scale, amp_delta, sample_count);										\
+																												\
+	while (sample_count > 0)																					\
+	{																											\
+		int block_count = block(&state, sample_count);															\
+		sample_count -= block_count;																			\
+																												\
+		for (; block_count > 0; block_count--)																	\
+		{																										\
+			int32_t sample = next_sample(&state);																\
+			SCALE_AMPLITUDE((amp_scale >> AMPL_INTERP_PRECISION), sample);										\
+			generator_emit(target, filter_mode, sample, &sample_ptr, &output_state);								\
+			INTERPOLATE_AMPLITUDE(amp_scale, amp_delta);														\
+		}																										\
+	}																											\
+																												\
+	end(&state, osc);																							\
+	if (target == GENERATOR_VOICE)																				\
+	{																											\
+		voice_output_end(&output_state, filter_mode, output);													\
+	}																											\
+}																												\
+																												\
+static void name##_output(waveform_generator_def_t *generator, oscillator_t* osc, sample_t *sample_data, int sample_count)	\
+{																												\
+	name##_generate(generator, osc, sample_data, NULL, sample_count, GENERATOR_STORE, VOICE_FILTER_NONE);		\
+}																												\
+																												\
+static void name##_mix_output(waveform_generator_def_t *generator, oscillator_t* osc, sample_t *sample_data, int sample_count)	\
+{																												\
+	name##_generate(generator, osc, sample_data, NULL, sample_count, GENERATOR_MIX, VOICE_FILTER_NONE);		\
+}																												\
+																												\
+static void name##_voice_output_none(waveform_generator_def_t *generator, oscillator_t* osc, voice_output_t* output, int sample_count)	\
+{																												\
+	name##_generate(generator, osc, NULL, output, sample_count, GENERATOR_VOICE, VOICE_FILTER_NONE);			\
+}																												\
+																												\
+static void name##_voice_output_apply(waveform_generator_def_t *generator, oscillator_t* osc, voice_output_t* output, int sample_count)	\
+{																												\
+	name##_generate(generator, osc, NULL, output, sample_count, GENERATOR_VOICE, VOICE_FILTER_APPLY);			\
+}																												\
+																												\
+static void name##_voice_output_interp(waveform_generator_def_t *generator, oscillator_t* osc, voice_output_t* output, int sample_count)	\
+{																												\
+	name##_generate(generator, osc, NULL, output, sample_count, GENERATOR_VOICE, VOICE_FILTER_INTERP);			\
+}
+
+#define SET_GENERATORS(generator, name)				(generator)->output_func = name##_output;					\
+													(generator)->mix_func = name##_mix_output;					\
+													(generator)->voice_func[VOICE_FILTER_NONE] = name##_voice_output_none;		\
+													(generator)->voice_func[VOICE_FILTER_APPLY] = name##_voice_output_apply;	\
+													(generator)->voice_func[VOICE_FILTER_INTERP] = name##_voice_output_interp
+
+#define CLEAR_VOICE_GENERATORS(generator)			(generator)->voice_func[VOICE_FILTER_NONE] = NULL;			\
+													(generator)->voice_func[VOICE_FILTER_APPLY] = NULL;			\
+													(generator)->voice_func[VOICE_FILTER_INTERP] = NULL
+
 #endif /* WAVEFORM_INTERNAL_H_ */
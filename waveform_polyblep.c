@@ -0,0 +1,205 @@
+// Pithesiser - a software synthesiser for Raspberry Pi
+// Copyright (C) 2015 Nicholas Tuckett
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * waveform_polyblep.c
+ *
+ *  Created on: 16 Oct 2026
+ *      Author: ntuckett
+ */
+
+#include <stdlib.h>
+#include "waveform_polyblep.h"
+#include "system_constants.h"
+#include "fixed_point_math.h"
+#include "oscillator.h"
+
+#define PB_PHASE_HALF				0x80000000U
+#define PB_PHASE_QUARTER			0x40000000U
+
+// Corrections are calculated with the distance from an edge, in samples, at this precision.
+#define PB_PRECISION				15
+#define PB_ONE						(1 << PB_PRECISION)
+
+typedef struct
+{
+	u_int32_t	phase_step;
+	u_int64_t	edge_scale;		// phase distance to samples at PB_PRECISION, as a multiply
+	u_int32_t	ramp_scale;		// corner corrections to sample values, as a multiply
+	u_int32_t	pulse_width;
+} polyblep_params_t;
+
+static inline void polyblep_params_init(polyblep_params_t *params, oscillator_t *osc)
+{
+	params->phase_step = generator_phase_step(osc->frequency);
+	if (params->phase_step == 0)
+	{
+		params->phase_step = 1;
+	}
+
+	params->edge_scale = (1ULL << (32 + PB_PRECISION)) / params->phase_step;
+
+	// A triangle's slope changes by 8 per cycle at each corner: the ramp correction is half that, times the phase step.
+	params->ramp_scale = ((u_int64_t)params->phase_step * 4) / 3;
+	params->pulse_width = (u_int32_t)osc->pulse_width << (32 - FIXED_PRECISION);
+}
+
+// Whether phase is within a sample of phase 0, either side, in one comparison; most samples are not.
+#define PB_NEAR_EDGE(phase, params)		((u_int32_t)((phase) + (params)->phase_step) < (params)->phase_step * 2)
+
+// The correction for a unit step up at phase 0, or 0 beyond a sample either side of it.
+// With x the distance from the step in samples, it is (1-x)^2 before the step and -(1-x)^2 after it.
+static __attribute__((always_inline)) inline int32_t poly_blep(u_int32_t phase, const polyblep_params_t *params)
+{
+	if (!PB_NEAR_EDGE(phase, params))
+	{
+		return 0;
+	}
+
+	if (phase < params->phase_step)
+	{
+		int32_t r = PB_ONE - (int32_t)((phase * params->edge_scale) >> 32);
+		return -((r * r) >> PB_PRECISION);
+	}
+
+	phase = -phase;
+	int32_t r = PB_ONE - (int32_t)((phase * params->edge_scale) >> 32);
+	return (r * r) >> PB_PRECISION;
+}
+
+// The integral of poly_blep, for a unit change of slope at phase 0: (1-x)^3 / 3 either side, before scaling.
+static __attribute__((always_inline)) inline int32_t poly_blamp(u_int32_t phase, const polyblep_params_t *params)
+{
+	if (!PB_NEAR_EDGE(phase, params))
+	{
+		return 0;
+	}
+
+	if (phase >= params->phase_step)
+	{
+		phase = -phase;
+	}
+
+	int32_t r = PB_ONE - (int32_t)((phase * params->edge_scale) >> 32);
+	int32_t r2 = (r * r) >> PB_PRECISION;
+	return (int32_t)(((int64_t)((r2 * r) >> PB_PRECISION) * params->ramp_scale) >> 32);
+}
+
+// Falling from +1 to -1 over the cycle, as PROCEDURAL_SAW.
+static __attribute__((always_inline)) inline int32_t polyblep_saw(u_int32_t phase, const polyblep_params_t *params)
+{
+	int32_t sample = SAMPLE_MAX - (int32_t)(phase >> 16);
+	return sample + poly_blep(phase, params);
+}
+
+static __attribute__((always_inline)) inline int32_t polyblep_square(u_int32_t phase, const polyblep_params_t *params)
+{
+	int32_t sample = phase < PB_PHASE_HALF ? SAMPLE_MAX : -SAMPLE_MAX;
+	return sample + poly_blep(phase, params) - poly_blep(phase - PB_PHASE_HALF, params);
+}
+
+// High for pulse_width of the cycle. Edges close together can overshoot, so the result is clamped.
+static __attribute__((always_inline)) inline int32_t polyblep_pulse(u_int32_t phase, const polyblep_params_t *params)
+{
+	int32_t sample = phase < params->pulse_width ? SAMPLE_MAX : -SAMPLE_MAX;
+	sample += poly_blep(phase, params) - poly_blep(phase - params->pulse_width, params);
+
+	if (sample > SAMPLE_MAX)
+	{
+		sample = SAMPLE_MAX;
+	}
+	else if (sample < -SAMPLE_MAX)
+	{
+		sample = -SAMPLE_MAX;
+	}
+
+	return sample;
+}
+
+// Rising from 0 to +1 at a quarter cycle, and down to -1 at three quarters, as LFO_PROCEDURAL_TRIANGLE.
+static __attribute__((always_inline)) inline int32_t polyblep_triangle(u_int32_t phase, const polyblep_params_t *params)
+{
+	int32_t offset = (int32_t)(phase + PB_PHASE_QUARTER - PB_PHASE_HALF);
+	u_int32_t distance = offset < 0 ? -(u_int32_t)offset : (u_int32_t)offset;
+	int32_t sample = (((int64_t)PB_PHASE_QUARTER - distance) * SAMPLE_MAX) >> 30;
+	return sample - poly_blamp(phase - PB_PHASE_QUARTER, params) + poly_blamp(phase - PB_PHASE_HALF - PB_PHASE_QUARTER, params);
+}
+
+typedef struct
+{
+	polyblep_params_t	params;
+	u_int32_t			phase;
+} polyblep_state_t;
+
+static __attribute__((always_inline)) inline int polyblep_begin(polyblep_state_t *state, waveform_generator_def_t *generator, oscillator_t *osc)
+{
+	polyblep_params_init(&state->params, osc);
+	state->phase = (u_int32_t)osc->phase_accumulator;
+	return TRUE;
+}
+
+static __attribute__((always_inline)) inline void polyblep_end(polyblep_state_t *state, oscillator_t *osc)
+{
+	osc->phase_accumulator = (fixed_t)state->phase;
+}
+
+// Output, mix and voice generators for a waveform from its sample function.
+#define DEFINE_POLYBLEP_GENERATORS(name)																		\
+static __attribute__((always_inline)) inline int32_t polyblep_##name##_next(polyblep_state_t *state)			\
+{																												\
+	int32_t sample = polyblep_##name(state->phase, &state->params);												\
+	state->phase += state->params.phase_step;																	\
+	return sample;																								\
+}																												\
+																												\
+DEFINE_GENERATORS(polyblep_##name, polyblep_state_t, polyblep_begin, generator_block_all, polyblep_##name##_next, polyblep_end)
+
+DEFINE_POLYBLEP_GENERATORS(saw)
+DEFINE_POLYBLEP_GENERATORS(square)
+DEFINE_POLYBLEP_GENERATORS(pulse)
+DEFINE_POLYBLEP_GENERATORS(triangle)
+
+void init_polyblep_generator(waveform_type_t waveform_type, waveform_generator_t *generator)
+{
+	generator->definition.flags = GENFLAG_NONE;
+	generator->definition.waveform_data = NULL;
+	generator->mid_func = NULL;
+
+	switch (waveform_type)
+	{
+		case PROCEDURAL_SAW_BLEP:
+			SET_GENERATORS(generator, polyblep_saw);
+			break;
+
+		case PROCEDURAL_SQUARE_BLEP:
+			SET_GENERATORS(generator, polyblep_square);
+			break;
+
+		case PROCEDURAL_PULSE_BLEP:
+			SET_GENERATORS(generator, polyblep_pulse);
+			break;
+
+		case PROCEDURAL_TRIANGLE_BLEP:
+			SET_GENERATORS(generator, polyblep_triangle);
+			break;
+
+		default:
+			generator->output_func = NULL;
+			generator->mix_func = NULL;
+			CLEAR_VOICE_GENERATORS(generator);
+			break;
+	}
+}
@@ -15,15 +15,25 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 /*
- * mixer_timing_test.h
+ * waveform_polyblep.h
  *
- *  Created on: 8 Apr 2013
+ *  Created on: 16 Oct 2026
  *      Author: ntuckett
+ *
+ *  Saw, square, variable width pulse and triangle oscillators, generated procedurally with their discontinuities
+ *  smoothed by polynomial band-limited steps (PolyBLEP) and ramps (PolyBLAMP). Each edge of the naive waveform
+ *  is corrected over the sample either side of it, which removes most of the aliasing a naive ramp or step has,
+ *  without any tables.
+ *
+ *  The phase runs over 32 bits for a cycle, wrapping as it overflows, as it does for the wavetables.
  */
 
-#ifndef MIXER_TIMING_TEST_H_
-#define MIXER_TIMING_TEST_H_
+#ifndef WAVEFORM_POLYBLEP_H_
+#define WAVEFORM_POLYBLEP_H_
+
+#include "waveform.h"
+#include "waveform_internal.h"
 
-extern void mixer_timing_test(int count);
+extern void init_polyblep_generator(waveform_type_t waveform_type, waveform_generator_t *generator);
 
-#endif /* MIXER_TIMING_TEST_H_ */
+#endif /* WAVEFORM_POLYBLEP_H_ */
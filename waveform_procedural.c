@@ -31,427 +31,212 @@
 #define PHASE_LIMIT			(4 * FIXED_ONE)
 #define PHASE_HALF_LIMIT	(2 * FIXED_ONE)
 #define PHASE_QUARTER_LIMIT	(FIXED_ONE)
+#define PHASE_MASK			(PHASE_LIMIT - 1)		// the limit is a power of two, so audio loops wrap by masking
 
-#define PR_CALC_PHASE_STEP(osc, phase_step)	fixed_t	phase_step = fixed_mul(PHASE_LIMIT, osc->frequency) / SYSTEM_SAMPLE_RATE
-
-// Formulae (input is phase, t):
-// 	0  to 2: 1 - (1-t)^2
-// 	2> to 4: (1-(t-2))^2 - 1
-#define PR_CALC_SINE_POSITIVE(osc, sample)	sample = FIXED_ONE - osc->phase_accumulator; \
-											sample = fixed_mul(sample, sample); \
-											sample = fixed_mul(FIXED_ONE - sample, SAMPLE_MAX)
-
-#define PR_CALC_SINE_NEGATIVE(osc, sample)	sample = FIXED_ONE - (osc->phase_accumulator - PHASE_HALF_LIMIT); \
-											sample = fixed_mul(sample, sample); \
-											sample = fixed_mul(sample - FIXED_ONE, SAMPLE_MAX)
-
-#define PR_CALC_HALFSINE(osc, sample)		sample = FIXED_ONE - (osc->phase_accumulator >> 1); \
-											sample = fixed_mul(sample, sample); \
-											sample = fixed_mul(FIXED_ONE - sample, SAMPLE_MAX)
-
-#define PR_CALC_SAW_DOWN(osc, sample)		sample = FIXED_ONE - (osc->phase_accumulator >> 1);	\
-											sample = fixed_mul(sample, SAMPLE_MAX);
-
-#define PR_CALC_SAW_UP(osc, sample)			sample = osc->phase_accumulator >> 1;	\
-											sample = fixed_mul(sample, SAMPLE_MAX);
-
-#define PR_CALC_HALFSAW_DOWN(osc, sample)	sample = FIXED_ONE - (osc->phase_accumulator >> 2);	\
-											sample = fixed_mul(sample, SAMPLE_MAX);
-
-#define PR_CALC_HALFSAW_UP(osc, sample)		sample = osc->phase_accumulator >> 2;	\
-											sample = fixed_mul(sample, SAMPLE_MAX);
-
-#define PR_CALC_TRI_DOWN(osc, offs, sample)	sample = FIXED_ONE - (osc->phase_accumulator - offs);	\
-											sample = fixed_mul(sample, SAMPLE_MAX);
-
-#define PR_CALC_TRI_UP(osc, offs, sample)	sample = (osc->phase_accumulator - offs);	\
-											sample = fixed_mul(sample, SAMPLE_MAX);
-
-#define PR_CALC_HALFTRI_DOWN(osc, sample)	sample = FIXED_ONE - ((osc->phase_accumulator - PHASE_HALF_LIMIT) >> 1);	\
-											sample = fixed_mul(sample, SAMPLE_MAX);
-
-#define PR_CALC_HALFTRI_UP(osc, sample)		sample = (osc->phase_accumulator >> 1);	\
-											sample = fixed_mul(sample, SAMPLE_MAX);
+// Widened until after the divide, as the product overflows a fixed_t above 2kHz.
+#define PR_CALC_PHASE_STEP(osc, phase_step)	fixed_t	phase_step = (((fixed_wide_t)PHASE_LIMIT * osc->frequency) >> FIXED_PRECISION) / SYSTEM_SAMPLE_RATE
 
 #define PR_ADVANCE_PHASE(osc, phase_step)	osc->phase_accumulator += phase_step
 
 #define PR_LOOP_PHASE(osc)					if (osc->phase_accumulator >= PHASE_LIMIT) \
 												osc->phase_accumulator -= PHASE_LIMIT
 
-static void procedural_sine_output(waveform_generator_def_t *generator, oscillator_t* osc, sample_t *sample_data, int sample_count)
-{
-	PR_CALC_PHASE_STEP(osc, phase_step);
-	sample_t *sample_ptr = sample_data;
-	CALC_AMPLITUDE_INTERPOLATION(osc, amp_scale, amp_delta, sample_count);
-
-	while (sample_count > 0)
-	{
-		while (osc->phase_accumulator < PHASE_HALF_LIMIT && sample_count > 0)
-		{
-			int32_t PR_CALC_SINE_POSITIVE(osc, sample);
-			SCALE_AMPLITUDE((amp_scale >> AMPL_INTERP_PRECISION), sample);
-			STORE_SAMPLE(sample, sample_ptr);
-			PR_ADVANCE_PHASE(osc, phase_step);
-			INTERPOLATE_AMPLITUDE(amp_scale, amp_delta);
-			sample_count--;
-		}
-
-		while (osc->phase_accumulator < PHASE_LIMIT && sample_count > 0)
-		{
-			int32_t PR_CALC_SINE_NEGATIVE(osc, sample);
-			SCALE_AMPLITUDE((amp_scale >> AMPL_INTERP_PRECISION), sample);
-			STORE_SAMPLE(sample, sample_ptr);
-			PR_ADVANCE_PHASE(osc, phase_step);
-			INTERPOLATE_AMPLITUDE(amp_scale, amp_delta);
-			sample_count--;
-		}
-
-		PR_LOOP_PHASE(osc);
-	}
-}
-
-static void procedural_sine_mid_output(waveform_generator_def_t * generator, oscillator_t* osc, sample_t *sample_data, int sample_count)
-{
-	PR_CALC_PHASE_STEP(osc, phase_step);
-	sample_t *sample_ptr = sample_data;
-
-	phase_step *= sample_count / 2;	// step to midpoint
-	PR_ADVANCE_PHASE(osc, phase_step);
-	PR_LOOP_PHASE(osc);
-
-	int32_t sample;
+//-----------------------------------------------------------------------------------------------------------------------
+// Shapes, as a sample at full level from the phase (0 to PHASE_LIMIT)
+//
 
-	if (osc->phase_accumulator < PHASE_HALF_LIMIT)
-	{
-		PR_CALC_SINE_POSITIVE(osc, sample);
-	}
-	else
-	{
-		PR_CALC_SINE_NEGATIVE(osc, sample);
-	}
-
-	SCALE_AMPLITUDE(osc->level, sample)
-	*sample_ptr = sample;
-
-	PR_ADVANCE_PHASE(osc, phase_step);
-	PR_LOOP_PHASE(osc);
-}
-
-static void procedural_halfsine_mid_output(waveform_generator_def_t * generator, oscillator_t* osc, sample_t *sample_data, int sample_count)
+// Formulae (input is phase, t):
+// 	0  to 2: 1 - (1-t)^2
+// 	2> to 4: (1-(t-2))^2 - 1
+// Written as one formula with the half selected, so audio loops don't branch on it.
+static inline int32_t procedural_sine(fixed_t phase)
 {
-	PR_CALC_PHASE_STEP(osc, phase_step);
-	sample_t *sample_ptr = sample_data;
-
-	phase_step *= sample_count / 2;	// step to midpoint
-	PR_ADVANCE_PHASE(osc, phase_step);
-	PR_LOOP_PHASE(osc);
-
-	int32_t sample;
-
-	PR_CALC_HALFSINE(osc, sample);
-
-	SCALE_AMPLITUDE(osc->level, sample)
-	*sample_ptr = sample;
-
-	PR_ADVANCE_PHASE(osc, phase_step);
-	PR_LOOP_PHASE(osc);
+	int negative = phase >= PHASE_HALF_LIMIT;
+	fixed_t sample = FIXED_ONE - (phase - (negative ? PHASE_HALF_LIMIT : 0));
+	sample = FIXED_ONE - fixed_mul(sample, sample);
+	return fixed_mul(negative ? -sample : sample, SAMPLE_MAX);
 }
 
-static void procedural_sine_mix_output(waveform_generator_def_t *generator, oscillator_t* osc, sample_t *sample_data, int sample_count)
+static inline int32_t procedural_halfsine(fixed_t phase)
 {
-	PR_CALC_PHASE_STEP(osc, phase_step);
-	sample_t *sample_ptr = sample_data;
-	CALC_AMPLITUDE_INTERPOLATION(osc, amp_scale, amp_delta, sample_count);
-
-	while (sample_count > 0)
-	{
-		while (osc->phase_accumulator < PHASE_HALF_LIMIT && sample_count > 0)
-		{
-			int32_t PR_CALC_SINE_POSITIVE(osc, sample);
-			SCALE_AMPLITUDE((amp_scale >> AMPL_INTERP_PRECISION), sample);
-			MIX((int32_t)*sample_ptr, sample, mixed);
-			STORE_SAMPLE(mixed, sample_ptr);
-			PR_ADVANCE_PHASE(osc, phase_step);
-			INTERPOLATE_AMPLITUDE(amp_scale, amp_delta);
-			sample_count--;
-		}
-
-		while (osc->phase_accumulator < PHASE_LIMIT && sample_count > 0)
-		{
-			int32_t PR_CALC_SINE_NEGATIVE(osc, sample);
-			SCALE_AMPLITUDE((amp_scale >> AMPL_INTERP_PRECISION), sample);
-			MIX((int32_t)*sample_ptr, sample, mixed);
-			STORE_SAMPLE(mixed, sample_ptr);
-			PR_ADVANCE_PHASE(osc, phase_step);
-			INTERPOLATE_AMPLITUDE(amp_scale, amp_delta);
-			sample_count--;
-		}
-
-		PR_LOOP_PHASE(osc);
-	}
+	fixed_t sample = FIXED_ONE - (phase >> 1);
+	sample = fixed_mul(sample, sample);
+	return fixed_mul(FIXED_ONE - sample, SAMPLE_MAX);
 }
 
-static void procedural_saw_output(waveform_generator_def_t *generator, oscillator_t* osc, sample_t *sample_data, int sample_count)
+static inline int32_t procedural_saw_down(fixed_t phase)
 {
-	PR_CALC_PHASE_STEP(osc, phase_step);
-	sample_t *sample_ptr = sample_data;
-	CALC_AMPLITUDE_INTERPOLATION(osc, amp_scale, amp_delta, sample_count);
-
-	while (sample_count > 0)
-	{
-		int32_t PR_CALC_SAW_DOWN(osc, sample);
-		SCALE_AMPLITUDE((amp_scale >> AMPL_INTERP_PRECISION), sample);
-		STORE_SAMPLE(sample, sample_ptr);
-		PR_ADVANCE_PHASE(osc, phase_step);
-		INTERPOLATE_AMPLITUDE(amp_scale, amp_delta);
-		sample_count--;
-
-		PR_LOOP_PHASE(osc);
-	}
+	return fixed_mul(FIXED_ONE - (phase >> 1), SAMPLE_MAX);
 }
 
-static void procedural_saw_mid_output(waveform_generator_def_t * generator, oscillator_t* osc, sample_t *sample_data, int sample_count)
+static inline int32_t procedural_saw_up(fixed_t phase)
 {
-	PR_CALC_PHASE_STEP(osc, phase_step);
-	sample_t *sample_ptr = sample_data;
-
-	phase_step *= sample_count / 2;	// step to midpoint
-	PR_ADVANCE_PHASE(osc, phase_step);
-	PR_LOOP_PHASE(osc);
-
-	int32_t PR_CALC_SAW_DOWN(osc, sample);
-
-	SCALE_AMPLITUDE(osc->level, sample)
-	*sample_ptr = sample;
-
-	PR_ADVANCE_PHASE(osc, phase_step);
-	PR_LOOP_PHASE(osc);
+	return fixed_mul(phase >> 1, SAMPLE_MAX);
 }
 
-static void procedural_sawup_mid_output(waveform_generator_def_t * generator, oscillator_t* osc, sample_t *sample_data, int sample_count)
+static inline int32_t procedural_halfsaw_down(fixed_t phase)
 {
-	PR_CALC_PHASE_STEP(osc, phase_step);
-	sample_t *sample_ptr = sample_data;
-
-	phase_step *= sample_count / 2;	// step to midpoint
-	PR_ADVANCE_PHASE(osc, phase_step);
-	PR_LOOP_PHASE(osc);
-
-	int32_t PR_CALC_SAW_UP(osc, sample);
-
-	SCALE_AMPLITUDE(osc->level, sample)
-	*sample_ptr = sample;
-
-	PR_ADVANCE_PHASE(osc, phase_step);
-	PR_LOOP_PHASE(osc);
+	return fixed_mul(FIXED_ONE - (phase >> 2), SAMPLE_MAX);
 }
 
-static void procedural_saw_mix_output(waveform_generator_def_t *generator, oscillator_t* osc, sample_t *sample_data, int sample_count)
+static inline int32_t procedural_halfsaw_up(fixed_t phase)
 {
-	PR_CALC_PHASE_STEP(osc, phase_step);
-	sample_t *sample_ptr = sample_data;
-	CALC_AMPLITUDE_INTERPOLATION(osc, amp_scale, amp_delta, sample_count);
-
-	while (sample_count > 0)
-	{
-		int32_t PR_CALC_SAW_DOWN(osc, sample);
-		SCALE_AMPLITUDE((amp_scale >> AMPL_INTERP_PRECISION), sample);
-		MIX((int32_t)*sample_ptr, sample, mixed);
-		STORE_SAMPLE(mixed, sample_ptr);
-		PR_ADVANCE_PHASE(osc, phase_step);
-		INTERPOLATE_AMPLITUDE(amp_scale, amp_delta);
-		sample_count--;
-
-		PR_LOOP_PHASE(osc);
-	}
+	return fixed_mul(phase >> 2, SAMPLE_MAX);
 }
 
-static void procedural_triangle_mid_output(waveform_generator_def_t * generator, oscillator_t* osc, sample_t *sample_data, int sample_count)
+static inline int32_t procedural_triangle(fixed_t phase)
 {
-	PR_CALC_PHASE_STEP(osc, phase_step);
-	sample_t *sample_ptr = sample_data;
-
-	phase_step *= sample_count / 2;	// step to midpoint
-	PR_ADVANCE_PHASE(osc, phase_step);
-	PR_LOOP_PHASE(osc);
-
-	int32_t sample;
-
-	if (osc->phase_accumulator < PHASE_QUARTER_LIMIT)
-	{
-		PR_CALC_TRI_UP(osc, 0, sample);
-	}
-	else if (osc->phase_accumulator < PHASE_HALF_LIMIT)
+	if (phase < PHASE_QUARTER_LIMIT)
 	{
-		PR_CALC_TRI_DOWN(osc, PHASE_QUARTER_LIMIT, sample);
+		return fixed_mul(phase, SAMPLE_MAX);
 	}
-	else if (osc->phase_accumulator < PHASE_HALF_LIMIT + PHASE_QUARTER_LIMIT)
+	else if (phase < PHASE_HALF_LIMIT)
 	{
-		PR_CALC_TRI_UP(osc, PHASE_HALF_LIMIT, sample);
-		sample = -sample;
+		return fixed_mul(FIXED_ONE - (phase - PHASE_QUARTER_LIMIT), SAMPLE_MAX);
 	}
-	else
+	else if (phase < PHASE_HALF_LIMIT + PHASE_QUARTER_LIMIT)
 	{
-		PR_CALC_TRI_DOWN(osc, (PHASE_HALF_LIMIT + PHASE_QUARTER_LIMIT), sample);
-		sample = -sample;
+		return -fixed_mul(phase - PHASE_HALF_LIMIT, SAMPLE_MAX);
 	}
 
-	SCALE_AMPLITUDE(osc->level, sample)
-	*sample_ptr = sample;
-
-	PR_ADVANCE_PHASE(osc, phase_step);
-	PR_LOOP_PHASE(osc);
+	return -fixed_mul(FIXED_ONE - (phase - (PHASE_HALF_LIMIT + PHASE_QUARTER_LIMIT)), SAMPLE_MAX);
 }
 
-static void procedural_square_mid_output(waveform_generator_def_t * generator, oscillator_t* osc, sample_t *sample_data, int sample_count)
+static inline int32_t procedural_square(fixed_t phase)
 {
-	PR_CALC_PHASE_STEP(osc, phase_step);
-	sample_t *sample_ptr = sample_data;
-
-	phase_step *= sample_count / 2;	// step to midpoint
-	PR_ADVANCE_PHASE(osc, phase_step);
-	PR_LOOP_PHASE(osc);
-
-	int32_t sample = (((osc->phase_accumulator - PHASE_HALF_LIMIT) >> (sizeof(osc->phase_accumulator) * 8 - 1)) | 1) * SAMPLE_MAX;
+	return (((phase - PHASE_HALF_LIMIT) >> (sizeof(phase) * 8 - 1)) | 1) * SAMPLE_MAX;
+}
 
-	SCALE_AMPLITUDE(osc->level, sample)
-	*sample_ptr = sample;
+static inline int32_t procedural_halftriangle(fixed_t phase)
+{
+	if (phase < PHASE_HALF_LIMIT)
+	{
+		return fixed_mul(phase >> 1, SAMPLE_MAX);
+	}
 
-	PR_ADVANCE_PHASE(osc, phase_step);
-	PR_LOOP_PHASE(osc);
+	return fixed_mul(FIXED_ONE - ((phase - PHASE_HALF_LIMIT) >> 1), SAMPLE_MAX);
 }
 
+//-----------------------------------------------------------------------------------------------------------------------
+// Audio generators
+//
+typedef struct
+{
+	fixed_t		phase;
+	fixed_t		phase_step;
+} procedural_state_t;
 
-static void procedural_halfsawdown_mid_output(waveform_generator_def_t * generator, oscillator_t* osc, sample_t *sample_data, int sample_count)
+static __attribute__((always_inline)) inline int procedural_begin(procedural_state_t *state, waveform_generator_def_t *generator, oscillator_t *osc)
 {
 	PR_CALC_PHASE_STEP(osc, phase_step);
-	sample_t *sample_ptr = sample_data;
-
-	phase_step *= sample_count / 2;	// step to midpoint
-	PR_ADVANCE_PHASE(osc, phase_step);
-	PR_LOOP_PHASE(osc);
-
-	int32_t PR_CALC_HALFSAW_DOWN(osc, sample);
-
-	SCALE_AMPLITUDE(osc->level, sample)
-	*sample_ptr = sample;
-
-	PR_ADVANCE_PHASE(osc, phase_step);
-	PR_LOOP_PHASE(osc);
+	state->phase = osc->phase_accumulator & PHASE_MASK;
+	state->phase_step = phase_step;
+	return TRUE;
 }
 
-static void procedural_halfsawup_mid_output(waveform_generator_def_t * generator, oscillator_t* osc, sample_t *sample_data, int sample_count)
+static __attribute__((always_inline)) inline void procedural_advance(procedural_state_t *state)
 {
-	PR_CALC_PHASE_STEP(osc, phase_step);
-	sample_t *sample_ptr = sample_data;
-
-	phase_step *= sample_count / 2;	// step to midpoint
-	PR_ADVANCE_PHASE(osc, phase_step);
-	PR_LOOP_PHASE(osc);
-
-	int32_t PR_CALC_HALFSAW_UP(osc, sample);
-
-	SCALE_AMPLITUDE(osc->level, sample)
-	*sample_ptr = sample;
-
-	PR_ADVANCE_PHASE(osc, phase_step);
-	PR_LOOP_PHASE(osc);
+	state->phase = (state->phase + state->phase_step) & PHASE_MASK;
 }
 
-static void procedural_halftriangle_mid_output(waveform_generator_def_t * generator, oscillator_t* osc, sample_t *sample_data, int sample_count)
+static __attribute__((always_inline)) inline void procedural_end(procedural_state_t *state, oscillator_t *osc)
 {
-	PR_CALC_PHASE_STEP(osc, phase_step);
-	sample_t *sample_ptr = sample_data;
-
-	phase_step *= sample_count / 2;	// step to midpoint
-	PR_ADVANCE_PHASE(osc, phase_step);
-	PR_LOOP_PHASE(osc);
-
-	int32_t sample;
-
-	if (osc->phase_accumulator < PHASE_HALF_LIMIT)
-	{
-		PR_CALC_HALFTRI_UP(osc, sample);
-	}
-	else
-	{
-		PR_CALC_HALFTRI_DOWN(osc, sample);
-	}
-
-	SCALE_AMPLITUDE(osc->level, sample)
-	*sample_ptr = sample;
+	osc->phase_accumulator = state->phase;
+}
 
-	PR_ADVANCE_PHASE(osc, phase_step);
-	PR_LOOP_PHASE(osc);
+#define DEFINE_PROCEDURAL_GENERATORS(shape)																		\
+static __attribute__((always_inline)) inline int32_t procedural_##shape##_next(procedural_state_t *state)		\
+{																												\
+	int32_t sample = procedural_##shape(state->phase);															\
+	procedural_advance(state);																					\
+	return sample;																								\
+}																												\
+																												\
+DEFINE_GENERATORS(procedural_##shape, procedural_state_t, procedural_begin, generator_block_all, procedural_##shape##_next, procedural_end)
+
+DEFINE_PROCEDURAL_GENERATORS(sine)
+DEFINE_PROCEDURAL_GENERATORS(saw_down)
+
+//-----------------------------------------------------------------------------------------------------------------------
+// LFO generators, outputting a single sample from the middle of the period
+//
+#define DEFINE_PROCEDURAL_MID_GENERATOR(shape)																	\
+static void procedural_##shape##_mid_output(waveform_generator_def_t * generator, oscillator_t* osc, sample_t *sample_data, int sample_count)	\
+{																												\
+	PR_CALC_PHASE_STEP(osc, phase_step);																		\
+																												\
+	phase_step *= sample_count / 2;		/* step to midpoint */													\
+	PR_ADVANCE_PHASE(osc, phase_step);																			\
+	PR_LOOP_PHASE(osc);																							\
+																												\
+	int32_t sample = procedural_##shape(osc->phase_accumulator);												\
+	SCALE_AMPLITUDE(osc->level, sample)																			\
+	*sample_data = sample;																						\
+																												\
+	PR_ADVANCE_PHASE(osc, phase_step);																			\
+	PR_LOOP_PHASE(osc);																							\
 }
 
+DEFINE_PROCEDURAL_MID_GENERATOR(sine)
+DEFINE_PROCEDURAL_MID_GENERATOR(saw_down)
+DEFINE_PROCEDURAL_MID_GENERATOR(saw_up)
+DEFINE_PROCEDURAL_MID_GENERATOR(triangle)
+DEFINE_PROCEDURAL_MID_GENERATOR(square)
+DEFINE_PROCEDURAL_MID_GENERATOR(halfsaw_down)
+DEFINE_PROCEDURAL_MID_GENERATOR(halfsaw_up)
+DEFINE_PROCEDURAL_MID_GENERATOR(halfsine)
+DEFINE_PROCEDURAL_MID_GENERATOR(halftriangle)
+
 void init_procedural_generator(waveform_type_t waveform_type, waveform_generator_t *generator)
 {
+	generator->output_func = NULL;
+	generator->mix_func = NULL;
+	generator->mid_func = NULL;
+	CLEAR_VOICE_GENERATORS(generator);
+
 	switch (waveform_type)
 	{
 		case PROCEDURAL_SINE:
-			generator->output_func = procedural_sine_output;
-			generator->mix_func = procedural_sine_mix_output;
-			generator->mid_func = NULL;
+			SET_GENERATORS(generator, procedural_sine);
 			break;
 
 		case PROCEDURAL_SAW:
-			generator->output_func = procedural_saw_output;
-			generator->mix_func = procedural_saw_mix_output;
-			generator->mid_func = NULL;
+			SET_GENERATORS(generator, procedural_saw_down);
 			break;
 
 		case LFO_PROCEDURAL_SINE:
-			generator->output_func = NULL;
-			generator->mix_func = NULL;
 			generator->mid_func = procedural_sine_mid_output;
 			break;
 
 		case LFO_PROCEDURAL_SAW_DOWN:
-			generator->output_func = NULL;
-			generator->mix_func = NULL;
-			generator->mid_func = procedural_saw_mid_output;
+			generator->mid_func = procedural_saw_down_mid_output;
 			break;
 
 		case LFO_PROCEDURAL_SAW_UP:
-			generator->output_func = NULL;
-			generator->mix_func = NULL;
-			generator->mid_func = procedural_sawup_mid_output;
+			generator->mid_func = procedural_saw_up_mid_output;
 			break;
 
 		case LFO_PROCEDURAL_TRIANGLE:
-			generator->output_func = NULL;
-			generator->mix_func = NULL;
 			generator->mid_func = procedural_triangle_mid_output;
 			break;
 
 		case LFO_PROCEDURAL_SQUARE:
-			generator->output_func = NULL;
-			generator->mix_func = NULL;
 			generator->mid_func = procedural_square_mid_output;
 			break;
 
 		case LFO_PROCEDURAL_HALFSAW_DOWN:
-			generator->output_func = NULL;
-			generator->mix_func = NULL;
-			generator->mid_func = procedural_halfsawdown_mid_output;
+			generator->mid_func = procedural_halfsaw_down_mid_output;
 			break;
 
 		case LFO_PROCEDURAL_HALFSAW_UP:
-			generator->output_func = NULL;
-			generator->mix_func = NULL;
-			generator->mid_func = procedural_halfsawup_mid_output;
+			generator->mid_func = procedural_halfsaw_up_mid_output;
 			break;
 
 		case LFO_PROCEDURAL_HALFSINE:
-			generator->output_func = NULL;
-			generator->mix_func = NULL;
 			generator->mid_func = procedural_halfsine_mid_output;
 			break;
 
 		case LFO_PROCEDURAL_HALFTRIANGLE:
-			generator->output_func = NULL;
-			generator->mix_func = NULL;
 			generator->mid_func = procedural_halftriangle_mid_output;
 			break;
 
@@ -22,23 +22,41 @@
  */
 
 #include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
 #include <limits.h>
 #include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "waveform_wavetable.h"
 #include "system_constants.h"
 #include "fixed_point_math.h"
 #include "oscillator.h"
-
-#define WAVETABLE_SAMPLE_RATE		((float)SYSTEM_SAMPLE_RATE)
-#define WAVETABLE_BASE_FREQUENCY	110.0f
-
+#include "render_pool.h"
+#include "logging.h"
+
+#define WAVETABLE_SIZE_BITS			10
+#define MIPMAP_SIZE_BITS			11
+#define MIPMAP_MAX_LEVELS			10
+
+// Tables are a power of two long, and the phase runs over 32 bits for a cycle, wrapping as it overflows.
+// The top bits of the phase index the table, and the next WT_FRACTION_BITS interpolate it.
+#define WT_FRACTION_BITS			15
+#define WT_FRACTION_MASK			((1 << WT_FRACTION_BITS) - 1)
+
+// Band-limited waveforms have a level per octave of playback pitch. Level n is for stepping through the table at
+// 2^n to 2^(n+1) samples per output sample, and has every partial that stays below Nyquist up to the top of that range.
+// The last level has only the fundamental, and serves all pitches above it. Levels all share the phase, so
+// switching level between buffers is seamless.
 typedef struct
 {
-	int			sample_count;
-	int			frequency;
-	fixed_t		phase_limit;
-	sample_t	*samples;
-	sample_t	*linear_deltas;
+	int			size_bits;
+	int			level_count;
+	sample_t	*samples[MIPMAP_MAX_LEVELS];
+	sample_t	*linear_deltas[MIPMAP_MAX_LEVELS];
+	sample_t	*poly_coeffs[MIPMAP_MAX_LEVELS];
 } waveform_t;
 
 static int wavetable_initialised = 0;
@@ -46,220 +64,626 @@ static waveform_t sine_wave;
 static waveform_t saw_wave;
 static waveform_t saw_wave_bandlimited;
 
-#define WT_CALC_PHASE_STEP(phase_step, osc, waveform) 	fixed_t phase_step = osc->frequency / (fixed_t)waveform->frequency;
+#define WT_CALC_PHASE_STEP(phase_step, osc) 		u_int32_t phase_step = generator_phase_step(osc->frequency)
 
-#define WT_GET_SAMPLE(osc, sample) 		   			int wave_index = fixed_round_to_int(osc->phase_accumulator); \
-													int32_t sample = waveform->samples[wave_index]
+// The phase step's integer part in table samples gives the octave.
+static inline int select_level(waveform_t *waveform, u_int32_t phase_step)
+{
+	int level = 0;
 
-#define WT_LINEAR_INTERP(waveform, osc, sample) 	sample += fixed_mul(waveform->linear_deltas[wave_index], osc->phase_accumulator & FIXED_FRACTION_MASK)
+	for (u_int32_t octave_multiple = phase_step >> (32 - waveform->size_bits); octave_multiple > 1 && level < waveform->level_count - 1; octave_multiple >>= 1)
+	{
+		level++;
+	}
 
-#define WT_ADVANCE_PHASE(osc, waveform, phase_step)	osc->phase_accumulator += phase_step; 					\
-													if (osc->phase_accumulator > waveform->phase_limit) 	\
-														osc->phase_accumulator -= waveform->phase_limit
+	return level;
+}
 
-static void wavetable_output(waveform_generator_def_t *generator, oscillator_t* osc, sample_t *sample_data, int sample_count)
+//-----------------------------------------------------------------------------------------------------------------------
+// Generators, one set per interpolation
+//
+typedef struct
+{
+	waveform_t	*waveform;
+	int			level;
+	int			index_shift;
+	u_int32_t	phase;
+	u_int32_t	phase_step;
+} wavetable_state_t;
+
+static __attribute__((always_inline)) inline int wavetable_begin(wavetable_state_t *state, waveform_generator_def_t *generator, oscillator_t *osc)
 {
 	waveform_t *waveform = (waveform_t*) generator->waveform_data;
 
-	if (waveform != NULL)
+	if (waveform == NULL)
 	{
-		WT_CALC_PHASE_STEP(phase_step, osc, waveform);
-		sample_t *sample_ptr = sample_data;
-		CALC_AMPLITUDE_INTERPOLATION(osc, amp_scale, amp_delta, sample_count);
+		return FALSE;
+	}
 
-		while (sample_count > 0)
-		{
-			WT_GET_SAMPLE(osc, sample);
-			if (generator->flags & GENFLAG_LINEAR_INTERP)
-			{
-				WT_LINEAR_INTERP(waveform, osc, sample);
-			}
-			SCALE_AMPLITUDE((amp_scale >> AMPL_INTERP_PRECISION), sample);
-			STORE_SAMPLE(sample, sample_ptr);
-			WT_ADVANCE_PHASE(osc, waveform, phase_step);
-			INTERPOLATE_AMPLITUDE(amp_scale, amp_delta);
-			sample_count--;
-		}
+	WT_CALC_PHASE_STEP(phase_step, osc);
+	state->waveform = waveform;
+	state->level = select_level(waveform, phase_step);
+	state->index_shift = 32 - waveform->size_bits;
+	state->phase = (u_int32_t)osc->phase_accumulator;
+	state->phase_step = phase_step;
+	return TRUE;
+}
+
+static __attribute__((always_inline)) inline void wavetable_end(wavetable_state_t *state, oscillator_t *osc)
+{
+	osc->phase_accumulator = (fixed_t)state->phase;
+}
+
+static __attribute__((always_inline)) inline int32_t wavetable_nearest_next(wavetable_state_t *state)
+{
+	int32_t sample = state->waveform->samples[state->level][state->phase >> state->index_shift];
+	state->phase += state->phase_step;
+	return sample;
+}
+
+static __attribute__((always_inline)) inline int32_t wavetable_linear_next(wavetable_state_t *state)
+{
+	u_int32_t wave_index = state->phase >> state->index_shift;
+	int32_t fraction = (state->phase >> (state->index_shift - WT_FRACTION_BITS)) & WT_FRACTION_MASK;
+	int32_t sample = state->waveform->samples[state->level][wave_index];
+
+	sample += (state->waveform->linear_deltas[state->level][wave_index] * fraction) >> WT_FRACTION_BITS;
+	state->phase += state->phase_step;
+	return sample;
+}
+
+DEFINE_GENERATORS(wavetable_nearest, wavetable_state_t, wavetable_begin, generator_block_all, wavetable_nearest_next, wavetable_end)
+DEFINE_GENERATORS(wavetable_linear, wavetable_state_t, wavetable_begin, generator_block_all, wavetable_linear_next, wavetable_end)
+
+// Cubic interpolation renders raw samples with the DSP kernels a block at a time, which are then scaled and output.
+// Hermite works from the samples, so needs no more memory than linear interpolation; the optimal polynomial reads
+// precomputed coefficients instead, 8 bytes per sample but all from one place.
+#define WT_KERNEL_BLOCK_SAMPLES		64
+
+typedef struct
+{
+	wavetable_state_t	table;
+	wavetable_kernel_t	kernel;
+	const sample_t		*kernel_data;
+	const sample_t		*block_ptr;
+	sample_t			block[WT_KERNEL_BLOCK_SAMPLES];
+} wavetable_kernel_state_t;
+
+static __attribute__((always_inline)) inline int wavetable_hermite_begin(wavetable_kernel_state_t *state, waveform_generator_def_t *generator, oscillator_t *osc)
+{
+	if (!wavetable_begin(&state->table, generator, osc))
+	{
+		return FALSE;
 	}
+
+	state->kernel = dsp_kernels->wavetable_hermite;
+	state->kernel_data = state->table.waveform->samples[state->table.level];
+	return TRUE;
 }
 
-static void wavetable_mix_output(waveform_generator_def_t *generator, oscillator_t* osc, sample_t *sample_data, int sample_count)
+static __attribute__((always_inline)) inline int wavetable_optimal_begin(wavetable_kernel_state_t *state, waveform_generator_def_t *generator, oscillator_t *osc)
 {
-	waveform_t *waveform = (waveform_t*) generator->waveform_data;
+	if (!wavetable_begin(&state->table, generator, osc))
+	{
+		return FALSE;
+	}
 
-	if (waveform != NULL)
+	state->kernel = dsp_kernels->wavetable_polynomial;
+	state->kernel_data = state->table.waveform->poly_coeffs[state->table.level];
+	return TRUE;
+}
+
+static __attribute__((always_inline)) inline int wavetable_kernel_block(wavetable_kernel_state_t *state, int sample_count)
+{
+	int block_count = sample_count < WT_KERNEL_BLOCK_SAMPLES ? sample_count : WT_KERNEL_BLOCK_SAMPLES;
+
+	state->kernel(state->kernel_data, state->table.waveform->size_bits, state->table.phase, state->table.phase_step, block_count, state->block);
+	state->table.phase += state->table.phase_step * block_count;
+	state->block_ptr = state->block;
+	return block_count;
+}
+
+static __attribute__((always_inline)) inline int32_t wavetable_kernel_next(wavetable_kernel_state_t *state)
+{
+	return *state->block_ptr++;
+}
+
+static __attribute__((always_inline)) inline void wavetable_kernel_end(wavetable_kernel_state_t *state, oscillator_t *osc)
+{
+	wavetable_end(&state->table, osc);
+}
+
+DEFINE_GENERATORS(wavetable_hermite, wavetable_kernel_state_t, wavetable_hermite_begin, wavetable_kernel_block, wavetable_kernel_next, wavetable_kernel_end)
+DEFINE_GENERATORS(wavetable_optimal, wavetable_kernel_state_t, wavetable_optimal_begin, wavetable_kernel_block, wavetable_kernel_next, wavetable_kernel_end)
+
+static void generate_deltas(const sample_t *samples, sample_t *linear_deltas, int size_bits)
+{
+	int sample_count = 1 << size_bits;
+	int i;
+
+	for (i = 0; i < sample_count - 1; i++)
 	{
-		WT_CALC_PHASE_STEP(phase_step, osc, waveform);
-		sample_t *sample_ptr = sample_data;
-		CALC_AMPLITUDE_INTERPOLATION(osc, amp_scale, amp_delta, sample_count);
+		linear_deltas[i] = samples[i + 1] - samples[i];
+	}
+
+	linear_deltas[i] = samples[0] - samples[i];
+}
 
-		while (sample_count > 0)
+static void generate_sine(sample_t *samples, int size_bits, int level)
+{
+	int sample_count = 1 << size_bits;
+	float phase_step = M_PI * 2.0f / sample_count;
+
+	for (int i = 0; i < sample_count; i++)
+	{
+		float phase = i * phase_step;
+		samples[i] = roundf(sinf(phase) * SHRT_MAX);
+	}
+}
+
+static void generate_saw(sample_t *samples, int size_bits, int level)
+{
+	int sample_count = 1 << size_bits;
+	float phase_step = 1.0f / sample_count;
+
+	for (int i = 0; i < sample_count; i++)
+	{
+		float phase = i * phase_step;
+		samples[i] = roundf((1.0f - phase * 2.0f) * SHRT_MAX);
+	}
+}
+
+// In-place radix-2 inverse FFT (unscaled), over separate real and imaginary arrays.
+static void inverse_fft(double *real, double *imag, int size_bits)
+{
+	int size = 1 << size_bits;
+
+	for (int i = 0, j = 0; i < size; i++)
+	{
+		if (i < j)
 		{
-			WT_GET_SAMPLE(osc, sample);
-			if (generator->flags & GENFLAG_LINEAR_INTERP)
+			double temp = real[i];
+			real[i] = real[j];
+			real[j] = temp;
+			temp = imag[i];
+			imag[i] = imag[j];
+			imag[j] = temp;
+		}
+
+		int bit = size >> 1;
+		while (j & bit)
+		{
+			j ^= bit;
+			bit >>= 1;
+		}
+		j |= bit;
+	}
+
+	for (int span = 1; span < size; span <<= 1)
+	{
+		double angle_step = M_PI / span;
+
+		for (int k = 0; k < span; k++)
+		{
+			double twiddle_real = cos(angle_step * k);
+			double twiddle_imag = sin(angle_step * k);
+
+			for (int i = k; i < size; i += span * 2)
 			{
-				WT_LINEAR_INTERP(waveform, osc, sample);
+				int j = i + span;
+				double odd_real = real[j] * twiddle_real - imag[j] * twiddle_imag;
+				double odd_imag = real[j] * twiddle_imag + imag[j] * twiddle_real;
+				real[j] = real[i] - odd_real;
+				imag[j] = imag[i] - odd_imag;
+				real[i] += odd_real;
+				imag[i] += odd_imag;
 			}
-			SCALE_AMPLITUDE((amp_scale >> AMPL_INTERP_PRECISION), sample);
-			MIX((int32_t)*sample_ptr, sample, mixed);
-			STORE_SAMPLE(mixed, sample_ptr);
-			WT_ADVANCE_PHASE(osc, waveform, phase_step);
-			INTERPOLATE_AMPLITUDE(amp_scale, amp_delta);
-			sample_count--;
 		}
 	}
 }
 
-static void generate_deltas(waveform_t *waveform)
+// One level of a band-limited saw, as a Fourier series with its partials tapered to reduce Gibbs ringing.
+// The series is summed by an inverse FFT of the partial levels: with a real spectrum, the imaginary part
+// of the result is the sum of sines.
+// At 2^(n+1) samples per output sample, Nyquist is at partial (table size / 2^(n+2)).
+static void generate_saw_bandlimited(sample_t *samples, int size_bits, int level)
 {
-	int i;
+	int sample_count = 1 << size_bits;
+	int partials = sample_count >> (level + 2);
+	if (partials < 1)
+	{
+		partials = 1;
+	}
 
-	waveform->linear_deltas = malloc(waveform->sample_count * sizeof(waveform->linear_deltas[0]));
+	double *real = calloc(sample_count * 2, sizeof(double));
+	if (real == NULL)
+	{
+		LOG_ERROR("Cannot allocate FFT buffers for a %d sample wavetable", sample_count);
+		exit(EXIT_FAILURE);
+	}
+
+	double *imag = real + sample_count;
+	double gibbs_constant = M_PI / (2 * (double)partials);
+
+	for (int s = 1; s <= partials; s++)
+	{
+		double gibbs = cos((double)(s-1) * gibbs_constant);
+		real[s] = gibbs * gibbs * (1/(double)s);
+	}
+
+	inverse_fft(real, imag, size_bits);
+
+	double sample_max = 0.0;
+	for (int i = 0; i < sample_count; i++)
+	{
+		if (imag[i] > sample_max)
+		{
+			sample_max = imag[i];
+		}
+	}
 
-	for (i = 0; i < waveform->sample_count - 1; i++)
+	double sample_normaliser = SHRT_MAX / sample_max;
+	for (int i = 0; i < sample_count; i++)
 	{
-		waveform->linear_deltas[i] = waveform->samples[i + 1] - waveform->samples[i];
+		samples[i] = lround(imag[i] * sample_normaliser);
 	}
 
-	waveform->linear_deltas[i] = waveform->samples[0] - waveform->samples[i];
+	free(real);
 }
 
-static void generate_sine(waveform_t *waveform, float sample_rate, float frequency)
+// Coefficients of Niemitalo's optimal 4-point, 3rd order interpolator for 2x oversampled input, in z-form
+// (z running from -1/2 to 1/2 over the interval after each sample). Tables with their partials below a quarter
+// of the table's rate are oversampled at least 2x, which the band-limited levels are when played in range.
+void wavetable_generate_poly_coeffs(const sample_t *samples, sample_t *coeffs, int size_bits)
 {
-	static float max_phase = M_PI * 2.0f;
-	float phase_step = max_phase * frequency / sample_rate;
+	int sample_count = 1 << size_bits;
+	int index_mask = sample_count - 1;
 
-	waveform->frequency = frequency;
-	waveform->sample_count = roundf(max_phase / phase_step);
-	waveform->phase_limit = waveform->sample_count << FIXED_PRECISION;
-	waveform->samples = malloc(waveform->sample_count * sizeof(waveform->samples[0]));
+	for (int i = 0; i < sample_count; i++)
+	{
+		double ym1 = samples[(i - 1) & index_mask];
+		double y0 = samples[i];
+		double y1 = samples[(i + 1) & index_mask];
+		double y2 = samples[(i + 2) & index_mask];
 
-	float phase;
+		double even1 = y1 + y0, odd1 = y1 - y0;
+		double even2 = y2 + ym1, odd2 = y2 - ym1;
+		double c[DSP_POLY_COEFFS];
 
-	for (int i = 0; i < waveform->sample_count; i++)
-	{
-		phase = i * phase_step;
-		waveform->samples[i] = roundf(sinf(phase) * SHRT_MAX);
-	}
+		c[0] = even1 * 0.45868970870461956 + even2 * 0.04131401926395584;
+		c[1] = odd1 * 0.48068024766578432 + odd2 * 0.17577925564495955;
+		c[2] = even1 * -0.246185007019907091 + even2 * 0.24614027139700284;
+		c[3] = odd1 * -0.36030925263849456 + odd2 * 0.10174985775982505;
 
-	generate_deltas(waveform);
+		for (int j = 0; j < DSP_POLY_COEFFS; j++)
+		{
+			coeffs[i * DSP_POLY_COEFFS + j] = dsp_saturate_sample(lround(c[j]));
+		}
+	}
 }
 
-static void generate_saw(waveform_t *waveform, float sample_rate, float frequency)
+//-----------------------------------------------------------------------------------------------------------------------
+// Table generation & caching
+//
+// All tables live in one block: for each table and level, its samples then its linear deltas, followed by its
+// polynomial coefficients for tables that have them. Levels are
+// generated as independent jobs spread over a temporary worker pool. The block is then written out after a
+// header describing its layout, so later launches can map the file and point the tables straight into it.
+// Bump WAVETABLE_CACHE_VERSION whenever table contents change without their layout changing.
+//
+#define WAVETABLE_CACHE_MAGIC		"PITHWTC"
+#define WAVETABLE_CACHE_VERSION		2
+
+typedef void (*wavetable_level_generator_t)(sample_t *samples, int size_bits, int level);
+
+typedef struct
+{
+	waveform_t					*waveform;
+	int							size_bits;
+	int							level_count;
+	int							poly_coeffs;
+	wavetable_level_generator_t	generate;
+} wavetable_def_t;
+
+// The band-limited saw's last level, with a single partial, is at level (size bits - 2).
+// The sine has a single partial, so never aliases and needs no more levels. The naive saw is left as one level on
+// purpose: WAVETABLE_SAW and WAVETABLE_SAW_LINEAR are the raw, aliasing saw, and each has a _BL counterpart for a
+// band-limited one, so mip levels for it would only duplicate saw_wave_bandlimited.
+// The naive saw has no polynomial coefficients, as its discontinuity would saturate them.
+static const wavetable_def_t wavetable_defs[] =
 {
-	float phase_step = frequency / sample_rate;
+	{ &sine_wave, 				WAVETABLE_SIZE_BITS,	1,						TRUE,	generate_sine },
+	{ &saw_wave, 				WAVETABLE_SIZE_BITS,	1,						FALSE,	generate_saw },
+	{ &saw_wave_bandlimited, 	MIPMAP_SIZE_BITS,		MIPMAP_SIZE_BITS - 1,	TRUE,	generate_saw_bandlimited },
+};
 
-	waveform->frequency = frequency;
-	waveform->sample_count = roundf(1.0f / phase_step);
-	waveform->phase_limit = waveform->sample_count << FIXED_PRECISION;
-	waveform->samples = malloc(waveform->sample_count * sizeof(waveform->samples[0]));
+#define WAVETABLE_DEF_LEVEL_SAMPLES(def)	((2 + ((def)->poly_coeffs ? DSP_POLY_COEFFS : 0)) << (def)->size_bits)
 
-	for (int i = 0; i < waveform->sample_count; i++)
+#define WAVETABLE_DEF_COUNT			(sizeof(wavetable_defs) / sizeof(wavetable_defs[0]))
+
+typedef struct
+{
+	char		magic[8];
+	u_int32_t	version;
+	u_int32_t	sample_size;
+	u_int32_t	size_bits[WAVETABLE_DEF_COUNT];
+	u_int32_t	level_count[WAVETABLE_DEF_COUNT];
+	u_int32_t	data_size;
+} wavetable_cache_header_t;
+
+typedef struct
+{
+	int			job_count;
+	int			worker_count;
+	struct
 	{
-		float phase = i * phase_step;
-		waveform->samples[i] = roundf((1.0f - phase * 2.0f) * SHRT_MAX);
-	}
+		const wavetable_def_t	*def;
+		int						level;
+	} job[WAVETABLE_DEF_COUNT * MIPMAP_MAX_LEVELS];
+} wavetable_generate_job_t;
+
+static void wavetable_cache_header_init(wavetable_cache_header_t *header)
+{
+	memset(header, 0, sizeof(*header));
+	strncpy(header->magic, WAVETABLE_CACHE_MAGIC, sizeof(header->magic));
+	header->version = WAVETABLE_CACHE_VERSION;
+	header->sample_size = sizeof(sample_t);
 
-	generate_deltas(waveform);
+	for (int i = 0; i < WAVETABLE_DEF_COUNT; i++)
+	{
+		header->size_bits[i] = wavetable_defs[i].size_bits;
+		header->level_count[i] = wavetable_defs[i].level_count;
+		header->data_size += wavetable_defs[i].level_count * WAVETABLE_DEF_LEVEL_SAMPLES(wavetable_defs + i) * sizeof(sample_t);
+	}
 }
 
-static void generate_saw_bandlimited(waveform_t *waveform, float sample_rate, float frequency)
+static void wavetable_layout(sample_t *data)
 {
-	int partials = (WAVETABLE_SAMPLE_RATE / 2) / frequency;
+	for (int i = 0; i < WAVETABLE_DEF_COUNT; i++)
+	{
+		const wavetable_def_t *def = wavetable_defs + i;
+		int sample_count = 1 << def->size_bits;
 
-	waveform->frequency = frequency;
-	waveform->sample_count = roundf(sample_rate / frequency);
-	waveform->phase_limit = waveform->sample_count << FIXED_PRECISION;
-	waveform->samples = malloc(waveform->sample_count * sizeof(waveform->samples[0]));
+		def->waveform->size_bits = def->size_bits;
+		def->waveform->level_count = def->level_count;
 
-	float sample_max = 0.0f;
-	float* sample_buffer = (float*)alloca(waveform->sample_count * sizeof(float));
-	float gibbs_constant = M_PI / (2 * (float)partials);
+		for (int level = 0; level < def->level_count; level++)
+		{
+			def->waveform->samples[level] = data;
+			def->waveform->linear_deltas[level] = data + sample_count;
+			def->waveform->poly_coeffs[level] = def->poly_coeffs ? data + sample_count * 2 : NULL;
+			data += WAVETABLE_DEF_LEVEL_SAMPLES(def);
+		}
+	}
+}
+
+static void wavetable_generate_worker(int worker_index, void *job_data)
+{
+	wavetable_generate_job_t *job = (wavetable_generate_job_t*)job_data;
 
-	for (int i = 0; i < waveform->sample_count; i++)
+	for (int i = worker_index; i < job->job_count; i += job->worker_count)
 	{
-		float sample = 0.0f;
-		float phase = 2.0f * M_PI * (float)i / waveform->sample_count;
+		waveform_t *waveform = job->job[i].def->waveform;
+		int level = job->job[i].level;
 
-		for (int s = 1; s <= partials; s++)
+		job->job[i].def->generate(waveform->samples[level], waveform->size_bits, level);
+		generate_deltas(waveform->samples[level], waveform->linear_deltas[level], waveform->size_bits);
+		if (waveform->poly_coeffs[level] != NULL)
 		{
-			float gibbs = cos((float)(s-1) * gibbs_constant);
-			gibbs *= gibbs;
-			sample += gibbs * (1/(float)s) * sin((float)s * phase);
+			wavetable_generate_poly_coeffs(waveform->samples[level], waveform->poly_coeffs[level], waveform->size_bits);
 		}
+	}
+}
 
-		sample_buffer[i] = sample;
-		if (sample > sample_max)
+static void wavetable_generate(sample_t *data)
+{
+	wavetable_generate_job_t job;
+
+	wavetable_layout(data);
+
+	job.job_count = 0;
+	for (int i = 0; i < WAVETABLE_DEF_COUNT; i++)
+	{
+		for (int level = 0; level < wavetable_defs[i].level_count; level++)
 		{
-			sample_max = sample;
+			job.job[job.job_count].def = wavetable_defs + i;
+			job.job[job.job_count].level = level;
+			job.job_count++;
 		}
 	}
 
-	float sample_normaliser = 1.0f / sample_max;
-	for (int i = 0; i < waveform->sample_count; i++)
+	long core_count = sysconf(_SC_NPROCESSORS_ONLN);
+	render_pool_t pool;
+
+	if (core_count < 1 || render_pool_initialise(&pool, core_count < RENDER_POOL_MAX_WORKERS ? core_count : RENDER_POOL_MAX_WORKERS) != RESULT_OK)
+	{
+		job.worker_count = 1;
+		wavetable_generate_worker(0, &job);
+		return;
+	}
+
+	job.worker_count = pool.worker_count;
+	render_pool_run(&pool, wavetable_generate_worker, &job);
+	render_pool_deinitialise(&pool);
+}
+
+static int wavetable_cache_load(const char *cache_file, const wavetable_cache_header_t *expected_header)
+{
+	int fd = open(cache_file, O_RDONLY);
+	if (fd < 0)
+	{
+		return RESULT_ERROR;
+	}
+
+	struct stat cache_stat;
+	size_t cache_size = sizeof(*expected_header) + expected_header->data_size;
+	void *cache_data = MAP_FAILED;
+
+	if (fstat(fd, &cache_stat) == 0 && cache_stat.st_size == cache_size)
+	{
+		cache_data = mmap(NULL, cache_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	}
+
+	close(fd);
+
+	if (cache_data == MAP_FAILED)
+	{
+		LOG_WARN("Ignoring wavetable cache %s - wrong size or unreadable", cache_file);
+		return RESULT_ERROR;
+	}
+
+	if (memcmp(cache_data, expected_header, sizeof(*expected_header)) != 0)
 	{
-		float sample = sample_buffer[i] * sample_normaliser;
-		waveform->samples[i] = roundf(sample * SHRT_MAX);
+		LOG_WARN("Ignoring wavetable cache %s - from a different version", cache_file);
+		munmap(cache_data, cache_size);
+		return RESULT_ERROR;
 	}
 
-	generate_deltas(waveform);
+	// The mapping is kept for the lifetime of the process, as the tables point into it.
+	wavetable_layout((sample_t*)((char*)cache_data + sizeof(*expected_header)));
+	return RESULT_OK;
 }
 
-void init_wavetables()
+// Written to a temporary file and renamed over the cache, so a concurrent launch never maps a partial file.
+static void wavetable_cache_save(const char *cache_file, const wavetable_cache_header_t *header, const sample_t *data)
+{
+	char temp_file[PATH_MAX];
+	snprintf(temp_file, sizeof(temp_file), "%s.%d", cache_file, getpid());
+
+	FILE *file = fopen(temp_file, "wb");
+	if (file == NULL)
+	{
+		LOG_WARN("Failed to create wavetable cache %s", temp_file);
+		return;
+	}
+
+	int written = fwrite(header, sizeof(*header), 1, file) == 1 && fwrite(data, header->data_size, 1, file) == 1;
+
+	if (fclose(file) != 0 || !written || rename(temp_file, cache_file) != 0)
+	{
+		LOG_WARN("Failed to write wavetable cache %s", cache_file);
+		unlink(temp_file);
+	}
+}
+
+void init_wavetables(const char *cache_file)
 {
 	if (!wavetable_initialised)
 	{
-		generate_sine(&sine_wave, WAVETABLE_SAMPLE_RATE, WAVETABLE_BASE_FREQUENCY);
-		generate_saw(&saw_wave, WAVETABLE_SAMPLE_RATE, WAVETABLE_BASE_FREQUENCY);
-		generate_saw_bandlimited(&saw_wave_bandlimited, WAVETABLE_SAMPLE_RATE, WAVETABLE_BASE_FREQUENCY * 4);
+		wavetable_cache_header_t header;
+		wavetable_cache_header_init(&header);
+
+		if (cache_file == NULL || wavetable_cache_load(cache_file, &header) != RESULT_OK)
+		{
+			sample_t *data = malloc(header.data_size);
+			if (data == NULL)
+			{
+				LOG_ERROR("Cannot allocate %u bytes of wavetables", header.data_size);
+				exit(EXIT_FAILURE);
+			}
+
+			wavetable_generate(data);
+
+			if (cache_file != NULL)
+			{
+				wavetable_cache_save(cache_file, &header, data);
+			}
+		}
+
 		wavetable_initialised = 1;
 	}
 }
 
-void init_wavetable_generator(waveform_type_t waveform_type, waveform_generator_t *generator)
+// The table & interpolation a wavetable waveform type uses, or NULL for other types.
+static waveform_t *wavetable_for_type(waveform_type_t waveform_type, u_int32_t *flags)
 {
-	u_int32_t flags = GENFLAG_NONE;
-	waveform_t *waveform = NULL;
+	*flags = GENFLAG_NONE;
 
 	switch (waveform_type)
 	{
 		case WAVETABLE_SINE_LINEAR:
-			flags = GENFLAG_LINEAR_INTERP;
-			waveform = &sine_wave;
-			break;
+			*flags = GENFLAG_LINEAR_INTERP;
+			return &sine_wave;
 
 		case WAVETABLE_SINE:
-			waveform = &sine_wave;
-			break;
+			return &sine_wave;
 
 		case WAVETABLE_SAW_LINEAR:
-			flags = GENFLAG_LINEAR_INTERP;
-			waveform = &saw_wave;
-			break;
+			*flags = GENFLAG_LINEAR_INTERP;
+			return &saw_wave;
 
 		case WAVETABLE_SAW:
-			waveform = &saw_wave;
-			break;
+			return &saw_wave;
 
 		case WAVETABLE_SAW_LINEAR_BL:
-			flags = GENFLAG_LINEAR_INTERP;
-			waveform = &saw_wave_bandlimited;
-			break;
+			*flags = GENFLAG_LINEAR_INTERP;
+			return &saw_wave_bandlimited;
 
 		case WAVETABLE_SAW_BL:
-			waveform = &saw_wave_bandlimited;
-			break;
+			return &saw_wave_bandlimited;
+
+		case WAVETABLE_SINE_HERMITE:
+			*flags = GENFLAG_HERMITE_INTERP;
+			return &sine_wave;
+
+		case WAVETABLE_SAW_HERMITE_BL:
+			*flags = GENFLAG_HERMITE_INTERP;
+			return &saw_wave_bandlimited;
+
+		case WAVETABLE_SINE_OPTIMAL:
+			*flags = GENFLAG_POLY_INTERP;
+			return &sine_wave;
+
+		case WAVETABLE_SAW_OPTIMAL_BL:
+			*flags = GENFLAG_POLY_INTERP;
+			return &saw_wave_bandlimited;
 
 		default:
-			break;
+			return NULL;
 	}
+}
+
+void init_wavetable_generator(waveform_type_t waveform_type, waveform_generator_t *generator)
+{
+	u_int32_t flags;
+	waveform_t *waveform = wavetable_for_type(waveform_type, &flags);
 
 	if (waveform != NULL)
 	{
 		generator->definition.flags = flags;
 		generator->definition.waveform_data = waveform;
-		generator->output_func = wavetable_output;
-		generator->mix_func = wavetable_mix_output;
 		generator->mid_func = NULL;
+
+		if (flags & GENFLAG_LINEAR_INTERP)
+		{
+			SET_GENERATORS(generator, wavetable_linear);
+		}
+		else if (flags & GENFLAG_HERMITE_INTERP)
+		{
+			SET_GENERATORS(generator, wavetable_hermite);
+		}
+		else if (flags & GENFLAG_POLY_INTERP)
+		{
+			SET_GENERATORS(generator, wavetable_optimal);
+		}
+		else
+		{
+			SET_GENERATORS(generator, wavetable_nearest);
+		}
+	}
+}
+
+const sample_t *wavetable_select(waveform_type_t waveform_type, fixed_t frequency, int *size_bits, u_int32_t *phase_step)
+{
+	u_int32_t flags;
+	waveform_t *waveform = wavetable_for_type(waveform_type, &flags);
+
+	if (waveform == NULL)
+	{
+		return NULL;
 	}
+
+	*size_bits = waveform->size_bits;
+	*phase_step = generator_phase_step(frequency);
+	return waveform->samples[select_level(waveform, *phase_step)];
 }
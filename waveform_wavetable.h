@@ -27,7 +27,12 @@
 #include "waveform.h"
 #include "waveform_internal.h"
 
-extern void init_wavetables();
+extern void init_wavetables(const char *cache_file);
 extern void init_wavetable_generator(waveform_type_t waveform_type, waveform_generator_t *generator);
+extern void wavetable_generate_poly_coeffs(const sample_t *samples, sample_t *coeffs, int size_bits);
+
+// The samples of a wavetable waveform at the level that plays the frequency without aliasing, with the table size
+// and the phase step for the frequency. Returns NULL if the waveform isn't table based.
+extern const sample_t *wavetable_select(waveform_type_t waveform_type, fixed_t frequency, int *size_bits, u_int32_t *phase_step);
 
 #endif /* WAVEFORM_WAVETABLE_H_ */